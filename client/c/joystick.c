@@ -2,6 +2,7 @@
 #include <SDL2/SDL.h>
 #include "rc-car.h"
 #include "joystick.h"
+#include "json-arena.h"
 
 static SDL_Joystick *joystick = NULL;
 static SDL_GameController *controller = NULL;
@@ -44,12 +45,18 @@ void startJoystickLoop(int *isRunning, struct lws *webSocketInstance) {
 
     while (*isRunning) {
         while (SDL_PollEvent(&e)) {
+            const size_t arenaMark = beginJsonArenaScope();
             rcCar->processJoystickEvents(rcCar, &e);
+            endJsonArenaScope(arenaMark);
 
             if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_q) {
                 break;
             }
         }
+
+        const size_t arenaMark = beginJsonArenaScope();
+        rcCar->refreshThrottle(rcCar);
+        endJsonArenaScope(arenaMark);
     }
 }
 
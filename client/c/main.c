@@ -3,6 +3,7 @@
 #include <stdlib.h>
 #include "libs/env/dotenv.h"
 #include "joystick.h"
+#include "json-arena.h"
 #include "websocket.h"
 
 int isRunning = 1;
@@ -15,6 +16,7 @@ void handleSignal(const int signal) {
             isRunning = 0;
             closeJoystick();
             closeWebSocketServer();
+            reportJsonArenaStats("Client");
             exit(0);
         default:
             break;
@@ -37,6 +39,7 @@ void *webSocketThread(void *arg) {
 
 int main() {
     env_load(".env", false);
+    installJsonArena(JSON_ARENA_DEFAULT_SIZE);
 
     if (initJoystick() != 0) {
         return -1;
@@ -1,6 +1,8 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
+#include <string.h>
+#include <time.h>
 #include <SDL2/SDL.h>
 #include <cjson/cJSON.h>
 #include "rc-car.h"
@@ -13,6 +15,15 @@ struct lws *webSocketInstance = NULL;
 bool isSteeringCalibrationOn = false;
 
 JoystickState *joystickState = NULL;
+const char *lastThrottleAction = NULL;
+int lastThrottleSpeed = 0;
+long lastThrottleSentAtMs = 0;
+
+long getMonotonicMs() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000L + now.tv_nsec / 1000000L;
+}
 
 void initializeJoystickState() {
     joystickState = malloc(sizeof(JoystickState));
@@ -35,8 +46,12 @@ void cleanupJoystickState() {
 
 char* prepareActionPayload(cJSON *data) {
     struct CommonActionPayload actionPayload;
+    char sentAt[32];
     actionPayload.to = "rc-car-server";
 
+    snprintf(sentAt, sizeof(sentAt), "%ld", getMonotonicMs());
+    cJSON_AddStringToObject(data, "sentAt", sentAt);
+
     cJSON *base = cJSON_CreateObject();
 
     cJSON_AddStringToObject(base, "to", actionPayload.to);
@@ -86,9 +101,10 @@ void changDegreeOfTurns(RcCar *self) {
     cJSON_AddStringToObject(data, "action", "change-degree-of-turns");
     cJSON_AddStringToObject(data, "degrees", resetTurnsActionPayloadData.degreeOfTurns);
 
-    const char *payload = prepareActionPayload(data);
+    char *payload = prepareActionPayload(data);
 
     sendWebSocketEvent(payload, webSocketInstance);
+    cJSON_free(payload);
     free(axisXDegreesAsString);
 }
 
@@ -104,9 +120,10 @@ void resetTurns(RcCar *self) {
     cJSON_AddStringToObject(data, "action", "reset-turns");
     cJSON_AddStringToObject(data, "degrees", resetTurnsActionPayloadData.degreeOfTurns);
 
-    const char *payload = prepareActionPayload(data);
+    char *payload = prepareActionPayload(data);
 
     sendWebSocketEvent(payload, webSocketInstance);
+    cJSON_free(payload);
     free(axisXDegreesAsString);
 }
 
@@ -123,13 +140,18 @@ void turnCar(const float *degrees) {
     cJSON_AddStringToObject(data, "action", "turn-to");
     cJSON_AddStringToObject(data, "degrees", turnToActionPayload.degrees);
 
-    const char *payload = prepareActionPayload(data);
+    char *payload = prepareActionPayload(data);
 
     sendWebSocketEvent(payload, webSocketInstance);
+    cJSON_free(payload);
     free(axisXDegreesAsString);
 }
 
 void forward(RcCar *self, const int *speed) {
+    lastThrottleAction = "forward";
+    lastThrottleSpeed = *speed;
+    lastThrottleSentAtMs = getMonotonicMs();
+
     int speedValue = prepareSpeedBaseOnSelectedTransmissionSpeed(self, speed);
     int len = snprintf(NULL, 0, "%d", speedValue);
     char *speedAsString = malloc(len + 1);
@@ -142,13 +164,18 @@ void forward(RcCar *self, const int *speed) {
     cJSON_AddStringToObject(data, "action", "forward");
     cJSON_AddStringToObject(data, "speed", forwardBackwardActionPayloadData.carSpeed);
 
-    const char *payload = prepareActionPayload(data);
+    char *payload = prepareActionPayload(data);
 
     sendWebSocketEvent(payload, webSocketInstance);
+    cJSON_free(payload);
     free(speedAsString);
 }
 
 void backward(const int *speed) {
+    lastThrottleAction = "backward";
+    lastThrottleSpeed = *speed;
+    lastThrottleSentAtMs = getMonotonicMs();
+
     int speedValue = *speed;
     int len = snprintf(NULL, 0, "%d", speedValue);
     char *speedAsString = malloc(len + 1);
@@ -161,37 +188,57 @@ void backward(const int *speed) {
     cJSON_AddStringToObject(data, "action", "backward");
     cJSON_AddStringToObject(data, "speed", forwardBackwardActionPayloadData.carSpeed);
 
-    const char *payload = prepareActionPayload(data);
+    char *payload = prepareActionPayload(data);
 
     sendWebSocketEvent(payload, webSocketInstance);
+    cJSON_free(payload);
     free(speedAsString);
 }
 
 void setEscToNeutralPosition() {
+    lastThrottleAction = NULL;
+
     cJSON *data = cJSON_CreateObject();
     cJSON_AddStringToObject(data, "action", "set-esc-to-neutral-position");
 
-    const char *payload = prepareActionPayload(data);
+    char *payload = prepareActionPayload(data);
 
     sendWebSocketEvent(payload, webSocketInstance);
+    cJSON_free(payload);
+}
+
+void refreshThrottle(RcCar *self) {
+    if (lastThrottleAction == NULL || getMonotonicMs() - lastThrottleSentAtMs < THROTTLE_REFRESH_MS) {
+        return;
+    }
+
+    const int speed = lastThrottleSpeed;
+
+    if (strcmp(lastThrottleAction, "forward") == 0) {
+        forward(self, &speed);
+    } else {
+        backward(&speed);
+    }
 }
 
 void startCamera() {
     cJSON *data = cJSON_CreateObject();
     cJSON_AddStringToObject(data, "action", "start-camera");
 
-    const char *payload = prepareActionPayload(data);
+    char *payload = prepareActionPayload(data);
 
     sendWebSocketEvent(payload, webSocketInstance);
+    cJSON_free(payload);
 }
 
 void stopCamera() {
     cJSON *data = cJSON_CreateObject();
     cJSON_AddStringToObject(data, "action", "stop-camera");
 
-    const char *payload = prepareActionPayload(data);
+    char *payload = prepareActionPayload(data);
 
     sendWebSocketEvent(payload, webSocketInstance);
+    cJSON_free(payload);
 }
 
 void cameraGimbalTurn(const float *degrees) {
@@ -207,9 +254,10 @@ void cameraGimbalTurn(const float *degrees) {
     cJSON_AddStringToObject(data, "action", "camera-gimbal-turn-to");
     cJSON_AddStringToObject(data, "degrees", turnToActionPayload.degrees);
 
-    const char *payload = prepareActionPayload(data);
+    char *payload = prepareActionPayload(data);
 
     sendWebSocketEvent(payload, webSocketInstance);
+    cJSON_free(payload);
     free(axisXDegreesAsString);
 }
 
@@ -225,9 +273,10 @@ void cameraGimbalSetPitchAngle(RcCar *self) {
     cJSON_AddStringToObject(data, "action", "camera-gimbal-set-pitch-angle");
     cJSON_AddStringToObject(data, "degrees", cameraGimbalSetPitchAngleActionPayloadData.degrees);
 
-    const char *payload = prepareActionPayload(data);
+    char *payload = prepareActionPayload(data);
 
     sendWebSocketEvent(payload, webSocketInstance);
+    cJSON_free(payload);
     free(axisXDegreesAsString);
 }
 
@@ -235,27 +284,30 @@ void resetCameraGimbal() {
     cJSON *data = cJSON_CreateObject();
     cJSON_AddStringToObject(data, "action", "reset-camera-gimbal");
 
-    const char *payload = prepareActionPayload(data);
+    char *payload = prepareActionPayload(data);
 
     sendWebSocketEvent(payload, webSocketInstance);
+    cJSON_free(payload);
 }
 
 void startSteeringCalibration() {
     cJSON *data = cJSON_CreateObject();
     cJSON_AddStringToObject(data, "action", "steering-calibration-on");
 
-    const char *payload = prepareActionPayload(data);
+    char *payload = prepareActionPayload(data);
 
     sendWebSocketEvent(payload, webSocketInstance);
+    cJSON_free(payload);
 }
 
 void stopSteeringCalibration() {
     cJSON *data = cJSON_CreateObject();
     cJSON_AddStringToObject(data, "action", "steering-calibration-off");
 
-    const char *payload = prepareActionPayload(data);
+    char *payload = prepareActionPayload(data);
 
     sendWebSocketEvent(payload, webSocketInstance);
+    cJSON_free(payload);
 }
 
 void init(RcCar *self) {
@@ -271,9 +323,10 @@ void init(RcCar *self) {
     cJSON_AddStringToObject(data, "action", "init");
     cJSON_AddStringToObject(data, "speed", speedAsString);
     cJSON_AddStringToObject(data, "degrees", axisXDegreesAsString);
-    const char *payload = prepareActionPayload(data);
+    char *payload = prepareActionPayload(data);
 
     sendWebSocketEvent(payload, webSocketInstance);
+    cJSON_free(payload);
     free(speedAsString);
     free(axisXDegreesAsString);
 }
@@ -460,5 +513,6 @@ RcCar *newRcCar() {
     rcCar->setControllerInstance = setControllerInstance;
     rcCar->processJoystickEvents = processJoystickEvents;
     rcCar->onCloseJoystick = onCloseJoystick;
+    rcCar->refreshThrottle = refreshThrottle;
     return rcCar;
 }
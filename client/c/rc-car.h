@@ -13,6 +13,7 @@
 #define SIXTH_TRANSMISSION_SPEED 6
 #define SEVENTH_TRANSMISSION_SPEED 7
 #define EIGHTH_TRANSMISSION_SPEED 8
+#define THROTTLE_REFRESH_MS 100
 
 
 struct CommonActionPayload {
@@ -67,6 +68,7 @@ typedef struct RcCar {
     void (*setControllerInstance)(SDL_GameController *controllerInstance);
     void (*setWebSocketInstance)(struct lws *webSocketInstance);
     void (*onCloseJoystick)();
+    void (*refreshThrottle)(struct RcCar *self);
 } RcCar;
 RcCar *newRcCar();
 #endif
@@ -0,0 +1,630 @@
+#define _GNU_SOURCE
+#include <arpa/inet.h>
+#include <cjson/cJSON.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <libgen.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include "../rc-car.h"
+#include "../websocket.h"
+#include "scripted-controller.h"
+#include "state-bus.h"
+
+#define LOOP_BENCHMARK_SERVER_PORT 8585
+#define LOOP_BENCHMARK_STATE_BUS_NAME "/rc-car-loop-benchmark"
+#define LOOP_BENCHMARK_STARTUP_TIMEOUT_MS 5000
+#define LOOP_BENCHMARK_RESPONSE_TIMEOUT_MS 500
+#define LOOP_BENCHMARK_BURST_TIMEOUT_MS 10000
+#define LOOP_BENCHMARK_POLL_INTERVAL_NS 20000L
+#define LOOP_BENCHMARK_MAX_EVENTS 100000
+#define LOOP_BENCHMARK_DEFAULT_EVENTS 1000
+#define LOOP_BENCHMARK_DEFAULT_PERIOD_MS 20
+#define LOOP_BENCHMARK_DEFAULT_BURST 1000
+#define LOOP_BENCHMARK_LINE_SIZE 128
+#define LOOP_BENCHMARK_PROCESS_COUNT 3
+
+typedef struct {
+    long atMs;
+    int axis;
+    Sint16 value;
+} TraceEvent;
+
+typedef struct {
+    const char *name;
+    pid_t pid;
+    long cpuTicksAtStart;
+    long cpuTicksAtEnd;
+} BenchmarkProcess;
+
+typedef struct {
+    const char *serverPath;
+    const char *carPath;
+    const char *tracePath;
+    const char *outputPath;
+    const char *logDir;
+    int eventCount;
+    int periodMs;
+    int burstSize;
+} BenchmarkOptions;
+
+typedef struct {
+    int answered;
+    double traceSeconds;
+    bool isBurstComplete;
+    double burstSeconds;
+    double wallSeconds;
+} BenchmarkResult;
+
+typedef struct {
+    int steeringPulseWidth;
+    int escPulseWidth;
+    long updatedAtNs;
+} ActuatorSnapshot;
+
+static TraceEvent traceEvents[LOOP_BENCHMARK_MAX_EVENTS];
+static long latenciesNs[LOOP_BENCHMARK_MAX_EVENTS];
+static struct lws_context *benchmarkContext = NULL;
+static pthread_t serviceThread;
+static bool isServiceThreadRunning = false;
+static volatile int isServicing = 1;
+
+static long nowNs() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000000L + now.tv_nsec;
+}
+
+static void sleepNs(long ns) {
+    struct timespec duration = {ns / 1000000000L, ns % 1000000000L};
+    nanosleep(&duration, NULL);
+}
+
+static void sleepUntilNs(long deadlineNs) {
+    struct timespec deadline = {deadlineNs / 1000000000L, deadlineNs % 1000000000L};
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL);
+}
+
+static int loadTrace(const char *path, int defaultCount, int defaultPeriodMs) {
+    char line[LOOP_BENCHMARK_LINE_SIZE];
+    char axisName[32];
+    int value;
+    int count = 0;
+
+    if (path == NULL) {
+        for (int i = 0; i < defaultCount && i < LOOP_BENCHMARK_MAX_EVENTS; i++) {
+            traceEvents[i].atMs = (long)i * defaultPeriodMs;
+            traceEvents[i].axis = SDL_CONTROLLER_AXIS_LEFTX;
+            traceEvents[i].value = (Sint16)((i % 2 == 0 ? -1 : 1) * (6000 + (i * 7919) % 26000));
+            count++;
+        }
+        return count;
+    }
+
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        fprintf(stderr, "Failed to open trace %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    while (count < LOOP_BENCHMARK_MAX_EVENTS && fgets(line, sizeof(line), file) != NULL) {
+        TraceEvent *event = &traceEvents[count];
+
+        if (line[0] == '#' || sscanf(line, "%ld %31s %d", &event->atMs, axisName, &value) != 3) {
+            continue;
+        }
+
+        event->axis = getScriptedAxisByName(axisName);
+        if (event->axis < 0) {
+            fprintf(stderr, "Unknown axis %s in trace\n", axisName);
+            continue;
+        }
+
+        event->value = (Sint16)(value > 32767 ? 32767 : (value < -32768 ? -32768 : value));
+        count++;
+    }
+
+    fclose(file);
+
+    return count;
+}
+
+static pid_t spawnProcess(const char *path, const char *logDir, const char *name) {
+    const pid_t pid = fork();
+
+    if (pid != 0) {
+        return pid;
+    }
+
+    char logPath[512];
+    char *directory = strdup(path);
+    int logFd;
+
+    if (logDir != NULL) {
+        snprintf(logPath, sizeof(logPath), "%s/%s.log", logDir, name);
+        logFd = open(logPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    } else {
+        logFd = open("/dev/null", O_WRONLY);
+    }
+
+    if (logFd >= 0) {
+        dup2(logFd, STDOUT_FILENO);
+        dup2(logFd, STDERR_FILENO);
+        close(logFd);
+    }
+
+    if (chdir(dirname(directory)) != 0) {
+        _exit(127);
+    }
+
+    execl(path, path, (char *)NULL);
+    _exit(127);
+}
+
+static void stopProcess(pid_t pid, int signal) {
+    int status;
+
+    if (pid <= 0) {
+        return;
+    }
+
+    kill(pid, signal);
+
+    for (int i = 0; i < 200; i++) {
+        if (waitpid(pid, &status, WNOHANG) == pid) {
+            return;
+        }
+        sleepNs(10000000L);
+    }
+
+    kill(pid, SIGKILL);
+    waitpid(pid, &status, 0);
+}
+
+static bool waitForPort(int port, int timeoutMs) {
+    const long deadlineNs = nowNs() + timeoutMs * 1000000L;
+    struct sockaddr_in address;
+
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons((uint16_t)port);
+
+    while (nowNs() < deadlineNs) {
+        const int fd = socket(AF_INET, SOCK_STREAM, 0);
+        const int result = connect(fd, (struct sockaddr *)&address, sizeof(address));
+
+        close(fd);
+        if (result == 0) {
+            return true;
+        }
+
+        sleepNs(20000000L);
+    }
+
+    return false;
+}
+
+static bool waitForStateBus(StateBusReader *reader, int timeoutMs) {
+    const long deadlineNs = nowNs() + timeoutMs * 1000000L;
+
+    while (nowNs() < deadlineNs) {
+        if (openStateBusReader(reader, LOOP_BENCHMARK_STATE_BUS_NAME) == 0) {
+            return true;
+        }
+
+        sleepNs(20000000L);
+    }
+
+    return false;
+}
+
+static void readActuators(const StateBusReader *reader, ActuatorSnapshot *snapshot) {
+    CarState state;
+
+    if (readStateBus(reader, &state, NULL)) {
+        snapshot->steeringPulseWidth = state.steeringPulseWidth;
+        snapshot->escPulseWidth = state.escPulseWidth;
+        snapshot->updatedAtNs = (long)state.updatedAtNs;
+    }
+}
+
+static bool waitForActuatorChange(const StateBusReader *reader, const ActuatorSnapshot *before, long deadlineNs, ActuatorSnapshot *after) {
+    *after = *before;
+
+    while (nowNs() < deadlineNs) {
+        readActuators(reader, after);
+
+        if (after->steeringPulseWidth != before->steeringPulseWidth || after->escPulseWidth != before->escPulseWidth) {
+            return true;
+        }
+
+        sleepNs(LOOP_BENCHMARK_POLL_INTERVAL_NS);
+    }
+
+    return false;
+}
+
+static bool waitForSteering(const StateBusReader *reader, int pulseWidth, long deadlineNs, ActuatorSnapshot *after) {
+    while (nowNs() < deadlineNs) {
+        readActuators(reader, after);
+
+        if (after->steeringPulseWidth == pulseWidth) {
+            return true;
+        }
+
+        sleepNs(LOOP_BENCHMARK_POLL_INTERVAL_NS);
+    }
+
+    return false;
+}
+
+static long readCpuTicks(pid_t pid) {
+    char path[64];
+    char buffer[1024];
+    unsigned long userTicks = 0;
+    unsigned long systemTicks = 0;
+
+    snprintf(path, sizeof(path), "/proc/%d/stat", (int)pid);
+
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return -1;
+    }
+
+    const size_t length = fread(buffer, 1, sizeof(buffer) - 1, file);
+    fclose(file);
+    buffer[length] = '\0';
+
+    const char *fields = strrchr(buffer, ')');
+    if (fields == NULL || sscanf(fields + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu", &userTicks, &systemTicks) != 2) {
+        return -1;
+    }
+
+    return (long)(userTicks + systemTicks);
+}
+
+static long readMemoryKb(pid_t pid, const char *key) {
+    char path[64];
+    char line[256];
+    long value = -1;
+
+    snprintf(path, sizeof(path), "/proc/%d/status", (int)pid);
+
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return -1;
+    }
+
+    while (fgets(line, sizeof(line), file) != NULL) {
+        if (strncmp(line, key, strlen(key)) == 0) {
+            value = strtol(line + strlen(key), NULL, 10);
+            break;
+        }
+    }
+
+    fclose(file);
+
+    return value;
+}
+
+static int compareLatencies(const void *a, const void *b) {
+    const long left = *(const long *)a;
+    const long right = *(const long *)b;
+    return left < right ? -1 : (left > right ? 1 : 0);
+}
+
+static double percentileUs(const long *sorted, int count, double percentile) {
+    if (count == 0) {
+        return 0.0;
+    }
+
+    int index = (int)(percentile / 100.0 * (count - 1) + 0.5);
+    return sorted[index] / 1000.0;
+}
+
+static void *serviceWebSocket(void *arg) {
+    while (isServicing) {
+        lws_service(benchmarkContext, 10);
+    }
+
+    return NULL;
+}
+
+static bool warmUp(RcCar *rcCar, const StateBusReader *reader) {
+    const long deadlineNs = nowNs() + LOOP_BENCHMARK_STARTUP_TIMEOUT_MS * 1000000L;
+    ActuatorSnapshot before = {0, 0, 0};
+    ActuatorSnapshot after;
+    Sint16 value = 20000;
+
+    injectScriptedAxis(rcCar, SDL_CONTROLLER_AXIS_LEFTX, value);
+
+    while (nowNs() < deadlineNs) {
+        readActuators(reader, &before);
+        value = (Sint16)-value;
+        injectScriptedAxis(rcCar, SDL_CONTROLLER_AXIS_LEFTX, value);
+
+        if (waitForActuatorChange(reader, &before, nowNs() + 50000000L, &after)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void addProcessReport(cJSON *processes, const BenchmarkProcess *process, double wallSeconds) {
+    const long ticksPerSecond = sysconf(_SC_CLK_TCK);
+    const double cpuSeconds = (double)(process->cpuTicksAtEnd - process->cpuTicksAtStart) / ticksPerSecond;
+    cJSON *report = cJSON_CreateObject();
+
+    cJSON_AddNumberToObject(report, "pid", process->pid);
+    cJSON_AddNumberToObject(report, "cpuSeconds", cpuSeconds);
+    cJSON_AddNumberToObject(report, "cpuPercent", wallSeconds > 0.0 ? cpuSeconds * 100.0 / wallSeconds : 0.0);
+    cJSON_AddNumberToObject(report, "rssKb", readMemoryKb(process->pid, "VmRSS:"));
+    cJSON_AddNumberToObject(report, "peakRssKb", readMemoryKb(process->pid, "VmHWM:"));
+    cJSON_AddItemToObject(processes, process->name, report);
+}
+
+static const char *startPipeline(const BenchmarkOptions *options, BenchmarkProcess *processes, StateBusReader *reader, RcCar **rcCar) {
+    processes[0].pid = spawnProcess(options->serverPath, options->logDir, processes[0].name);
+    if (!waitForPort(LOOP_BENCHMARK_SERVER_PORT, LOOP_BENCHMARK_STARTUP_TIMEOUT_MS)) {
+        return "websocketserver did not start listening";
+    }
+
+    processes[1].pid = spawnProcess(options->carPath, options->logDir, processes[1].name);
+    if (!waitForStateBus(reader, LOOP_BENCHMARK_STARTUP_TIMEOUT_MS)) {
+        return "raspberrypiclient did not open the state bus";
+    }
+
+    processes[2].pid = getpid();
+
+    const WebSocketConnection connection = connectToWebSocketServer();
+    if (connection.context == NULL) {
+        return "controller failed to connect";
+    }
+
+    benchmarkContext = connection.context;
+    *rcCar = newRcCar();
+    (*rcCar)->setControllerInstance(NULL);
+    (*rcCar)->setWebSocketInstance(connection.wsi);
+
+    isServiceThreadRunning = pthread_create(&serviceThread, NULL, serviceWebSocket, NULL) == 0;
+    if (!isServiceThreadRunning) {
+        return "failed to start the websocket service thread";
+    }
+
+    if (!warmUp(*rcCar, reader)) {
+        return "car never reacted to the controller";
+    }
+
+    return NULL;
+}
+
+static void stopPipeline(BenchmarkProcess *processes, StateBusReader *reader) {
+    if (isServiceThreadRunning) {
+        isServicing = 0;
+        pthread_join(serviceThread, NULL);
+        isServiceThreadRunning = false;
+    }
+
+    if (benchmarkContext != NULL) {
+        closeWebSocketServer();
+        benchmarkContext = NULL;
+    }
+
+    stopProcess(processes[1].pid, SIGINT);
+    stopProcess(processes[0].pid, SIGINT);
+    closeStateBusReader(reader);
+}
+
+static void measureTrace(RcCar *rcCar, const StateBusReader *reader, int traceCount, BenchmarkResult *result) {
+    const long startedAtNs = nowNs();
+
+    for (int i = 0; i < traceCount; i++) {
+        const TraceEvent *event = &traceEvents[i];
+        const long nextEventAtNs = i + 1 < traceCount ? startedAtNs + traceEvents[i + 1].atMs * 1000000L : 0;
+        ActuatorSnapshot before = {0, 0, 0};
+        ActuatorSnapshot after;
+
+        sleepUntilNs(startedAtNs + event->atMs * 1000000L);
+        readActuators(reader, &before);
+
+        const long injectedAtNs = nowNs();
+        injectScriptedAxis(rcCar, event->axis, event->value);
+
+        long deadlineNs = injectedAtNs + LOOP_BENCHMARK_RESPONSE_TIMEOUT_MS * 1000000L;
+        if (nextEventAtNs > 0 && nextEventAtNs < deadlineNs) {
+            deadlineNs = nextEventAtNs;
+        }
+
+        if (waitForActuatorChange(reader, &before, deadlineNs, &after)) {
+            latenciesNs[result->answered++] = after.updatedAtNs - injectedAtNs;
+        }
+    }
+
+    result->traceSeconds = (nowNs() - startedAtNs) / 1e9;
+}
+
+static void measureBurst(RcCar *rcCar, const StateBusReader *reader, int burstSize, BenchmarkResult *result) {
+    ActuatorSnapshot before = {0, 0, 0};
+    ActuatorSnapshot target;
+    ActuatorSnapshot after;
+
+    injectScriptedAxis(rcCar, SDL_CONTROLLER_AXIS_LEFTX, -32000);
+    sleepNs(LOOP_BENCHMARK_RESPONSE_TIMEOUT_MS * 1000000L);
+    readActuators(reader, &before);
+    injectScriptedAxis(rcCar, SDL_CONTROLLER_AXIS_LEFTX, 32000);
+
+    if (!waitForActuatorChange(reader, &before, nowNs() + LOOP_BENCHMARK_RESPONSE_TIMEOUT_MS * 1000000L, &target)) {
+        return;
+    }
+
+    injectScriptedAxis(rcCar, SDL_CONTROLLER_AXIS_LEFTX, -32000);
+    sleepNs(LOOP_BENCHMARK_RESPONSE_TIMEOUT_MS * 1000000L);
+
+    const long startedAtNs = nowNs();
+    for (int i = 0; i < burstSize; i++) {
+        injectScriptedAxis(rcCar, SDL_CONTROLLER_AXIS_LEFTX, (Sint16)(i % 2 == 0 ? -16000 : -32000));
+    }
+    injectScriptedAxis(rcCar, SDL_CONTROLLER_AXIS_LEFTX, 32000);
+
+    result->isBurstComplete = waitForSteering(reader, target.steeringPulseWidth, startedAtNs + LOOP_BENCHMARK_BURST_TIMEOUT_MS * 1000000L, &after);
+    if (result->isBurstComplete) {
+        result->burstSeconds = (after.updatedAtNs - startedAtNs) / 1e9;
+    }
+}
+
+static void writeReport(FILE *output, const BenchmarkOptions *options, int traceCount, const BenchmarkResult *result, const BenchmarkProcess *processes) {
+    cJSON *report = cJSON_CreateObject();
+    cJSON *latency = cJSON_CreateObject();
+    cJSON *throughput = cJSON_CreateObject();
+    cJSON *processReports = cJSON_CreateObject();
+    const int answered = result->answered;
+    double sumUs = 0.0;
+
+    qsort(latenciesNs, answered, sizeof(long), compareLatencies);
+    for (int i = 0; i < answered; i++) {
+        sumUs += latenciesNs[i] / 1000.0;
+    }
+
+    cJSON_AddStringToObject(report, "benchmark", "loop");
+    cJSON_AddStringToObject(report, "trace", options->tracePath != NULL ? options->tracePath : "builtin-steering-sweep");
+    cJSON_AddNumberToObject(report, "events", traceCount);
+    cJSON_AddNumberToObject(report, "answered", answered);
+    cJSON_AddNumberToObject(report, "traceSeconds", result->traceSeconds);
+
+    cJSON_AddNumberToObject(latency, "minUs", answered > 0 ? latenciesNs[0] / 1000.0 : 0.0);
+    cJSON_AddNumberToObject(latency, "meanUs", answered > 0 ? sumUs / answered : 0.0);
+    cJSON_AddNumberToObject(latency, "p50Us", percentileUs(latenciesNs, answered, 50.0));
+    cJSON_AddNumberToObject(latency, "p90Us", percentileUs(latenciesNs, answered, 90.0));
+    cJSON_AddNumberToObject(latency, "p99Us", percentileUs(latenciesNs, answered, 99.0));
+    cJSON_AddNumberToObject(latency, "maxUs", answered > 0 ? latenciesNs[answered - 1] / 1000.0 : 0.0);
+    cJSON_AddItemToObject(report, "inputToPulseLatency", latency);
+
+    cJSON_AddNumberToObject(throughput, "commands", options->burstSize + 1);
+    cJSON_AddBoolToObject(throughput, "completed", result->isBurstComplete);
+    cJSON_AddNumberToObject(throughput, "seconds", result->burstSeconds);
+    cJSON_AddNumberToObject(throughput, "commandsPerSecond", result->burstSeconds > 0.0 ? (options->burstSize + 1) / result->burstSeconds : 0.0);
+    cJSON_AddItemToObject(report, "throughput", throughput);
+
+    for (int i = 0; i < LOOP_BENCHMARK_PROCESS_COUNT; i++) {
+        addProcessReport(processReports, &processes[i], result->wallSeconds);
+    }
+    cJSON_AddItemToObject(report, "processes", processReports);
+
+    char *json = cJSON_Print(report);
+    fprintf(output, "%s\n", json);
+    free(json);
+    cJSON_Delete(report);
+}
+
+static void printUsage(const char *program) {
+    fprintf(
+        stderr,
+        "Usage: %s --server path/to/websocketserver --car path/to/raspberrypiclient\n"
+        "          [--trace file] [--events n] [--period-ms ms] [--burst n] [--output report.json] [--log-dir dir]\n",
+        program
+    );
+}
+
+int main(int argc, char **argv) {
+    BenchmarkOptions options = {
+        NULL, NULL, NULL, NULL, NULL,
+        LOOP_BENCHMARK_DEFAULT_EVENTS,
+        LOOP_BENCHMARK_DEFAULT_PERIOD_MS,
+        LOOP_BENCHMARK_DEFAULT_BURST
+    };
+    BenchmarkProcess processes[LOOP_BENCHMARK_PROCESS_COUNT] = {
+        {"websocketserver", -1, 0, 0},
+        {"raspberrypiclient", -1, 0, 0},
+        {"controller", -1, 0, 0}
+    };
+    BenchmarkResult result = {0, 0.0, false, 0.0, 0.0};
+    StateBusReader reader = {NULL};
+    RcCar *rcCar = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--server") == 0 && i + 1 < argc) {
+            options.serverPath = argv[++i];
+        } else if (strcmp(argv[i], "--car") == 0 && i + 1 < argc) {
+            options.carPath = argv[++i];
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            options.tracePath = argv[++i];
+        } else if (strcmp(argv[i], "--events") == 0 && i + 1 < argc) {
+            options.eventCount = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--period-ms") == 0 && i + 1 < argc) {
+            options.periodMs = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--burst") == 0 && i + 1 < argc) {
+            options.burstSize = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            options.outputPath = argv[++i];
+        } else if (strcmp(argv[i], "--log-dir") == 0 && i + 1 < argc) {
+            options.logDir = argv[++i];
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (options.serverPath == NULL || options.carPath == NULL || options.eventCount <= 0 || options.periodMs <= 0) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    const int traceCount = loadTrace(options.tracePath, options.eventCount, options.periodMs);
+    if (traceCount <= 0) {
+        fprintf(stderr, "Trace is empty\n");
+        return 1;
+    }
+
+    setenv("RASPBERRY_PI_IP", "127.0.0.1", 1);
+    setenv("STATE_BUS_NAME", LOOP_BENCHMARK_STATE_BUS_NAME, 1);
+
+    fflush(stdout);
+    const int reportFd = dup(STDOUT_FILENO);
+    if (reportFd < 0 || freopen("/dev/null", "w", stdout) == NULL) {
+        return 1;
+    }
+
+    const char *error = startPipeline(&options, processes, &reader, &rcCar);
+
+    if (error != NULL) {
+        stopPipeline(processes, &reader);
+        dprintf(reportFd, "{\"benchmark\":\"loop\",\"error\":\"%s\"}\n", error);
+        return 1;
+    }
+
+    for (int i = 0; i < LOOP_BENCHMARK_PROCESS_COUNT; i++) {
+        processes[i].cpuTicksAtStart = readCpuTicks(processes[i].pid);
+    }
+
+    const long startedAtNs = nowNs();
+    measureTrace(rcCar, &reader, traceCount, &result);
+    if (options.burstSize > 0) {
+        measureBurst(rcCar, &reader, options.burstSize, &result);
+    }
+    result.wallSeconds = (nowNs() - startedAtNs) / 1e9;
+
+    for (int i = 0; i < LOOP_BENCHMARK_PROCESS_COUNT; i++) {
+        processes[i].cpuTicksAtEnd = readCpuTicks(processes[i].pid);
+    }
+
+    FILE *output = options.outputPath != NULL ? fopen(options.outputPath, "w") : fdopen(reportFd, "w");
+    if (output != NULL) {
+        writeReport(output, &options, traceCount, &result, processes);
+        fclose(output);
+    }
+
+    stopPipeline(processes, &reader);
+
+    return output != NULL ? 0 : 1;
+}
@@ -0,0 +1,277 @@
+#include <cjson/cJSON.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../rc-car.h"
+#include "../utils/joystick.util.h"
+#include "car-command.h"
+#include "json-arena.h"
+#include "relay.h"
+#include "scripted-controller.h"
+
+#define MICRO_BENCHMARK_INPUT_COUNT 1024
+#define MICRO_BENCHMARK_CALIBRATION_NS 20000000L
+#define MICRO_BENCHMARK_DEFAULT_TARGET_MS 200
+#define MICRO_BENCHMARK_MAX_ITERATIONS 100000000L
+#define MICRO_BENCHMARK_CAR_DESTINATION "rc-car-server"
+
+typedef void (*MicroBenchmarkFunction)(long iteration);
+
+typedef struct {
+    const char *name;
+    MicroBenchmarkFunction function;
+} MicroBenchmark;
+
+typedef struct {
+    long allocations;
+    long bytes;
+} AllocationCounters;
+
+void turnCar(const float *degrees);
+void forward(RcCar *self, const int *speed);
+
+static Sint16 axisInputs[MICRO_BENCHMARK_INPUT_COUNT];
+static const char *turnMessage =
+    "{\"to\":\"rc-car-server\",\"data\":{\"action\":\"turn-to\",\"degrees\":\"72.340000\",\"sentAt\":\"183204117\"}}";
+static RcCar *benchmarkRcCar = NULL;
+static AllocationCounters allocationCounters = {0, 0};
+static bool isCountingAllocations = false;
+static bool isJsonArenaEnabled = false;
+static volatile long sink = 0;
+
+#ifdef __GLIBC__
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *pointer, size_t size);
+extern void __libc_free(void *pointer);
+
+static void countAllocation(size_t size) {
+    if (isCountingAllocations) {
+        allocationCounters.allocations++;
+        allocationCounters.bytes += (long)size;
+    }
+}
+
+void *malloc(size_t size) {
+    countAllocation(size);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) {
+    countAllocation(count * size);
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *pointer, size_t size) {
+    countAllocation(size);
+    return __libc_realloc(pointer, size);
+}
+
+void free(void *pointer) {
+    __libc_free(pointer);
+}
+
+static const char *allocationCounting = "malloc";
+#else
+static void *countingMalloc(size_t size) {
+    if (isCountingAllocations) {
+        allocationCounters.allocations++;
+        allocationCounters.bytes += (long)size;
+    }
+
+    return malloc(size);
+}
+
+static const char *allocationCounting = "cjson-hooks";
+#endif
+
+void sendWebSocketEvent(const char *message, struct lws *webSocketInstance) {
+    sink += (long)strlen(message);
+}
+
+static void onRelayDelivery(const char *message) {
+    sink += message[0];
+}
+
+static long nowNs() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000000L + now.tv_nsec;
+}
+
+static void benchmarkLinearConversion(long iteration) {
+    const Sint16 value = axisInputs[iteration % MICRO_BENCHMARK_INPUT_COUNT];
+    sink += getLinearConversion(abs(value), JOYSTICK_DEADZONE, JOYSTICK_MAX_AXIS_VALUE, JOYSTICK_DEADZONE, JOYSTICK_MAX_AXIS_VALUE);
+}
+
+static void benchmarkMapStickToDegrees(long iteration) {
+    const Sint16 value = axisInputs[iteration % MICRO_BENCHMARK_INPUT_COUNT];
+    sink += (long)mapStickToDegrees(value, 0.0f, 90.0f, 0.01f);
+}
+
+static void benchmarkButtonValueToSpeed(long iteration) {
+    setScriptedAxis(SDL_CONTROLLER_AXIS_TRIGGERRIGHT, (Sint16)abs(axisInputs[iteration % MICRO_BENCHMARK_INPUT_COUNT]));
+    sink += buttonValueToSpeed(NULL, SDL_CONTROLLER_AXIS_TRIGGERRIGHT);
+}
+
+static void benchmarkLeftAnalogStick(long iteration) {
+    setScriptedAxis(SDL_CONTROLLER_AXIS_LEFTX, axisInputs[iteration % MICRO_BENCHMARK_INPUT_COUNT]);
+    setScriptedAxis(SDL_CONTROLLER_AXIS_LEFTY, axisInputs[(iteration + 7) % MICRO_BENCHMARK_INPUT_COUNT]);
+    sink += calculateLeftAnalogStickValues(NULL).x;
+}
+
+static void benchmarkRightAnalogStick(long iteration) {
+    setScriptedAxis(SDL_CONTROLLER_AXIS_RIGHTX, axisInputs[iteration % MICRO_BENCHMARK_INPUT_COUNT]);
+    setScriptedAxis(SDL_CONTROLLER_AXIS_RIGHTY, axisInputs[(iteration + 7) % MICRO_BENCHMARK_INPUT_COUNT]);
+    sink += calculateRightAnalogStickValues(NULL).x;
+}
+
+static void benchmarkEncodeTurn(long iteration) {
+    const float degrees = mapStickToDegrees(axisInputs[iteration % MICRO_BENCHMARK_INPUT_COUNT], 0.0f, 90.0f, 0.01f);
+    turnCar(&degrees);
+}
+
+static void benchmarkEncodeForward(long iteration) {
+    const int speed = (int)(iteration % 100);
+    forward(benchmarkRcCar, &speed);
+}
+
+static void benchmarkRelayRoute(long iteration) {
+    sink += routeRelayMessage(NULL, turnMessage, strlen(turnMessage));
+}
+
+static void benchmarkCarDecode(long iteration) {
+    CarCommand command;
+
+    if (decodeCarCommand(turnMessage, &command)) {
+        sink += command.action + (long)command.value;
+    }
+    releaseCarCommand(&command);
+}
+
+static const MicroBenchmark benchmarks[] = {
+    {"getLinearConversion", benchmarkLinearConversion},
+    {"mapStickToDegrees", benchmarkMapStickToDegrees},
+    {"buttonValueToSpeed", benchmarkButtonValueToSpeed},
+    {"calculateLeftAnalogStickValues", benchmarkLeftAnalogStick},
+    {"calculateRightAnalogStickValues", benchmarkRightAnalogStick},
+    {"encodeTurnCommand", benchmarkEncodeTurn},
+    {"encodeForwardCommand", benchmarkEncodeForward},
+    {"relayRouteMessage", benchmarkRelayRoute},
+    {"carDecodeCommand", benchmarkCarDecode}
+};
+
+static long runIterations(MicroBenchmarkFunction function, long iterations) {
+    const long startedAtNs = nowNs();
+
+    if (isJsonArenaEnabled) {
+        for (long i = 0; i < iterations; i++) {
+            const size_t arenaMark = beginJsonArenaScope();
+            function(i);
+            endJsonArenaScope(arenaMark);
+        }
+    } else {
+        for (long i = 0; i < iterations; i++) {
+            function(i);
+        }
+    }
+
+    return nowNs() - startedAtNs;
+}
+
+static cJSON *runBenchmark(const MicroBenchmark *benchmark, long targetNs) {
+    long iterations = 1;
+    long elapsedNs = runIterations(benchmark->function, iterations);
+
+    while (elapsedNs < MICRO_BENCHMARK_CALIBRATION_NS && iterations < MICRO_BENCHMARK_MAX_ITERATIONS) {
+        iterations *= 2;
+        elapsedNs = runIterations(benchmark->function, iterations);
+    }
+
+    iterations = elapsedNs > 0 ? (long)((double)iterations * targetNs / elapsedNs) : MICRO_BENCHMARK_MAX_ITERATIONS;
+    if (iterations < 1) {
+        iterations = 1;
+    }
+    if (iterations > MICRO_BENCHMARK_MAX_ITERATIONS) {
+        iterations = MICRO_BENCHMARK_MAX_ITERATIONS;
+    }
+
+    allocationCounters.allocations = 0;
+    allocationCounters.bytes = 0;
+    isCountingAllocations = true;
+    elapsedNs = runIterations(benchmark->function, iterations);
+    isCountingAllocations = false;
+
+    cJSON *result = cJSON_CreateObject();
+    cJSON_AddStringToObject(result, "name", benchmark->name);
+    cJSON_AddNumberToObject(result, "iterations", (double)iterations);
+    cJSON_AddNumberToObject(result, "nsPerOp", (double)elapsedNs / iterations);
+    cJSON_AddNumberToObject(result, "allocsPerOp", (double)allocationCounters.allocations / iterations);
+    cJSON_AddNumberToObject(result, "bytesPerOp", (double)allocationCounters.bytes / iterations);
+
+    return result;
+}
+
+int main(int argc, char **argv) {
+    long targetMs = MICRO_BENCHMARK_DEFAULT_TARGET_MS;
+    const char *filter = NULL;
+    unsigned int seed = 1;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--target-ms") == 0 && i + 1 < argc) {
+            targetMs = atol(argv[++i]);
+        } else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (strcmp(argv[i], "--json-arena") == 0) {
+            isJsonArenaEnabled = true;
+        } else {
+            fprintf(stderr, "Usage: %s [--target-ms ms] [--filter name-substring] [--json-arena]\n", argv[0]);
+            return 1;
+        }
+    }
+
+#ifndef __GLIBC__
+    cJSON_Hooks hooks = {countingMalloc, free};
+    cJSON_InitHooks(&hooks);
+#endif
+
+    if (isJsonArenaEnabled) {
+        installJsonArena(JSON_ARENA_DEFAULT_SIZE);
+    }
+
+    for (int i = 0; i < MICRO_BENCHMARK_INPUT_COUNT; i++) {
+        axisInputs[i] = (Sint16)((int)(rand_r(&seed) % 65535) - 32767);
+    }
+
+    benchmarkRcCar = newRcCar();
+    benchmarkRcCar->setControllerInstance(NULL);
+    registerRelayLocalDestination(MICRO_BENCHMARK_CAR_DESTINATION, onRelayDelivery);
+
+    cJSON *report = cJSON_CreateObject();
+    cJSON *results = cJSON_CreateArray();
+
+    cJSON_AddStringToObject(report, "benchmark", "micro");
+    cJSON_AddStringToObject(report, "allocationCounting", allocationCounting);
+    cJSON_AddNumberToObject(report, "targetMs", (double)targetMs);
+    cJSON_AddBoolToObject(report, "jsonArena", isJsonArenaEnabled);
+
+    for (size_t i = 0; i < sizeof(benchmarks) / sizeof(benchmarks[0]); i++) {
+        if (filter == NULL || strstr(benchmarks[i].name, filter) != NULL) {
+            cJSON_AddItemToArray(results, runBenchmark(&benchmarks[i], targetMs * 1000000L));
+        }
+    }
+
+    cJSON_AddItemToObject(report, "results", results);
+
+    char *json = cJSON_Print(report);
+    printf("%s\n", json);
+
+    cJSON_free(json);
+    cJSON_Delete(report);
+    benchmarkRcCar->onCloseJoystick();
+    free(benchmarkRcCar);
+
+    return 0;
+}
@@ -0,0 +1,59 @@
+#include <string.h>
+#include "scripted-controller.h"
+
+static Sint16 scriptedAxes[SDL_CONTROLLER_AXIS_MAX];
+
+static const struct {
+    const char *name;
+    SDL_GameControllerAxis axis;
+} scriptedAxisNames[] = {
+    {"leftx", SDL_CONTROLLER_AXIS_LEFTX},
+    {"lefty", SDL_CONTROLLER_AXIS_LEFTY},
+    {"rightx", SDL_CONTROLLER_AXIS_RIGHTX},
+    {"righty", SDL_CONTROLLER_AXIS_RIGHTY},
+    {"triggerleft", SDL_CONTROLLER_AXIS_TRIGGERLEFT},
+    {"triggerright", SDL_CONTROLLER_AXIS_TRIGGERRIGHT}
+};
+
+Sint16 SDL_GameControllerGetAxis(SDL_GameController *gamecontroller, SDL_GameControllerAxis axis) {
+    return axis >= 0 && axis < SDL_CONTROLLER_AXIS_MAX ? scriptedAxes[axis] : 0;
+}
+
+int getScriptedAxisByName(const char *name) {
+    for (size_t i = 0; i < sizeof(scriptedAxisNames) / sizeof(scriptedAxisNames[0]); i++) {
+        if (strcmp(scriptedAxisNames[i].name, name) == 0) {
+            return scriptedAxisNames[i].axis;
+        }
+    }
+
+    return -1;
+}
+
+void setScriptedAxis(SDL_GameControllerAxis axis, Sint16 value) {
+    if (axis >= 0 && axis < SDL_CONTROLLER_AXIS_MAX) {
+        scriptedAxes[axis] = value;
+    }
+}
+
+void injectScriptedAxis(RcCar *rcCar, SDL_GameControllerAxis axis, Sint16 value) {
+    SDL_Event event;
+
+    setScriptedAxis(axis, value);
+
+    memset(&event, 0, sizeof(event));
+    event.type = SDL_CONTROLLERAXISMOTION;
+    event.caxis.axis = (Uint8)axis;
+    event.caxis.value = value;
+
+    rcCar->processJoystickEvents(rcCar, &event);
+}
+
+void injectScriptedButton(RcCar *rcCar, SDL_GameControllerButton button) {
+    SDL_Event event;
+
+    memset(&event, 0, sizeof(event));
+    event.type = SDL_CONTROLLERBUTTONDOWN;
+    event.cbutton.button = (Uint8)button;
+
+    rcCar->processJoystickEvents(rcCar, &event);
+}
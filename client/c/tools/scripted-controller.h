@@ -0,0 +1,11 @@
+#ifndef SCRIPTED_CONTROLLER_H
+#define SCRIPTED_CONTROLLER_H
+
+#include <SDL2/SDL.h>
+#include "../rc-car.h"
+
+int getScriptedAxisByName(const char *name);
+void setScriptedAxis(SDL_GameControllerAxis axis, Sint16 value);
+void injectScriptedAxis(RcCar *rcCar, SDL_GameControllerAxis axis, Sint16 value);
+void injectScriptedButton(RcCar *rcCar, SDL_GameControllerButton button);
+#endif
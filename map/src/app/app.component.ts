@@ -45,6 +45,11 @@ export class AppComponent implements OnInit {
 			(event) => {
 				const payload = JSON.parse(event.data);
 
+				if (payload.type === 'telemetry') {
+					this._applyTelemetry(payload);
+					return;
+				}
+
 				if (payload.latitude && payload.longitude && payload.speed) {
 					this._setCarMarker([payload.longitude, payload.latitude])
 					this.speed.update(() => parseInt(payload.speed, 10));
@@ -52,6 +57,21 @@ export class AppComponent implements OnInit {
 			});
 	}
 
+	private _applyTelemetry(payload: { lat: number; lon: number; s: number[][] }): void {
+		const sample = payload.s[payload.s.length - 1];
+
+		if (!sample || sample[4] < 2) {
+			return;
+		}
+
+		const hasEstimate = sample.length > 16 && sample[16] > 0;
+		const latitude = (payload.lat + (hasEstimate ? sample[13] : sample[1])) / 1e7;
+		const longitude = (payload.lon + (hasEstimate ? sample[14] : sample[2])) / 1e7;
+
+		this._setCarMarker([longitude, latitude]);
+		this.speed.update(() => Math.round(sample[3] / 100));
+	}
+
 	public onMapCreate(map: Map) {
 		this._map = map;
 	}
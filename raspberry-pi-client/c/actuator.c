@@ -0,0 +1,149 @@
+#include <pigpio.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "actuator.h"
+#include "flight-recorder.h"
+#include "rc-car.h"
+#include "servo-wave.h"
+#include "state-bus.h"
+#include "telemetry.h"
+
+static const int servoWavePins[] = {
+    CAR_TURNS_SERVO_PIN,
+    CAR_ESC_PIN,
+    CAR_CAMERA_GIMBAL_PIN1,
+    CAR_CAMERA_GIMBAL_PIN3,
+    CAR_CAMERA_GIMBAL_PIN4
+};
+
+static ServoWave servoWave;
+static pthread_mutex_t servoWaveMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_t servoWaveThreadHandle;
+static bool isServoWaveActive = false;
+static atomic_bool isServoWaveThreadRunning = false;
+
+static void writeServo(int pin, int pulseWidth) {
+    pthread_mutex_lock(&servoWaveMutex);
+    const bool isWaveChannel = isServoWaveActive && setServoWavePulseWidth(&servoWave, pin, pulseWidth);
+    pthread_mutex_unlock(&servoWaveMutex);
+
+    if (!isWaveChannel) {
+        gpioServo(pin, pulseWidth);
+    }
+}
+
+void commitServo(int pin, int pulseWidth) {
+    writeServo(pin, pulseWidth);
+    recordFlightActuator(pin, pulseWidth);
+    updateStateBusActuator(pin, pulseWidth);
+
+    switch (pin) {
+        case CAR_TURNS_SERVO_PIN:
+            updateTelemetryActuator(TELEMETRY_STEERING, pulseWidth);
+            break;
+        case CAR_ESC_PIN:
+            updateTelemetryActuator(TELEMETRY_ESC, pulseWidth);
+            break;
+        case CAR_CAMERA_GIMBAL_PIN4:
+            updateTelemetryActuator(TELEMETRY_GIMBAL_YAW, pulseWidth);
+            break;
+        case CAR_CAMERA_GIMBAL_PIN3:
+            updateTelemetryActuator(TELEMETRY_GIMBAL_PITCH, pulseWidth);
+            break;
+        default:
+            break;
+    }
+}
+
+static void *servoWaveThread(void *arg) {
+    const long periodNs = SERVO_WAVE_FRAME_US * 1000L;
+    bool hasReportedFailure = false;
+    struct timespec nextTick;
+
+    clock_gettime(CLOCK_MONOTONIC, &nextTick);
+
+    while (atomic_load_explicit(&isServoWaveThreadRunning, memory_order_relaxed)) {
+        pthread_mutex_lock(&servoWaveMutex);
+        const int result = commitServoWave(&servoWave);
+        pthread_mutex_unlock(&servoWaveMutex);
+
+        if (result < 0 && !hasReportedFailure) {
+            printf("[Actuator] Failed to commit servo waveform: %d\n", result);
+            hasReportedFailure = true;
+        }
+
+        nextTick.tv_nsec += periodNs;
+        while (nextTick.tv_nsec >= 1000000000L) {
+            nextTick.tv_nsec -= 1000000000L;
+            nextTick.tv_sec++;
+        }
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &nextTick, NULL);
+    }
+
+    return NULL;
+}
+
+int startActuatorBackend() {
+    const char *backend = getenv("ACTUATOR_BACKEND");
+    const int pinCount = (int)(sizeof(servoWavePins) / sizeof(servoWavePins[0]));
+
+    if (backend == NULL || strcmp(backend, "wave") != 0) {
+        return -1;
+    }
+
+    pthread_mutex_lock(&servoWaveMutex);
+    initServoWave(&servoWave);
+    for (int i = 0; i < pinCount; i++) {
+        const int pulseWidth = gpioGetServoPulsewidth(servoWavePins[i]);
+        addServoWaveChannel(&servoWave, servoWavePins[i], pulseWidth > 0 ? pulseWidth : 0);
+    }
+
+    const int result = commitServoWave(&servoWave);
+    if (result < 0) {
+        pthread_mutex_unlock(&servoWaveMutex);
+        printf("[Actuator] Failed to create servo waveform: %d, using per-pin servo pulses\n", result);
+        return -1;
+    }
+
+    for (int i = 0; i < pinCount; i++) {
+        gpioServo(servoWavePins[i], 0);
+    }
+    isServoWaveActive = true;
+    pthread_mutex_unlock(&servoWaveMutex);
+
+    atomic_store(&isServoWaveThreadRunning, true);
+
+    if (pthread_create(&servoWaveThreadHandle, NULL, servoWaveThread, NULL) != 0) {
+        printf("[Actuator] Failed to create waveform thread\n");
+        atomic_store(&isServoWaveThreadRunning, false);
+        stopActuatorBackend();
+        return -1;
+    }
+
+    printf("[Actuator] Committing %d servos as one waveform per %d us frame\n", pinCount, SERVO_WAVE_FRAME_US);
+
+    return 0;
+}
+
+void stopActuatorBackend() {
+    if (atomic_exchange(&isServoWaveThreadRunning, false)) {
+        pthread_join(servoWaveThreadHandle, NULL);
+    }
+
+    pthread_mutex_lock(&servoWaveMutex);
+    if (isServoWaveActive) {
+        const ServoWave lastWave = servoWave;
+
+        releaseServoWave(&servoWave);
+
+        for (int i = 0; i < lastWave.count; i++) {
+            gpioServo(lastWave.pins[i], lastWave.pulseWidths[i]);
+        }
+        isServoWaveActive = false;
+    }
+    pthread_mutex_unlock(&servoWaveMutex);
+}
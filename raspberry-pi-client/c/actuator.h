@@ -0,0 +1,7 @@
+#ifndef ACTUATOR_H
+#define ACTUATOR_H
+
+void commitServo(int pin, int pulseWidth);
+int startActuatorBackend();
+void stopActuatorBackend();
+#endif
@@ -0,0 +1,453 @@
+#include <arpa/inet.h>
+#include <cjson/cJSON.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include "camera.h"
+
+extern char **environ;
+
+typedef struct {
+    const char *name;
+    pid_t pid;
+    long startedAtMs;
+    long restartAtMs;
+    long backoffMs;
+} SupervisedProcess;
+
+static SupervisedProcess mediaMtxProcess = {"MediaMTX", -1, 0, 0, CAMERA_RESTART_MIN_BACKOFF_MS};
+static SupervisedProcess publisherProcess = {"Publisher", -1, 0, 0, CAMERA_RESTART_MIN_BACKOFF_MS};
+
+static pthread_t cameraSupervisorThreadHandle;
+static atomic_bool isCameraSupervisorRunning = false;
+static atomic_bool isPublishingRequested = false;
+static atomic_bool isPublisherPaused = false;
+static atomic_bool isPublisherWarm = false;
+static atomic_long timeToFirstFrameMs = -1;
+static bool isPublishingApplied = false;
+static long publisherPausedAtMs = -1;
+static long firstFrameRequestedAtMs = -1;
+static double firstFrameBytesReceived = -1;
+
+static long nowMs() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000L + now.tv_nsec / 1000000L;
+}
+
+static const char *getCameraPath() {
+    const char *path = getenv("CAMERA_PATH");
+    return path != NULL && path[0] != '\0' ? path : CAMERA_DEFAULT_PATH;
+}
+
+static int getCameraApiPort() {
+    const char *port = getenv("MEDIAMTX_API_PORT");
+    return port != NULL && port[0] != '\0' ? atoi(port) : CAMERA_DEFAULT_API_PORT;
+}
+
+static void restoreChildSignalMask() {
+    sigset_t empty;
+
+    sigemptyset(&empty);
+    sigprocmask(SIG_SETMASK, &empty, NULL);
+}
+
+static bool resolveExecutablePath(const char *name, char *path, size_t pathSize) {
+    const char *searchPath = getenv("PATH");
+    char directories[1024];
+    char *savePointer = NULL;
+
+    if (strchr(name, '/') != NULL) {
+        snprintf(path, pathSize, "%s", name);
+        return access(path, X_OK) == 0;
+    }
+
+    snprintf(directories, sizeof(directories), "%s", searchPath != NULL ? searchPath : "/usr/local/bin:/usr/bin:/bin");
+
+    for (char *directory = strtok_r(directories, ":", &savePointer); directory != NULL; directory = strtok_r(NULL, ":", &savePointer)) {
+        snprintf(path, pathSize, "%s/%s", directory, name);
+        if (access(path, X_OK) == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static char **buildChildEnvironment(char *const *overrides, int overrideCount) {
+    int count = 0;
+    int childCount = 0;
+
+    while (environ[count] != NULL) {
+        count++;
+    }
+
+    char **environment = calloc((size_t)(count + overrideCount + 1), sizeof(char *));
+    if (environment == NULL) {
+        return NULL;
+    }
+
+    for (int i = 0; i < count; i++) {
+        bool isOverridden = false;
+
+        for (int j = 0; j < overrideCount && !isOverridden; j++) {
+            const size_t nameLength = (size_t)(strchr(overrides[j], '=') - overrides[j]) + 1;
+            isOverridden = strncmp(environ[i], overrides[j], nameLength) == 0;
+        }
+
+        if (!isOverridden) {
+            environment[childCount++] = environ[i];
+        }
+    }
+
+    for (int j = 0; j < overrideCount; j++) {
+        environment[childCount++] = overrides[j];
+    }
+
+    return environment;
+}
+
+static pid_t spawnSupervisedChild(const char *path, char *const *arguments, char *const *environment) {
+    static const char execFailed[] = "[Camera] execve failed\n";
+    const pid_t pid = fork();
+
+    if (pid == 0) {
+        setpgid(0, 0);
+        restoreChildSignalMask();
+        execve(path, arguments, environment);
+        write(STDERR_FILENO, execFailed, sizeof(execFailed) - 1);
+        _exit(EXIT_FAILURE);
+    }
+
+    if (pid < 0) {
+        perror("[Camera] fork");
+    }
+
+    return pid;
+}
+
+static const char *getCameraReadTimeout() {
+    const char *timeout = getenv("CAMERA_READ_TIMEOUT");
+    return timeout != NULL && timeout[0] != '\0' ? timeout : CAMERA_DEFAULT_READ_TIMEOUT;
+}
+
+static pid_t spawnMediaMtx() {
+    const char *binary = getenv("MEDIAMTX_BIN_PATH");
+    char binaryPath[512];
+    char pathRunOnInit[160];
+    char apiAddress[64];
+    char readTimeout[64];
+    char *overrides[] = {"MTX_API=yes", apiAddress, pathRunOnInit, readTimeout};
+
+    if (binary == NULL || !resolveExecutablePath(binary, binaryPath, sizeof(binaryPath))) {
+        printf("[MediaMTX] Cannot find executable %s\n", binary != NULL ? binary : "");
+        return -1;
+    }
+
+    snprintf(pathRunOnInit, sizeof(pathRunOnInit), "MTX_PATHS_%s_RUNONINIT=", getCameraPath());
+    for (char *c = pathRunOnInit; *c; c++) {
+        if (*c >= 'a' && *c <= 'z') {
+            *c = (char)(*c - 'a' + 'A');
+        }
+    }
+    snprintf(apiAddress, sizeof(apiAddress), "MTX_APIADDRESS=127.0.0.1:%d", getCameraApiPort());
+    snprintf(readTimeout, sizeof(readTimeout), "MTX_READTIMEOUT=%s", getCameraReadTimeout());
+
+    char *arguments[] = {"mediamtx", getenv("MEDIAMTX_CONFIG_PATH"), NULL};
+    char **environment = buildChildEnvironment(overrides, (int)(sizeof(overrides) / sizeof(overrides[0])));
+
+    if (environment == NULL) {
+        return -1;
+    }
+
+    const pid_t pid = spawnSupervisedChild(binaryPath, arguments, environment);
+    free(environment);
+
+    return pid;
+}
+
+static pid_t spawnPublisher() {
+    const char *command = getenv("CAMERA_PIPELINE_COMMAND");
+
+    if (command == NULL || command[0] == '\0') {
+        command = CAMERA_DEFAULT_PIPELINE_COMMAND;
+    }
+
+    char *arguments[] = {"sh", "-c", (char *)command, NULL};
+
+    return spawnSupervisedChild("/bin/sh", arguments, environ);
+}
+
+static void startSupervisedProcess(SupervisedProcess *process, pid_t (*spawn)()) {
+    process->pid = spawn();
+
+    if (process->pid < 0) {
+        printf("[Camera] Failed to start %s, retrying in %ld ms\n", process->name, process->backoffMs);
+        process->restartAtMs = nowMs() + process->backoffMs;
+        return;
+    }
+
+    process->startedAtMs = nowMs();
+    printf("[Camera] %s started with PID %d\n", process->name, process->pid);
+}
+
+static void terminateSupervisedProcess(SupervisedProcess *process) {
+    if (process->pid <= 0) {
+        return;
+    }
+
+    kill(-process->pid, SIGCONT);
+    kill(-process->pid, SIGTERM);
+
+    const long deadline = nowMs() + CAMERA_STOP_TIMEOUT_MS;
+    while (waitpid(process->pid, NULL, WNOHANG) == 0) {
+        if (nowMs() > deadline) {
+            kill(-process->pid, SIGKILL);
+            waitpid(process->pid, NULL, 0);
+            break;
+        }
+        usleep(10000);
+    }
+
+    printf("[Camera] %s (PID %d) stopped\n", process->name, process->pid);
+    process->pid = -1;
+}
+
+static bool reapSupervisedProcess(SupervisedProcess *process) {
+    int status;
+
+    if (process->pid <= 0 || waitpid(process->pid, &status, WNOHANG) != process->pid) {
+        return false;
+    }
+
+    const long uptimeMs = nowMs() - process->startedAtMs;
+
+    if (uptimeMs >= CAMERA_RESTART_STABLE_UPTIME_MS) {
+        process->backoffMs = CAMERA_RESTART_MIN_BACKOFF_MS;
+    }
+
+    printf(
+        "[Camera] %s (PID %d) exited with status %d after %ld ms, restarting in %ld ms\n",
+        process->name,
+        process->pid,
+        WIFEXITED(status) ? WEXITSTATUS(status) : -WTERMSIG(status),
+        uptimeMs,
+        process->backoffMs
+    );
+
+    process->pid = -1;
+    process->restartAtMs = nowMs() + process->backoffMs;
+    process->backoffMs *= 2;
+    if (process->backoffMs > CAMERA_RESTART_MAX_BACKOFF_MS) {
+        process->backoffMs = CAMERA_RESTART_MAX_BACKOFF_MS;
+    }
+
+    return true;
+}
+
+static bool fetchCameraPathStats(bool *isReady, double *bytesReceived) {
+    const int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in address;
+    struct timeval timeout = {0, CAMERA_SUPERVISOR_TICK_US};
+    char request[256];
+    char response[4096];
+    size_t responseLength = 0;
+    ssize_t received;
+    bool isParsed = false;
+
+    if (fd < 0) {
+        return false;
+    }
+
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(getCameraApiPort());
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    const int requestLength = snprintf(request, sizeof(request), "GET /v3/paths/get/%s HTTP/1.0\r\nHost: localhost\r\n\r\n", getCameraPath());
+
+    if (connect(fd, (struct sockaddr *)&address, sizeof(address)) != 0 || send(fd, request, requestLength, 0) != requestLength) {
+        close(fd);
+        return false;
+    }
+
+    while (responseLength < sizeof(response) - 1
+        && (received = recv(fd, response + responseLength, sizeof(response) - 1 - responseLength, 0)) > 0) {
+        responseLength += (size_t)received;
+    }
+    response[responseLength] = '\0';
+    close(fd);
+
+    const char *body = strstr(response, "\r\n\r\n");
+    if (body == NULL) {
+        return false;
+    }
+
+    cJSON *json = cJSON_Parse(body + 4);
+    const cJSON *ready = cJSON_GetObjectItem(json, "ready");
+    const cJSON *bytes = cJSON_GetObjectItem(json, "bytesReceived");
+
+    if (ready != NULL && cJSON_IsNumber(bytes)) {
+        *isReady = cJSON_IsTrue(ready);
+        *bytesReceived = bytes->valuedouble;
+        isParsed = true;
+    }
+
+    cJSON_Delete(json);
+
+    return isParsed;
+}
+
+static void pausePublisher(bool isPaused) {
+    if (publisherProcess.pid <= 0 || isPublisherPaused == isPaused) {
+        return;
+    }
+
+    kill(-publisherProcess.pid, isPaused ? SIGSTOP : SIGCONT);
+    isPublisherPaused = isPaused;
+    publisherPausedAtMs = isPaused ? nowMs() : -1;
+
+    if (isPaused) {
+        firstFrameBytesReceived = -1;
+    }
+}
+
+static void trackFirstFrame() {
+    bool isReady = false;
+    double bytesReceived = 0;
+
+    if (isPublisherPaused && firstFrameBytesReceived < 0 && fetchCameraPathStats(&isReady, &bytesReceived)) {
+        firstFrameBytesReceived = bytesReceived;
+        return;
+    }
+
+    if (firstFrameRequestedAtMs < 0 || !fetchCameraPathStats(&isReady, &bytesReceived)) {
+        return;
+    }
+
+    if (isReady && bytesReceived > firstFrameBytesReceived) {
+        const long elapsedMs = nowMs() - firstFrameRequestedAtMs;
+
+        atomic_store(&timeToFirstFrameMs, elapsedMs);
+        firstFrameRequestedAtMs = -1;
+        printf("[Camera] Time to first frame: %ld ms\n", elapsedMs);
+
+        if (!isPublisherWarm) {
+            isPublisherWarm = true;
+            pausePublisher(!isPublishingApplied);
+        }
+    } else if (nowMs() - firstFrameRequestedAtMs > CAMERA_FIRST_FRAME_TIMEOUT_MS) {
+        printf("[Camera] No frames after %d ms\n", CAMERA_FIRST_FRAME_TIMEOUT_MS);
+        firstFrameRequestedAtMs = -1;
+    }
+}
+
+static void applyPublishingRequest() {
+    const bool isPublishing = atomic_load(&isPublishingRequested);
+
+    if (isPublishing == isPublishingApplied) {
+        return;
+    }
+
+    isPublishingApplied = isPublishing;
+
+    if (isPublisherWarm) {
+        if (isPublishing && isPublisherPaused) {
+            printf("[Camera] Resuming publisher after %ld ms paused\n", nowMs() - publisherPausedAtMs);
+            firstFrameRequestedAtMs = nowMs();
+        }
+        pausePublisher(!isPublishing);
+    }
+}
+
+static void *cameraSupervisorThread(void *arg) {
+    while (isCameraSupervisorRunning) {
+        if (reapSupervisedProcess(&mediaMtxProcess)) {
+            terminateSupervisedProcess(&publisherProcess);
+        }
+
+        if (reapSupervisedProcess(&publisherProcess)) {
+            isPublisherPaused = false;
+            isPublisherWarm = false;
+        }
+
+        const long now = nowMs();
+
+        if (mediaMtxProcess.pid <= 0 && now >= mediaMtxProcess.restartAtMs) {
+            startSupervisedProcess(&mediaMtxProcess, spawnMediaMtx);
+        }
+
+        if (mediaMtxProcess.pid > 0 && publisherProcess.pid <= 0 && now >= publisherProcess.restartAtMs) {
+            startSupervisedProcess(&publisherProcess, spawnPublisher);
+            firstFrameRequestedAtMs = nowMs();
+            firstFrameBytesReceived = 0;
+        }
+
+        applyPublishingRequest();
+        trackFirstFrame();
+
+        usleep(CAMERA_SUPERVISOR_TICK_US);
+    }
+
+    return NULL;
+}
+
+int startCameraSupervisor() {
+    if (isCameraSupervisorRunning) {
+        return 0;
+    }
+
+    if (getenv("MEDIAMTX_BIN_PATH") == NULL) {
+        printf("[Camera] MEDIAMTX_BIN_PATH is not set, camera supervisor disabled\n");
+        return -1;
+    }
+
+    isCameraSupervisorRunning = true;
+
+    if (pthread_create(&cameraSupervisorThreadHandle, NULL, cameraSupervisorThread, NULL) != 0) {
+        printf("[Camera] Failed to create supervisor thread\n");
+        isCameraSupervisorRunning = false;
+        return -1;
+    }
+
+    return 0;
+}
+
+void stopCameraSupervisor() {
+    if (!isCameraSupervisorRunning) {
+        return;
+    }
+
+    isCameraSupervisorRunning = false;
+    pthread_join(cameraSupervisorThreadHandle, NULL);
+
+    terminateSupervisedProcess(&publisherProcess);
+    terminateSupervisedProcess(&mediaMtxProcess);
+}
+
+void setCameraPublishing(bool isPublishing) {
+    atomic_store(&isPublishingRequested, isPublishing);
+    printf("[Camera] Publishing %s\n", isPublishing ? "on" : "off");
+}
+
+bool isCameraPublishing() {
+    return isPublishingRequested && isPublisherWarm && !isPublisherPaused;
+}
+
+long getCameraTimeToFirstFrameMs() {
+    return atomic_load(&timeToFirstFrameMs);
+}
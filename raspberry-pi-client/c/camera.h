@@ -0,0 +1,22 @@
+#ifndef CAMERA_H
+#define CAMERA_H
+
+#include <stdbool.h>
+
+#define CAMERA_DEFAULT_PATH "cam1"
+#define CAMERA_DEFAULT_API_PORT 9997
+#define CAMERA_DEFAULT_PIPELINE_COMMAND "ffmpeg -f v4l2 -framerate 30 -video_size 1280x720 -input_format mjpeg -i /dev/video0 -vf format=yuv420p -c:v h264_v4l2m2m -b:v 1500k -preset ultrafast -tune zerolatency -g 15 -f rtsp rtsp://localhost:8554/cam1"
+#define CAMERA_SUPERVISOR_TICK_US 50000
+#define CAMERA_RESTART_MIN_BACKOFF_MS 250
+#define CAMERA_RESTART_MAX_BACKOFF_MS 8000
+#define CAMERA_RESTART_STABLE_UPTIME_MS 30000
+#define CAMERA_FIRST_FRAME_TIMEOUT_MS 15000
+#define CAMERA_STOP_TIMEOUT_MS 2000
+#define CAMERA_DEFAULT_READ_TIMEOUT "1h"
+
+int startCameraSupervisor();
+void stopCameraSupervisor();
+void setCameraPublishing(bool isPublishing);
+bool isCameraPublishing();
+long getCameraTimeToFirstFrameMs();
+#endif
@@ -0,0 +1,68 @@
+#include <stdlib.h>
+#include <string.h>
+#include "car-command.h"
+
+static const struct {
+    const char *name;
+    ActionType action;
+} actionNames[] = {
+    {"turn-to", TURN_TO},
+    {"reset-turns", RESET_TURNS},
+    {"steering-calibration-on", STEERING_CALIBRATION_ON},
+    {"steering-calibration-off", STEERING_CALIBRATION_OFF},
+    {"change-degree-of-turns", CHANGE_DEGREE_OF_TURNS},
+    {"forward", FORWARD},
+    {"backward", BACKWARD},
+    {"camera-gimbal-turn-to", CAMERA_GIMBAL_TURN_TO},
+    {"camera-gimbal-set-pitch-angle", CAMERA_GIMBAL_SET_PITCH_ANGLE},
+    {"reset-camera-gimbal", RESET_CAMERA_GIMBAL},
+    {"set-esc-to-neutral-position", SET_ESC_TO_NEUTRAL_POSITION},
+    {"init", INIT},
+    {"start-camera", START_CAMERA},
+    {"stop-camera", STOP_CAMERA},
+    {"follow-waypoints", FOLLOW_WAYPOINTS},
+    {"stop-waypoints", STOP_WAYPOINTS}
+};
+
+ActionType getActionType(const char *action) {
+    for (size_t i = 0; i < sizeof(actionNames) / sizeof(actionNames[0]); i++) {
+        if (strcmp(action, actionNames[i].name) == 0) {
+            return actionNames[i].action;
+        }
+    }
+
+    return ACTION_UNKNOWN;
+}
+
+bool decodeCarCommand(const char *message, CarCommand *command) {
+    memset(command, 0, sizeof(CarCommand));
+    command->action = ACTION_UNKNOWN;
+    command->json = cJSON_Parse(message);
+    command->data = cJSON_GetObjectItem(command->json, "data");
+
+    const cJSON *rawAction = cJSON_GetObjectItem(command->data, "action");
+    if (!cJSON_IsString(rawAction)) {
+        return false;
+    }
+
+    const cJSON *rawValue = cJSON_GetObjectItem(command->data, "degrees");
+    if (!cJSON_IsString(rawValue)) {
+        rawValue = cJSON_GetObjectItem(command->data, "speed");
+    }
+
+    const cJSON *rawSentAt = cJSON_GetObjectItem(command->data, "sentAt");
+
+    command->actionName = rawAction->valuestring;
+    command->action = getActionType(rawAction->valuestring);
+    command->value = cJSON_IsString(rawValue) ? strtof(rawValue->valuestring, NULL) : 0.0f;
+    command->hasSentAt = cJSON_IsString(rawSentAt);
+    command->sentAtMs = command->hasSentAt ? strtol(rawSentAt->valuestring, NULL, 10) : -1;
+
+    return true;
+}
+
+void releaseCarCommand(CarCommand *command) {
+    cJSON_Delete(command->json);
+    command->json = NULL;
+    command->data = NULL;
+}
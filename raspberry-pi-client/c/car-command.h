@@ -0,0 +1,40 @@
+#ifndef CAR_COMMAND_H
+#define CAR_COMMAND_H
+
+#include <cjson/cJSON.h>
+#include <stdbool.h>
+
+typedef enum {
+    TURN_TO,
+    STEERING_CALIBRATION_ON,
+    STEERING_CALIBRATION_OFF,
+    FORWARD,
+    BACKWARD,
+    RESET_TURNS,
+    START_CAMERA,
+    STOP_CAMERA,
+    CAMERA_GIMBAL_TURN_TO,
+    CAMERA_GIMBAL_SET_PITCH_ANGLE,
+    RESET_CAMERA_GIMBAL,
+    CHANGE_DEGREE_OF_TURNS,
+    INIT,
+    SET_ESC_TO_NEUTRAL_POSITION,
+    FOLLOW_WAYPOINTS,
+    STOP_WAYPOINTS,
+    ACTION_UNKNOWN
+} ActionType;
+
+typedef struct {
+    cJSON *json;
+    const cJSON *data;
+    const char *actionName;
+    ActionType action;
+    float value;
+    bool hasSentAt;
+    long sentAtMs;
+} CarCommand;
+
+ActionType getActionType(const char *action);
+bool decodeCarCommand(const char *message, CarCommand *command);
+void releaseCarCommand(CarCommand *command);
+#endif
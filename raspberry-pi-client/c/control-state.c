@@ -0,0 +1,70 @@
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+#include "control-state.h"
+#include "rc-car.h"
+
+#define CONTROL_STATE_WORDS ((sizeof(ControlState) + sizeof(uint32_t) - 1) / sizeof(uint32_t))
+
+static _Atomic uint32_t controlStateSequence = 0;
+static _Atomic uint32_t controlStateWords[CONTROL_STATE_WORDS];
+static ControlState controlState;
+
+static void publishControlState() {
+    uint32_t words[CONTROL_STATE_WORDS] = {0};
+    const uint32_t sequence = atomic_load_explicit(&controlStateSequence, memory_order_relaxed);
+
+    memcpy(words, &controlState, sizeof(ControlState));
+
+    atomic_store_explicit(&controlStateSequence, sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    for (size_t i = 0; i < CONTROL_STATE_WORDS; i++) {
+        atomic_store_explicit(&controlStateWords[i], words[i], memory_order_relaxed);
+    }
+
+    atomic_store_explicit(&controlStateSequence, sequence + 2, memory_order_release);
+}
+
+void resetControlState() {
+    controlState.isCarTurning = false;
+    controlState.escPulseWidth = CAR_ESC_NEUTRAL_PWM;
+    publishControlState();
+}
+
+void setControlCarTurning(bool isCarTurning) {
+    controlState.isCarTurning = isCarTurning;
+    publishControlState();
+}
+
+void setControlEscPulseWidth(int escPulseWidth) {
+    controlState.escPulseWidth = escPulseWidth;
+    publishControlState();
+}
+
+void setControlState(const ControlState *state) {
+    controlState = *state;
+    publishControlState();
+}
+
+uint32_t readControlState(ControlState *state) {
+    uint32_t words[CONTROL_STATE_WORDS];
+    uint32_t before;
+
+    do {
+        before = atomic_load_explicit(&controlStateSequence, memory_order_acquire);
+
+        for (size_t i = 0; i < CONTROL_STATE_WORDS; i++) {
+            words[i] = atomic_load_explicit(&controlStateWords[i], memory_order_relaxed);
+        }
+
+        atomic_thread_fence(memory_order_acquire);
+    } while ((before & 1u) || atomic_load_explicit(&controlStateSequence, memory_order_relaxed) != before);
+
+    memcpy(state, words, sizeof(ControlState));
+    return before;
+}
+
+bool isControlStateCurrent(uint32_t sequence) {
+    return atomic_load_explicit(&controlStateSequence, memory_order_acquire) == sequence;
+}
@@ -0,0 +1,18 @@
+#ifndef CONTROL_STATE_H
+#define CONTROL_STATE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct {
+    bool isCarTurning;
+    int escPulseWidth;
+} ControlState;
+
+void resetControlState();
+void setControlCarTurning(bool isCarTurning);
+void setControlEscPulseWidth(int escPulseWidth);
+void setControlState(const ControlState *state);
+uint32_t readControlState(ControlState *state);
+bool isControlStateCurrent(uint32_t sequence);
+#endif
@@ -0,0 +1,178 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "dead-reckoning.h"
+#include "flight-recorder.h"
+#include "imu-calibration.h"
+#include "mpu6050.h"
+#include "position-estimator.h"
+#include "reactor.h"
+#include "state-bus.h"
+#include "telemetry.h"
+
+static PositionEstimator positionEstimator;
+static ImuCalibration deadReckoningCalibration = {0};
+static bool hasDeadReckoningCalibration = false;
+static float accelXOffset = 0.0f;
+static float gyroZBiasSum = 0.0f;
+static float accelXBiasSum = 0.0f;
+static int biasSamples = 0;
+static int deadReckoningImuHandle = -1;
+static int deadReckoningTimerFd = -1;
+static long lastPredictionAtUs = -1;
+static long updateCount = 0;
+static long updateTotalNs = 0;
+static long updateMaxNs = 0;
+static long statsStartedAtUs = 0;
+
+static long nowUs() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000L + now.tv_nsec / 1000L;
+}
+
+static long nowNs() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000000L + now.tv_nsec;
+}
+
+static void publishPositionEstimate() {
+    PositionEstimate estimate;
+
+    if (getPositionEstimate(&positionEstimator, &estimate)) {
+        updateTelemetryEstimate(estimate.latitude, estimate.longitude, estimate.heading, estimate.positionStdDev);
+        updateStateBusEstimate(estimate.latitude, estimate.longitude, estimate.heading, estimate.positionStdDev);
+    }
+}
+
+static void reportDeadReckoningStats(long now) {
+    if (now - statsStartedAtUs < DEAD_RECKONING_STATS_INTERVAL_US || updateCount == 0) {
+        return;
+    }
+
+    const double elapsedNs = (double)(now - statsStartedAtUs) * 1000.0;
+    printf(
+        "[Estimator] %.1f Hz, avg %ld ns, max %ld ns per update, %.3f%% of one core\n",
+        updateCount * 1e9 / elapsedNs,
+        updateTotalNs / updateCount,
+        updateMaxNs,
+        updateTotalNs * 100.0 / elapsedNs
+    );
+
+    updateCount = 0;
+    updateTotalNs = 0;
+    updateMaxNs = 0;
+    statsStartedAtUs = now;
+}
+
+static void sampleDeadReckoningBias() {
+    gyroZBiasSum += readMPU6050Data(deadReckoningImuHandle, GYRO_ZOUT_H) / GYRO_SENSITIVITY;
+    accelXBiasSum += readMPU6050Data(deadReckoningImuHandle, ACCEL_XOUT_H) / ACCEL_SENSITIVITY;
+    biasSamples++;
+
+    if (biasSamples < DEAD_RECKONING_BIAS_SAMPLES) {
+        return;
+    }
+
+    accelXOffset = accelXBiasSum / DEAD_RECKONING_BIAS_SAMPLES;
+    if (!hasDeadReckoningCalibration) {
+        deadReckoningCalibration.gyroZOffset = gyroZBiasSum / DEAD_RECKONING_BIAS_SAMPLES;
+        printf("[Estimator] No cached IMU calibration, using gyro Z offset %.2f from startup samples\n", deadReckoningCalibration.gyroZOffset);
+    }
+}
+
+static void deadReckoningTick(int fd, uint32_t events, void *arg) {
+    const long startedAtNs = nowNs();
+    const long now = nowUs();
+    float yawRate = 0.0f;
+    float forwardAcceleration = 0.0f;
+
+    if (deadReckoningImuHandle >= 0 && biasSamples < DEAD_RECKONING_BIAS_SAMPLES) {
+        sampleDeadReckoningBias();
+    } else if (deadReckoningImuHandle >= 0) {
+        yawRate = readMPU6050Data(deadReckoningImuHandle, GYRO_ZOUT_H) / GYRO_SENSITIVITY - deadReckoningCalibration.gyroZOffset;
+        forwardAcceleration = (readMPU6050Data(deadReckoningImuHandle, ACCEL_XOUT_H) / ACCEL_SENSITIVITY - accelXOffset) * 9.81f;
+        recordFlightImu(yawRate, forwardAcceleration);
+        updateStateBusYawRate(yawRate);
+        updateStateBusForwardAcceleration(forwardAcceleration);
+    }
+
+    if (lastPredictionAtUs >= 0) {
+        predictPositionEstimator(&positionEstimator, yawRate, forwardAcceleration, (float)(now - lastPredictionAtUs) / 1e6f);
+    }
+    lastPredictionAtUs = now;
+    publishPositionEstimate();
+
+    const long elapsedNs = nowNs() - startedAtNs;
+    updateCount++;
+    updateTotalNs += elapsedNs;
+    if (elapsedNs > updateMaxNs) {
+        updateMaxNs = elapsedNs;
+    }
+    reportDeadReckoningStats(now);
+}
+
+void onDeadReckoningGpsFix(double latitude, double longitude, float speed, float track, bool hasTrack) {
+    if (deadReckoningTimerFd < 0) {
+        return;
+    }
+
+    updatePositionEstimatorWithGps(&positionEstimator, latitude, longitude, speed, track, hasTrack);
+    publishPositionEstimate();
+}
+
+bool getDeadReckoningEstimate(PositionEstimate *estimate) {
+    return deadReckoningTimerFd >= 0 && getPositionEstimate(&positionEstimator, estimate);
+}
+
+static void openDeadReckoningImu() {
+    deadReckoningImuHandle = openMPU6050();
+
+    if (deadReckoningImuHandle < 0) {
+        printf("[Estimator] MPU6050 is not available, using GPS only\n");
+        return;
+    }
+
+    hasDeadReckoningCalibration = loadImuCalibration(getImuCalibrationPath(), &deadReckoningCalibration);
+    gyroZBiasSum = 0.0f;
+    accelXBiasSum = 0.0f;
+    biasSamples = 0;
+}
+
+int startDeadReckoning() {
+    const char *isEnabled = getenv("POSITION_ESTIMATOR");
+
+    if (isEnabled != NULL && strcmp(isEnabled, "0") == 0) {
+        return -1;
+    }
+
+    resetPositionEstimator(&positionEstimator);
+    openDeadReckoningImu();
+
+    statsStartedAtUs = nowUs();
+    deadReckoningTimerFd = addReactorTimer(1000000L / POSITION_ESTIMATOR_RATE_HZ, deadReckoningTick, NULL);
+    if (deadReckoningTimerFd < 0) {
+        printf("[Estimator] Failed to schedule dead reckoning\n");
+        return -1;
+    }
+
+    printf("[Estimator] Dead reckoning at %d Hz\n", POSITION_ESTIMATOR_RATE_HZ);
+
+    return 0;
+}
+
+void stopDeadReckoning() {
+    if (deadReckoningTimerFd < 0) {
+        return;
+    }
+
+    removeReactorTimer(deadReckoningTimerFd);
+    deadReckoningTimerFd = -1;
+
+    if (deadReckoningImuHandle >= 0) {
+        deinitMPU6050(deadReckoningImuHandle);
+        deadReckoningImuHandle = -1;
+    }
+}
@@ -0,0 +1,15 @@
+#ifndef DEAD_RECKONING_H
+#define DEAD_RECKONING_H
+
+#include <libwebsockets.h>
+#include <stdbool.h>
+#include "position-estimator.h"
+
+#define DEAD_RECKONING_BIAS_SAMPLES 20
+#define DEAD_RECKONING_STATS_INTERVAL_US (10 * LWS_US_PER_SEC)
+
+int startDeadReckoning();
+void stopDeadReckoning();
+bool getDeadReckoningEstimate(PositionEstimate *estimate);
+void onDeadReckoningGpsFix(double latitude, double longitude, float speed, float track, bool hasTrack);
+#endif
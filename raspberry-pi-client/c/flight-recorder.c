@@ -0,0 +1,157 @@
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include "flight-recorder.h"
+
+static FlightRecorderHeader *flightRecorderHeader = NULL;
+static FlightRecord *flightRecords = NULL;
+static size_t flightRecorderSize = 0;
+static uint32_t flightRecorderBoot = 0;
+
+static uint64_t clockNs(clockid_t clock) {
+    struct timespec now;
+    clock_gettime(clock, &now);
+    return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+}
+
+int openFlightRecorder() {
+    const char *path = getenv("FLIGHT_RECORDER_PATH");
+    const char *records = getenv("FLIGHT_RECORDER_RECORDS");
+    const uint32_t capacity = records != NULL && atoi(records) > 0 ? (uint32_t)atoi(records) : FLIGHT_RECORDER_DEFAULT_RECORDS;
+
+    if (path != NULL && strcmp(path, "off") == 0) {
+        return -1;
+    }
+
+    if (path == NULL || path[0] == '\0') {
+        path = FLIGHT_RECORDER_DEFAULT_PATH;
+    }
+
+    const int fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        perror("[FlightRecorder] open");
+        return -1;
+    }
+
+    flightRecorderSize = sizeof(FlightRecorderHeader) + (size_t)capacity * sizeof(FlightRecord);
+
+    if (ftruncate(fd, (off_t)flightRecorderSize) != 0) {
+        perror("[FlightRecorder] ftruncate");
+        close(fd);
+        return -1;
+    }
+
+    void *mapping = mmap(NULL, flightRecorderSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (mapping == MAP_FAILED) {
+        perror("[FlightRecorder] mmap");
+        return -1;
+    }
+
+    flightRecorderHeader = (FlightRecorderHeader *)mapping;
+    flightRecords = (FlightRecord *)((char *)mapping + sizeof(FlightRecorderHeader));
+
+    if (
+        flightRecorderHeader->magic != FLIGHT_RECORDER_MAGIC
+        || flightRecorderHeader->version != FLIGHT_RECORDER_VERSION
+        || flightRecorderHeader->recordSize != sizeof(FlightRecord)
+        || flightRecorderHeader->capacity != capacity
+    ) {
+        memset(mapping, 0, flightRecorderSize);
+        flightRecorderHeader->magic = FLIGHT_RECORDER_MAGIC;
+        flightRecorderHeader->version = FLIGHT_RECORDER_VERSION;
+        flightRecorderHeader->recordSize = sizeof(FlightRecord);
+        flightRecorderHeader->capacity = capacity;
+    }
+
+    flightRecorderBoot = ++flightRecorderHeader->boot;
+    FlightRecorderBoot *boot = &flightRecorderHeader->boots[flightRecorderBoot % FLIGHT_RECORDER_MAX_BOOTS];
+    boot->monotonicBaseNs = clockNs(CLOCK_MONOTONIC);
+    boot->realtimeBaseNs = clockNs(CLOCK_REALTIME);
+    boot->boot = flightRecorderBoot;
+
+    printf("[FlightRecorder] Recording %u records to %s\n", capacity, path);
+
+    return 0;
+}
+
+void closeFlightRecorder() {
+    if (flightRecorderHeader == NULL) {
+        return;
+    }
+
+    msync(flightRecorderHeader, flightRecorderSize, MS_ASYNC);
+    munmap(flightRecorderHeader, flightRecorderSize);
+    flightRecorderHeader = NULL;
+    flightRecords = NULL;
+}
+
+static void appendFlightRecord(FlightRecord *record) {
+    if (flightRecorderHeader == NULL) {
+        return;
+    }
+
+    const uint64_t sequence = atomic_fetch_add_explicit(
+        (_Atomic uint64_t *)&flightRecorderHeader->writeIndex,
+        1,
+        memory_order_relaxed
+    );
+    FlightRecord *slot = &flightRecords[sequence % flightRecorderHeader->capacity];
+
+    record->timestampNs = clockNs(CLOCK_MONOTONIC);
+    record->boot = flightRecorderBoot;
+
+    atomic_store_explicit((_Atomic uint64_t *)&slot->sequence, UINT64_MAX, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    memcpy(
+        (char *)slot + offsetof(FlightRecord, timestampNs),
+        (const char *)record + offsetof(FlightRecord, timestampNs),
+        sizeof(FlightRecord) - offsetof(FlightRecord, timestampNs)
+    );
+    atomic_store_explicit((_Atomic uint64_t *)&slot->sequence, sequence, memory_order_release);
+}
+
+void recordFlightCommand(const char *action, float value) {
+    FlightRecord record = {.type = FLIGHT_RECORD_COMMAND};
+    strncpy(record.data.command.action, action, FLIGHT_RECORDER_ACTION_SIZE - 1);
+    record.data.command.value = value;
+    appendFlightRecord(&record);
+}
+
+void recordFlightActuator(int pin, int pulseWidth) {
+    FlightRecord record = {.type = FLIGHT_RECORD_ACTUATOR, .code = (uint16_t)pin};
+    record.data.actuator.pulseWidth = pulseWidth;
+    appendFlightRecord(&record);
+}
+
+void recordFlightGps(double latitude, double longitude, float speed, float track, int fixMode) {
+    FlightRecord record = {.type = FLIGHT_RECORD_GPS};
+    record.data.gps.latitude = latitude;
+    record.data.gps.longitude = longitude;
+    record.data.gps.speed = speed;
+    record.data.gps.track = track;
+    record.data.gps.fixMode = fixMode;
+    appendFlightRecord(&record);
+}
+
+void recordFlightImu(float yawRate, float forwardAcceleration) {
+    FlightRecord record = {.type = FLIGHT_RECORD_IMU};
+    record.data.imu.yawRate = yawRate;
+    record.data.imu.forwardAcceleration = forwardAcceleration;
+    appendFlightRecord(&record);
+}
+
+void recordFlightSteeringCorrection(float yawRate, float correctionAngle) {
+    FlightRecord record = {.type = FLIGHT_RECORD_STEERING_CORRECTION};
+    record.data.steeringCorrection.yawRate = yawRate;
+    record.data.steeringCorrection.correctionAngle = correctionAngle;
+    appendFlightRecord(&record);
+}
@@ -0,0 +1,85 @@
+#ifndef FLIGHT_RECORDER_H
+#define FLIGHT_RECORDER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define FLIGHT_RECORDER_MAGIC 0x52435246u
+#define FLIGHT_RECORDER_VERSION 2
+#define FLIGHT_RECORDER_DEFAULT_PATH "flight-recorder.bin"
+#define FLIGHT_RECORDER_DEFAULT_RECORDS 262144
+#define FLIGHT_RECORDER_ACTION_SIZE 32
+#define FLIGHT_RECORDER_MAX_BOOTS 16
+
+typedef enum {
+    FLIGHT_RECORD_COMMAND = 1,
+    FLIGHT_RECORD_ACTUATOR,
+    FLIGHT_RECORD_GPS,
+    FLIGHT_RECORD_IMU,
+    FLIGHT_RECORD_STEERING_CORRECTION
+} FlightRecordType;
+
+typedef struct {
+    uint64_t sequence;
+    uint64_t timestampNs;
+    uint16_t type;
+    uint16_t code;
+    uint32_t boot;
+    union {
+        struct {
+            char action[FLIGHT_RECORDER_ACTION_SIZE];
+            float value;
+        } command;
+        struct {
+            int32_t pulseWidth;
+        } actuator;
+        struct {
+            double latitude;
+            double longitude;
+            float speed;
+            float track;
+            int32_t fixMode;
+        } gps;
+        struct {
+            float yawRate;
+            float forwardAcceleration;
+        } imu;
+        struct {
+            float yawRate;
+            float correctionAngle;
+        } steeringCorrection;
+        uint8_t raw[40];
+    } data;
+} FlightRecord;
+
+_Static_assert(sizeof(FlightRecord) == 64, "FlightRecord must stay 64 bytes");
+
+typedef struct {
+    uint32_t boot;
+    uint32_t reserved;
+    uint64_t monotonicBaseNs;
+    uint64_t realtimeBaseNs;
+} FlightRecorderBoot;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t recordSize;
+    uint32_t capacity;
+    uint32_t boot;
+    uint32_t reserved;
+    uint64_t writeIndex;
+    FlightRecorderBoot boots[FLIGHT_RECORDER_MAX_BOOTS];
+    uint8_t padding[96];
+} FlightRecorderHeader;
+
+_Static_assert(sizeof(FlightRecorderHeader) == 512, "FlightRecorderHeader must stay 512 bytes");
+
+int openFlightRecorder();
+void closeFlightRecorder();
+void recordFlightCommand(const char *action, float value);
+void recordFlightActuator(int pin, int pulseWidth);
+void recordFlightGps(double latitude, double longitude, float speed, float track, int fixMode);
+void recordFlightImu(float yawRate, float forwardAcceleration);
+void recordFlightSteeringCorrection(float yawRate, float correctionAngle);
+#endif
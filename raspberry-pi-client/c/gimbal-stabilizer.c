@@ -0,0 +1,271 @@
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "actuator.h"
+#include "gimbal-stabilizer.h"
+#include "imu-calibration.h"
+#include "mpu6050.h"
+#include "rc-car.h"
+
+typedef enum {
+    GIMBAL_YAW,
+    GIMBAL_PITCH,
+    GIMBAL_AXIS_COUNT
+} GimbalAxis;
+
+static const int gimbalPins[GIMBAL_AXIS_COUNT] = {CAR_CAMERA_GIMBAL_PIN4, CAR_CAMERA_GIMBAL_PIN3};
+static GimbalAxisConfig gimbalConfigs[GIMBAL_AXIS_COUNT];
+static _Atomic float gimbalTargets[GIMBAL_AXIS_COUNT];
+static ImuCalibration gimbalCalibration = {0};
+static pthread_t gimbalThreadHandle;
+static atomic_bool isGimbalStabilizerRunning = false;
+static int gimbalImuHandle = -1;
+static int gimbalRateHz = GIMBAL_STABILIZER_DEFAULT_RATE_HZ;
+static int gimbalServoRateHz = GIMBAL_STABILIZER_DEFAULT_SERVO_RATE_HZ;
+static float yawHoldSeconds = GIMBAL_STABILIZER_DEFAULT_YAW_HOLD_S;
+
+static float getGimbalSetting(const char *name, float fallback) {
+    const char *value = getenv(name);
+    return value != NULL && value[0] != '\0' ? (float)atof(value) : fallback;
+}
+
+static long nowNs() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000000L + now.tv_nsec;
+}
+
+static int angleToPulseWidth(float degrees) {
+    return (int)floorf(((degrees + 90) / 180.0f) * (CAR_CAMERA_GIMBAL_MAX_PMW - CAR_CAMERA_GIMBAL_MIN_PMW) + CAR_CAMERA_GIMBAL_MIN_PMW);
+}
+
+static float clampGimbal(float value, float limit) {
+    return value > limit ? limit : (value < -limit ? -limit : value);
+}
+
+void resetGimbalAxis(GimbalAxisState *state, float angle) {
+    state->servoAngle = angle;
+    state->commandedAngle = angle;
+    state->integral = 0.0f;
+    state->previousError = 0.0f;
+    state->hasPreviousError = false;
+}
+
+float stepGimbalAxis(
+    GimbalAxisState *state,
+    const GimbalAxisConfig *config,
+    float target,
+    float bodyAngle,
+    float bodyRate,
+    float dt
+) {
+    const float predictedBodyAngle = bodyAngle + config->feedForward * bodyRate * GIMBAL_STABILIZER_SERVO_TIME_CONSTANT;
+    const float feedForward = config->sign * (target - predictedBodyAngle);
+    const float error = target - (bodyAngle + config->sign * state->servoAngle);
+    const float derivative = state->hasPreviousError ? (error - state->previousError) / dt : 0.0f;
+
+    state->integral = clampGimbal(state->integral + error * dt, config->integralLimit);
+    state->previousError = error;
+    state->hasPreviousError = true;
+
+    float command = feedForward + config->sign * (config->kp * error + config->ki * state->integral + config->kd * derivative);
+    const float maxStep = config->maxSlewRate * dt;
+
+    if (config->maxSlewRate > 0.0f) {
+        command = state->commandedAngle + clampGimbal(command - state->commandedAngle, maxStep);
+    }
+
+    state->commandedAngle = clampGimbal(command, GIMBAL_STABILIZER_MAX_ANGLE);
+    state->servoAngle += (state->commandedAngle - state->servoAngle) * (1.0f - expf(-dt / GIMBAL_STABILIZER_SERVO_TIME_CONSTANT));
+
+    return state->commandedAngle;
+}
+
+static void *gimbalStabilizerThread(void *arg) {
+    GimbalAxisState axes[GIMBAL_AXIS_COUNT];
+    int committedPulseWidths[GIMBAL_AXIS_COUNT] = {0, 0};
+    const long periodNs = 1000000000L / gimbalRateHz;
+    const int servoDivider = gimbalServoRateHz > 0 && gimbalServoRateHz < gimbalRateHz ? gimbalRateHz / gimbalServoRateHz : 1;
+    const float dt = 1.0f / (float)gimbalRateHz;
+    const float radiansToDegrees = 180.0f / (float)M_PI;
+    float bodyPitch = 0.0f;
+    float bodyYaw = 0.0f;
+    bool hasAttitude = false;
+    long tick = 0;
+    long updateCount = 0;
+    long updateTotalNs = 0;
+    long updateMaxNs = 0;
+    long servoWrites = 0;
+    long overruns = 0;
+    long statsStartedAtNs = nowNs();
+    Mpu6050Motion motion;
+    struct timespec nextTick;
+
+    for (int i = 0; i < GIMBAL_AXIS_COUNT; i++) {
+        resetGimbalAxis(&axes[i], atomic_load(&gimbalTargets[i]));
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &nextTick);
+
+    while (atomic_load_explicit(&isGimbalStabilizerRunning, memory_order_relaxed)) {
+        const long startedAtNs = nowNs();
+
+        if (readMPU6050Motion(gimbalImuHandle, &motion) == 0) {
+            const float pitchRate = motion.gyroY / GYRO_SENSITIVITY - gimbalCalibration.gyroYOffset;
+            const float yawRate = motion.gyroZ / GYRO_SENSITIVITY - gimbalCalibration.gyroZOffset;
+            const float accelX = motion.accelX / ACCEL_SENSITIVITY;
+            const float accelY = motion.accelY / ACCEL_SENSITIVITY;
+            const float accelZ = motion.accelZ / ACCEL_SENSITIVITY;
+            const float accelPitch = atan2f(-accelX, sqrtf(accelY * accelY + accelZ * accelZ)) * radiansToDegrees;
+
+            if (!hasAttitude) {
+                bodyPitch = accelPitch;
+                hasAttitude = true;
+            } else {
+                bodyPitch = (1.0f - GIMBAL_STABILIZER_ACCEL_WEIGHT) * (bodyPitch + pitchRate * dt) + GIMBAL_STABILIZER_ACCEL_WEIGHT * accelPitch;
+            }
+            bodyYaw = bodyYaw * (1.0f - dt / yawHoldSeconds) + yawRate * dt;
+
+            const float yaw = stepGimbalAxis(&axes[GIMBAL_YAW], &gimbalConfigs[GIMBAL_YAW], atomic_load_explicit(&gimbalTargets[GIMBAL_YAW], memory_order_relaxed), bodyYaw, yawRate, dt);
+            const float pitch = stepGimbalAxis(&axes[GIMBAL_PITCH], &gimbalConfigs[GIMBAL_PITCH], atomic_load_explicit(&gimbalTargets[GIMBAL_PITCH], memory_order_relaxed), bodyPitch, pitchRate, dt);
+            const float angles[GIMBAL_AXIS_COUNT] = {yaw, pitch};
+
+            if (tick % servoDivider == 0) {
+                for (int i = 0; i < GIMBAL_AXIS_COUNT; i++) {
+                    const int pulseWidth = angleToPulseWidth(angles[i]);
+
+                    if (pulseWidth != committedPulseWidths[i]) {
+                        commitServo(gimbalPins[i], pulseWidth);
+                        committedPulseWidths[i] = pulseWidth;
+                        servoWrites++;
+                    }
+                }
+            }
+        }
+        tick++;
+
+        const long finishedAtNs = nowNs();
+        const long elapsedNs = finishedAtNs - startedAtNs;
+        updateCount++;
+        updateTotalNs += elapsedNs;
+        if (elapsedNs > updateMaxNs) {
+            updateMaxNs = elapsedNs;
+        }
+
+        if (finishedAtNs - statsStartedAtNs >= GIMBAL_STABILIZER_STATS_INTERVAL_NS) {
+            const double windowNs = (double)(finishedAtNs - statsStartedAtNs);
+            printf(
+                "[Gimbal] %.1f Hz, avg %ld ns, max %ld ns per update, %.3f%% of one core, %.1f servo writes/s, %ld overruns\n",
+                updateCount * 1e9 / windowNs,
+                updateTotalNs / updateCount,
+                updateMaxNs,
+                updateTotalNs * 100.0 / windowNs,
+                servoWrites * 1e9 / windowNs,
+                overruns
+            );
+            updateCount = 0;
+            updateTotalNs = 0;
+            updateMaxNs = 0;
+            servoWrites = 0;
+            overruns = 0;
+            statsStartedAtNs = finishedAtNs;
+        }
+
+        nextTick.tv_nsec += periodNs;
+        while (nextTick.tv_nsec >= 1000000000L) {
+            nextTick.tv_nsec -= 1000000000L;
+            nextTick.tv_sec++;
+        }
+
+        if (finishedAtNs > nextTick.tv_sec * 1000000000L + nextTick.tv_nsec) {
+            overruns++;
+            clock_gettime(CLOCK_MONOTONIC, &nextTick);
+            continue;
+        }
+
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &nextTick, NULL);
+    }
+
+    return NULL;
+}
+
+static void loadGimbalAxisConfig(GimbalAxisConfig *config, const char *signName) {
+    config->kp = getGimbalSetting("GIMBAL_STABILIZER_KP", GIMBAL_STABILIZER_DEFAULT_KP);
+    config->ki = getGimbalSetting("GIMBAL_STABILIZER_KI", GIMBAL_STABILIZER_DEFAULT_KI);
+    config->kd = getGimbalSetting("GIMBAL_STABILIZER_KD", GIMBAL_STABILIZER_DEFAULT_KD);
+    config->feedForward = getGimbalSetting("GIMBAL_STABILIZER_FEED_FORWARD", GIMBAL_STABILIZER_DEFAULT_FEED_FORWARD);
+    config->maxSlewRate = getGimbalSetting("GIMBAL_STABILIZER_MAX_SLEW", GIMBAL_STABILIZER_DEFAULT_MAX_SLEW);
+    config->integralLimit = GIMBAL_STABILIZER_INTEGRAL_LIMIT;
+    config->sign = getGimbalSetting(signName, 1.0f) < 0.0f ? -1.0f : 1.0f;
+}
+
+int startGimbalStabilizer() {
+    const char *isEnabled = getenv("GIMBAL_STABILIZER");
+
+    if (isEnabled == NULL || strcmp(isEnabled, "1") != 0) {
+        return -1;
+    }
+
+    gimbalImuHandle = openMPU6050();
+    if (gimbalImuHandle < 0) {
+        printf("[Gimbal] MPU6050 is not available, gimbal stays open-loop\n");
+        return -1;
+    }
+
+    activateImuCalibration(gimbalImuHandle, &gimbalCalibration);
+
+    loadGimbalAxisConfig(&gimbalConfigs[GIMBAL_YAW], "GIMBAL_STABILIZER_YAW_SIGN");
+    loadGimbalAxisConfig(&gimbalConfigs[GIMBAL_PITCH], "GIMBAL_STABILIZER_PITCH_SIGN");
+    gimbalRateHz = (int)getGimbalSetting("GIMBAL_STABILIZER_RATE_HZ", GIMBAL_STABILIZER_DEFAULT_RATE_HZ);
+    gimbalServoRateHz = (int)getGimbalSetting("GIMBAL_STABILIZER_SERVO_RATE_HZ", GIMBAL_STABILIZER_DEFAULT_SERVO_RATE_HZ);
+    yawHoldSeconds = getGimbalSetting("GIMBAL_STABILIZER_YAW_HOLD_S", GIMBAL_STABILIZER_DEFAULT_YAW_HOLD_S);
+
+    if (gimbalRateHz <= 0) {
+        gimbalRateHz = GIMBAL_STABILIZER_DEFAULT_RATE_HZ;
+    }
+    if (yawHoldSeconds <= 1.0f / gimbalRateHz) {
+        yawHoldSeconds = GIMBAL_STABILIZER_DEFAULT_YAW_HOLD_S;
+    }
+
+    atomic_store(&isGimbalStabilizerRunning, true);
+
+    if (pthread_create(&gimbalThreadHandle, NULL, gimbalStabilizerThread, NULL) != 0) {
+        printf("[Gimbal] Failed to create stabilizer thread\n");
+        atomic_store(&isGimbalStabilizerRunning, false);
+        deinitMPU6050(gimbalImuHandle);
+        gimbalImuHandle = -1;
+        return -1;
+    }
+
+    printf("[Gimbal] Stabilizing at %d Hz, servo updates at %d Hz\n", gimbalRateHz, gimbalServoRateHz);
+
+    return 0;
+}
+
+void stopGimbalStabilizer() {
+    if (!atomic_load(&isGimbalStabilizerRunning)) {
+        return;
+    }
+
+    atomic_store(&isGimbalStabilizerRunning, false);
+    pthread_join(gimbalThreadHandle, NULL);
+
+    deinitMPU6050(gimbalImuHandle);
+    gimbalImuHandle = -1;
+}
+
+bool isGimbalStabilizerActive() {
+    return atomic_load_explicit(&isGimbalStabilizerRunning, memory_order_relaxed);
+}
+
+void setGimbalStabilizerYaw(float degrees) {
+    atomic_store_explicit(&gimbalTargets[GIMBAL_YAW], clampGimbal(degrees, GIMBAL_STABILIZER_MAX_ANGLE), memory_order_relaxed);
+}
+
+void setGimbalStabilizerPitch(float degrees) {
+    atomic_store_explicit(&gimbalTargets[GIMBAL_PITCH], clampGimbal(degrees, GIMBAL_STABILIZER_MAX_ANGLE), memory_order_relaxed);
+}
@@ -0,0 +1,53 @@
+#ifndef GIMBAL_STABILIZER_H
+#define GIMBAL_STABILIZER_H
+
+#include <stdbool.h>
+
+#define GIMBAL_STABILIZER_DEFAULT_RATE_HZ 200
+#define GIMBAL_STABILIZER_DEFAULT_SERVO_RATE_HZ 50
+#define GIMBAL_STABILIZER_DEFAULT_MAX_SLEW 600.0f
+#define GIMBAL_STABILIZER_DEFAULT_KP 0.6f
+#define GIMBAL_STABILIZER_DEFAULT_KI 1.0f
+#define GIMBAL_STABILIZER_DEFAULT_KD 0.0f
+#define GIMBAL_STABILIZER_DEFAULT_FEED_FORWARD 1.0f
+#define GIMBAL_STABILIZER_DEFAULT_YAW_HOLD_S 1.0f
+#define GIMBAL_STABILIZER_SERVO_TIME_CONSTANT 0.05f
+#define GIMBAL_STABILIZER_ACCEL_WEIGHT 0.02f
+#define GIMBAL_STABILIZER_INTEGRAL_LIMIT 20.0f
+#define GIMBAL_STABILIZER_MAX_ANGLE 90.0f
+#define GIMBAL_STABILIZER_STATS_INTERVAL_NS 10000000000L
+
+typedef struct {
+    float kp;
+    float ki;
+    float kd;
+    float feedForward;
+    float integralLimit;
+    float maxSlewRate;
+    float sign;
+} GimbalAxisConfig;
+
+typedef struct {
+    float servoAngle;
+    float commandedAngle;
+    float integral;
+    float previousError;
+    bool hasPreviousError;
+} GimbalAxisState;
+
+void resetGimbalAxis(GimbalAxisState *state, float angle);
+float stepGimbalAxis(
+    GimbalAxisState *state,
+    const GimbalAxisConfig *config,
+    float target,
+    float bodyAngle,
+    float bodyRate,
+    float dt
+);
+
+int startGimbalStabilizer();
+void stopGimbalStabilizer();
+bool isGimbalStabilizerActive();
+void setGimbalStabilizerYaw(float degrees);
+void setGimbalStabilizerPitch(float degrees);
+#endif
@@ -0,0 +1,155 @@
+#include <gps.h>
+#include <sys/epoll.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "dead-reckoning.h"
+#include "flight-recorder.h"
+#include "gps-source.h"
+#include "reactor.h"
+#include "state-bus.h"
+#include "telemetry.h"
+
+#define MODE_STR_NUM 4
+
+static char *mode_str[MODE_STR_NUM] = {
+    "n/a",
+    "None",
+    "2D",
+    "3D"
+};
+
+static struct gps_data_t gpsData;
+static GpsSourceType gpsSourceType = GPS_SOURCE_NONE;
+static struct timespec lastFixTime = {0, 0};
+
+static void handleGpsReport() {
+    if (MODE_SET != (MODE_SET & gpsData.set)) {
+        return;
+    }
+
+    if (gpsData.fix.mode < 0 || MODE_STR_NUM <= gpsData.fix.mode) {
+        gpsData.fix.mode = 0;
+    }
+
+    if (TIME_SET == (TIME_SET & gpsData.set)) {
+        if (gpsData.fix.time.tv_sec == lastFixTime.tv_sec && gpsData.fix.time.tv_nsec == lastFixTime.tv_nsec) {
+            return;
+        }
+        lastFixTime = gpsData.fix.time;
+    }
+
+    if (isfinite(gpsData.fix.latitude) && isfinite(gpsData.fix.longitude)) {
+        recordFlightGps(gpsData.fix.latitude, gpsData.fix.longitude, (float)gpsData.fix.speed, (float)gpsData.fix.track, gpsData.fix.mode);
+        updateStateBusGps(gpsData.fix.latitude, gpsData.fix.longitude, (float)gpsData.fix.speed, (float)gpsData.fix.track, gpsData.fix.mode);
+        updateTelemetryGps(gpsData.fix.latitude, gpsData.fix.longitude, gpsData.fix.speed, gpsData.fix.mode);
+
+        if (gpsData.fix.mode >= MODE_2D) {
+            onDeadReckoningGpsFix(
+                gpsData.fix.latitude,
+                gpsData.fix.longitude,
+                isfinite(gpsData.fix.speed) ? (float)gpsData.fix.speed : 0.0f,
+                (float)gpsData.fix.track,
+                isfinite(gpsData.fix.track)
+            );
+        }
+    } else {
+        printf("[GPS] Fix mode: %s (%d) Lat n/a Lon n/a\n", mode_str[gpsData.fix.mode], gpsData.fix.mode);
+    }
+}
+
+static void onGpsSocketReadable(int fd, uint32_t events, void *arg) {
+    do {
+        if (-1 == gps_read(&gpsData, NULL, 0)) {
+            printf("[GPS] Read error\n");
+            removeReactorFd(fd);
+            return;
+        }
+
+        handleGpsReport();
+    } while (gps_waiting(&gpsData, 0));
+}
+
+static bool openGpsSharedMemory() {
+    if (0 != gps_open(GPSD_SHARED_MEMORY, NULL, &gpsData)) {
+        printf("[GPS] gpsd shared memory export is not available\n");
+        return false;
+    }
+
+    gpsSourceType = GPS_SOURCE_SHARED_MEMORY;
+    printf("[GPS] Reading gpsd shared memory export\n");
+
+    return true;
+}
+
+static bool openGpsSocket() {
+    const char *host = getenv("GPSD_HOST");
+    const char *port = getenv("GPSD_PORT");
+
+    if (0 != gps_open(
+        host != NULL && host[0] != '\0' ? host : GPSD_DEFAULT_HOST,
+        port != NULL && port[0] != '\0' ? port : GPSD_DEFAULT_PORT,
+        &gpsData
+    )) {
+        printf("[GPS] Open error\n");
+        return false;
+    }
+
+    (void)gps_stream(&gpsData, WATCH_ENABLE | WATCH_JSON, NULL);
+
+    if (addReactorFd(gpsData.gps_fd, EPOLLIN, onGpsSocketReadable, NULL) != 0) {
+        printf("[GPS] Failed to watch gpsd socket\n");
+        gps_stream(&gpsData, WATCH_DISABLE, NULL);
+        gps_close(&gpsData);
+        return false;
+    }
+
+    gpsSourceType = GPS_SOURCE_SOCKET;
+    printf("[GPS] Reading gpsd JSON socket\n");
+
+    return true;
+}
+
+GpsSourceType openGpsSource() {
+    const char *source = getenv("GPS_SOURCE");
+    const bool isSocketOnly = source != NULL && strcmp(source, "socket") == 0;
+    const bool isSharedMemoryOnly = source != NULL && strcmp(source, "shm") == 0;
+
+    if (!isSocketOnly && openGpsSharedMemory()) {
+        return gpsSourceType;
+    }
+
+    if (!isSharedMemoryOnly) {
+        openGpsSocket();
+    }
+
+    return gpsSourceType;
+}
+
+void pollGpsSource() {
+    if (gpsSourceType != GPS_SOURCE_SHARED_MEMORY) {
+        return;
+    }
+
+    if (gps_read(&gpsData, NULL, 0) > 0) {
+        handleGpsReport();
+    }
+}
+
+void closeGpsSource() {
+    switch (gpsSourceType) {
+        case GPS_SOURCE_SOCKET:
+            removeReactorFd(gpsData.gps_fd);
+            gps_stream(&gpsData, WATCH_DISABLE, NULL);
+            gps_close(&gpsData);
+            break;
+        case GPS_SOURCE_SHARED_MEMORY:
+            gps_close(&gpsData);
+            break;
+        default:
+            break;
+    }
+
+    gpsSourceType = GPS_SOURCE_NONE;
+}
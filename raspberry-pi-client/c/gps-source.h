@@ -0,0 +1,18 @@
+#ifndef GPS_SOURCE_H
+#define GPS_SOURCE_H
+
+#include <stdbool.h>
+
+#define GPSD_DEFAULT_HOST "localhost"
+#define GPSD_DEFAULT_PORT "2947"
+
+typedef enum {
+    GPS_SOURCE_NONE,
+    GPS_SOURCE_SHARED_MEMORY,
+    GPS_SOURCE_SOCKET
+} GpsSourceType;
+
+GpsSourceType openGpsSource();
+void pollGpsSource();
+void closeGpsSource();
+#endif
@@ -0,0 +1,210 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "imu-calibration.h"
+#include "mpu6050.h"
+
+#define IMU_CALIBRATION_FILE_HEADER "rc-car-imu-calibration v1"
+
+static float getEnvFloat(const char *name, const float defaultValue) {
+    const char *value = getenv(name);
+
+    if (value == NULL || value[0] == '\0') {
+        return defaultValue;
+    }
+
+    return strtof(value, NULL);
+}
+
+const char *getImuCalibrationPath() {
+    const char *path = getenv("IMU_CALIBRATION_PATH");
+
+    if (path == NULL || path[0] == '\0') {
+        return IMU_CALIBRATION_DEFAULT_PATH;
+    }
+
+    return path;
+}
+
+bool loadImuCalibration(const char *path, ImuCalibration *calibration) {
+    FILE *file = fopen(path, "r");
+    char header[64] = {0};
+    long calibratedAt = 0;
+
+    if (file == NULL) {
+        return false;
+    }
+
+    const bool isValid = fgets(header, sizeof(header), file) != NULL
+        && strncmp(header, IMU_CALIBRATION_FILE_HEADER, strlen(IMU_CALIBRATION_FILE_HEADER)) == 0
+        && fscanf(
+            file,
+            "%f %f %f %f %ld",
+            &calibration->gyroXOffset,
+            &calibration->gyroYOffset,
+            &calibration->gyroZOffset,
+            &calibration->temperature,
+            &calibratedAt
+        ) == 5;
+
+    fclose(file);
+
+    if (!isValid) {
+        printf("[MPU6050] Ignoring malformed calibration file %s\n", path);
+        return false;
+    }
+
+    calibration->calibratedAt = (time_t)calibratedAt;
+
+    return true;
+}
+
+bool saveImuCalibration(const char *path, const ImuCalibration *calibration) {
+    char temporaryPath[512];
+    snprintf(temporaryPath, sizeof(temporaryPath), "%s.tmp", path);
+
+    FILE *file = fopen(temporaryPath, "w");
+    if (file == NULL) {
+        perror("[MPU6050] Failed to save calibration");
+        return false;
+    }
+
+    fprintf(
+        file,
+        IMU_CALIBRATION_FILE_HEADER "\n%f %f %f %f %ld\n",
+        calibration->gyroXOffset,
+        calibration->gyroYOffset,
+        calibration->gyroZOffset,
+        calibration->temperature,
+        (long)calibration->calibratedAt
+    );
+
+    if (fclose(file) != 0 || rename(temporaryPath, path) != 0) {
+        perror("[MPU6050] Failed to save calibration");
+        return false;
+    }
+
+    return true;
+}
+
+static void sampleGyroBias(int handle, int samples, float *x, float *y, float *z) {
+    float sumX = 0.0f;
+    float sumY = 0.0f;
+    float sumZ = 0.0f;
+
+    for (int i = 0; i < samples; i++) {
+        sumX += readMPU6050Data(handle, GYRO_XOUT_H) / GYRO_SENSITIVITY;
+        sumY += readMPU6050Data(handle, GYRO_YOUT_H) / GYRO_SENSITIVITY;
+        sumZ += readMPU6050Data(handle, GYRO_ZOUT_H) / GYRO_SENSITIVITY;
+
+        if (i < samples - 1) {
+            usleep(IMU_CALIBRATION_SAMPLE_INTERVAL_US);
+        }
+    }
+
+    *x = sumX / samples;
+    *y = sumY / samples;
+    *z = sumZ / samples;
+}
+
+void calibrateMPU6050(int handle, int samples, ImuCalibration *calibration) {
+    printf("[MPU6050] Calibrating gyro...\n");
+
+    sampleGyroBias(handle, samples, &calibration->gyroXOffset, &calibration->gyroYOffset, &calibration->gyroZOffset);
+    calibration->temperature = readMPU6050Temperature(handle);
+    calibration->calibratedAt = time(NULL);
+
+    printf(
+        "[MPU6050] Gyro offsets X: %.2f Y: %.2f Z: %.2f at %.1f C\n",
+        calibration->gyroXOffset,
+        calibration->gyroYOffset,
+        calibration->gyroZOffset,
+        calibration->temperature
+    );
+}
+
+bool validateImuCalibration(int handle, const ImuCalibration *calibration) {
+    const float maxDrift = getEnvFloat("IMU_CALIBRATION_MAX_DRIFT", IMU_CALIBRATION_MAX_DRIFT);
+    const float temperature = readMPU6050Temperature(handle);
+    float x;
+    float y;
+    float z;
+
+    if (fabsf(temperature - calibration->temperature) > IMU_CALIBRATION_MAX_TEMPERATURE_DELTA) {
+        printf("[MPU6050] Cached calibration is stale: %.1f C vs %.1f C\n", temperature, calibration->temperature);
+        return false;
+    }
+
+    sampleGyroBias(handle, IMU_CALIBRATION_VALIDATION_SAMPLES, &x, &y, &z);
+
+    const float drift = fmaxf(
+        fabsf(x - calibration->gyroXOffset),
+        fmaxf(fabsf(y - calibration->gyroYOffset), fabsf(z - calibration->gyroZOffset))
+    );
+
+    if (drift > maxDrift) {
+        printf("[MPU6050] Cached calibration drifted by %.2f deg/s\n", drift);
+        return false;
+    }
+
+    return true;
+}
+
+bool activateImuCalibration(int handle, ImuCalibration *calibration) {
+    const char *path = getImuCalibrationPath();
+
+    if (loadImuCalibration(path, calibration) && validateImuCalibration(handle, calibration)) {
+        printf("[MPU6050] Using cached gyro Z offset: %.2f\n", calibration->gyroZOffset);
+        return true;
+    }
+
+    calibrateMPU6050(handle, IMU_CALIBRATION_FULL_SAMPLES, calibration);
+    saveImuCalibration(path, calibration);
+
+    return false;
+}
+
+void resetImuBiasEstimator(ImuBiasEstimator *estimator) {
+    memset(estimator, 0, sizeof(ImuBiasEstimator));
+}
+
+bool updateImuBiasEstimator(
+    ImuBiasEstimator *estimator,
+    ImuCalibration *calibration,
+    float rawGyroX,
+    float rawGyroY,
+    float rawGyroZ
+) {
+    const float stationaryRate = IMU_BACKGROUND_CALIBRATION_STATIONARY_RATE;
+
+    if (
+        fabsf(rawGyroX - calibration->gyroXOffset) > stationaryRate
+        || fabsf(rawGyroY - calibration->gyroYOffset) > stationaryRate
+        || fabsf(rawGyroZ - calibration->gyroZOffset) > stationaryRate
+    ) {
+        resetImuBiasEstimator(estimator);
+        return false;
+    }
+
+    estimator->sumX += rawGyroX;
+    estimator->sumY += rawGyroY;
+    estimator->sumZ += rawGyroZ;
+    estimator->samples++;
+
+    if (estimator->samples < IMU_BACKGROUND_CALIBRATION_SAMPLES) {
+        return false;
+    }
+
+    const float blend = IMU_BACKGROUND_CALIBRATION_BLEND;
+    const float previousZOffset = calibration->gyroZOffset;
+
+    calibration->gyroXOffset += ((float)(estimator->sumX / estimator->samples) - calibration->gyroXOffset) * blend;
+    calibration->gyroYOffset += ((float)(estimator->sumY / estimator->samples) - calibration->gyroYOffset) * blend;
+    calibration->gyroZOffset += ((float)(estimator->sumZ / estimator->samples) - calibration->gyroZOffset) * blend;
+    calibration->calibratedAt = time(NULL);
+    resetImuBiasEstimator(estimator);
+
+    return fabsf(calibration->gyroZOffset - previousZOffset) > IMU_BACKGROUND_CALIBRATION_SAVE_DELTA;
+}
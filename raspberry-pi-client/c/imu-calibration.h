@@ -0,0 +1,47 @@
+#ifndef IMU_CALIBRATION_H
+#define IMU_CALIBRATION_H
+
+#include <stdbool.h>
+#include <time.h>
+
+#define IMU_CALIBRATION_DEFAULT_PATH "imu-calibration.dat"
+#define IMU_CALIBRATION_FULL_SAMPLES 100
+#define IMU_CALIBRATION_VALIDATION_SAMPLES 5
+#define IMU_CALIBRATION_SAMPLE_INTERVAL_US 10000
+#define IMU_CALIBRATION_MAX_DRIFT 0.5f
+#define IMU_CALIBRATION_MAX_TEMPERATURE_DELTA 10.0f
+#define IMU_BACKGROUND_CALIBRATION_SAMPLES 250
+#define IMU_BACKGROUND_CALIBRATION_STATIONARY_RATE 1.0f
+#define IMU_BACKGROUND_CALIBRATION_BLEND 0.2f
+#define IMU_BACKGROUND_CALIBRATION_SAVE_DELTA 0.05f
+
+typedef struct {
+    float gyroXOffset;
+    float gyroYOffset;
+    float gyroZOffset;
+    float temperature;
+    time_t calibratedAt;
+} ImuCalibration;
+
+typedef struct {
+    double sumX;
+    double sumY;
+    double sumZ;
+    int samples;
+} ImuBiasEstimator;
+
+const char *getImuCalibrationPath();
+bool loadImuCalibration(const char *path, ImuCalibration *calibration);
+bool saveImuCalibration(const char *path, const ImuCalibration *calibration);
+void calibrateMPU6050(int handle, int samples, ImuCalibration *calibration);
+bool validateImuCalibration(int handle, const ImuCalibration *calibration);
+bool activateImuCalibration(int handle, ImuCalibration *calibration);
+void resetImuBiasEstimator(ImuBiasEstimator *estimator);
+bool updateImuBiasEstimator(
+    ImuBiasEstimator *estimator,
+    ImuCalibration *calibration,
+    float rawGyroX,
+    float rawGyroY,
+    float rawGyroZ
+);
+#endif
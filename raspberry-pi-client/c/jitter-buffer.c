@@ -0,0 +1,341 @@
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "jitter-buffer.h"
+#include "reactor.h"
+#include "telemetry.h"
+#include "transit-estimator.h"
+
+static JitterBufferCommand bufferedCommands[JITTER_BUFFER_CAPACITY];
+static int bufferedCount = 0;
+static JitterBufferPlayoutCallback playoutCallback = NULL;
+static int playoutTimerFd = -1;
+
+static int minDelayMs = JITTER_BUFFER_DEFAULT_MIN_DELAY_MS;
+static int maxDelayMs = JITTER_BUFFER_DEFAULT_MAX_DELAY_MS;
+static int extrapolateMs = JITTER_BUFFER_DEFAULT_EXTRAPOLATE_MS;
+
+static float jitterMs = 0.0f;
+static int delayMs = JITTER_BUFFER_DEFAULT_MIN_DELAY_MS;
+static long lastArrivalMs = -1;
+static long lastArrivalSentAtMs = 0;
+static TransitEstimator transitEstimator = {JITTER_BUFFER_TRANSIT_WINDOW_MS, LONG_MAX, LONG_MAX, 0};
+
+static long lastPlayedSentAtMs = LONG_MIN;
+static JitterBufferTrack tracks[JITTER_BUFFER_MAX_TRACKS];
+static int trackCount = 0;
+
+static unsigned long lateCommands = 0;
+static unsigned long extrapolatedCommands = 0;
+static long statsStartedAtMs = 0;
+
+static long nowMs() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000L + now.tv_nsec / 1000000L;
+}
+
+static int getJitterBufferSetting(const char *name, int fallback) {
+    const char *value = getenv(name);
+    return value != NULL && value[0] != '\0' && atoi(value) >= 0 ? atoi(value) : fallback;
+}
+
+static void updateJitterEstimate(long sentAtMs, long arrivalMs) {
+    updateTransitEstimator(&transitEstimator, sentAtMs, arrivalMs);
+
+    if (lastArrivalMs >= 0) {
+        const long deviation = (arrivalMs - lastArrivalMs) - (sentAtMs - lastArrivalSentAtMs);
+        jitterMs += ((float)labs(deviation) - jitterMs) / 16.0f;
+    }
+
+    lastArrivalMs = arrivalMs;
+    lastArrivalSentAtMs = sentAtMs;
+
+    delayMs = (int)lroundf(jitterMs * JITTER_BUFFER_JITTER_MULTIPLIER);
+    if (delayMs < minDelayMs) {
+        delayMs = minDelayMs;
+    }
+    if (delayMs > maxDelayMs) {
+        delayMs = maxDelayMs;
+    }
+
+    updateTelemetryCommandDelay(delayMs);
+}
+
+static long getExpectedIntervalMs(const JitterBufferTrack *track) {
+    long interval = track->historyCount == 2 ? track->history[1].sentAtMs - track->history[0].sentAtMs : JITTER_BUFFER_MAX_INTERVAL_MS;
+
+    if (interval < JITTER_BUFFER_MIN_INTERVAL_MS) {
+        interval = JITTER_BUFFER_MIN_INTERVAL_MS;
+    }
+    if (interval > JITTER_BUFFER_MAX_INTERVAL_MS) {
+        interval = JITTER_BUFFER_MAX_INTERVAL_MS;
+    }
+
+    return interval;
+}
+
+static bool isTrackExtrapolating(const JitterBufferTrack *track, long now) {
+    return track->historyCount == 2 && now < track->extrapolatedUntilMs;
+}
+
+static JitterBufferTrack *findJitterBufferTrack(int action) {
+    for (int i = 0; i < trackCount; i++) {
+        if (tracks[i].action == action) {
+            return &tracks[i];
+        }
+    }
+
+    if (trackCount == JITTER_BUFFER_MAX_TRACKS) {
+        return NULL;
+    }
+
+    JitterBufferTrack *track = &tracks[trackCount++];
+    memset(track, 0, sizeof(JitterBufferTrack));
+    track->action = action;
+
+    return track;
+}
+
+static void scheduleJitterBufferPlayout(long now) {
+    long delayUs = -1;
+
+    if (bufferedCount > 0) {
+        armReactorTimer(playoutTimerFd, (bufferedCommands[0].playoutAtMs - now) * 1000L);
+        return;
+    }
+
+    for (int i = 0; i < trackCount; i++) {
+        if (isTrackExtrapolating(&tracks[i], now) && (delayUs < 0 || getExpectedIntervalMs(&tracks[i]) * 1000L < delayUs)) {
+            delayUs = getExpectedIntervalMs(&tracks[i]) * 1000L;
+        }
+    }
+
+    if (delayUs >= 0) {
+        armReactorTimer(playoutTimerFd, delayUs);
+    }
+}
+
+static void playJitterBufferCommand(const JitterBufferCommand *command, long now) {
+    lastPlayedSentAtMs = command->sentAtMs;
+
+    if (command->isExtrapolatable) {
+        JitterBufferTrack *track = findJitterBufferTrack(command->action);
+
+        if (track != NULL) {
+            track->history[0] = track->history[1];
+            track->history[1] = *command;
+            if (track->historyCount < 2) {
+                track->historyCount++;
+            }
+            track->playedAtMs = now;
+            track->extrapolatedUntilMs = now + extrapolateMs + getExpectedIntervalMs(track);
+        }
+    }
+
+    playoutCallback(command->action, command->value);
+}
+
+static void extrapolateJitterBuffer(JitterBufferTrack *track, long now) {
+    const JitterBufferCommand *previous = &track->history[0];
+    const JitterBufferCommand *last = &track->history[1];
+    const long span = last->sentAtMs - previous->sentAtMs;
+    long elapsed = now - track->playedAtMs;
+
+    if (span <= 0) {
+        return;
+    }
+
+    if (elapsed > extrapolateMs) {
+        elapsed = extrapolateMs;
+    }
+
+    extrapolatedCommands++;
+    playoutCallback(last->action, last->value + (last->value - previous->value) * (float)elapsed / (float)span);
+}
+
+static void playBufferedCommands(long sentAtMs, long now) {
+    int played = 0;
+
+    while (played < bufferedCount && bufferedCommands[played].sentAtMs <= sentAtMs) {
+        playJitterBufferCommand(&bufferedCommands[played], now);
+        played++;
+    }
+
+    bufferedCount -= played;
+    memmove(bufferedCommands, bufferedCommands + played, sizeof(JitterBufferCommand) * bufferedCount);
+}
+
+static void resetJitterBufferTiming(long now) {
+    playBufferedCommands(LONG_MAX, now);
+
+    jitterMs = 0.0f;
+    delayMs = minDelayMs;
+    lastArrivalMs = -1;
+    lastArrivalSentAtMs = 0;
+    resetTransitEstimator(&transitEstimator, JITTER_BUFFER_TRANSIT_WINDOW_MS, now);
+    lastPlayedSentAtMs = LONG_MIN;
+    trackCount = 0;
+}
+
+static void detectJitterBufferClockJump(long sentAtMs, long now) {
+    if (lastArrivalMs < 0) {
+        return;
+    }
+
+    const long deviation = (now - lastArrivalMs) - (sentAtMs - lastArrivalSentAtMs);
+
+    if (labs(deviation) > JITTER_BUFFER_TRANSIT_WINDOW_MS) {
+        printf("[JitterBuffer] Controller clock jumped by %ld ms, resetting\n", -deviation);
+        resetJitterBufferTiming(now);
+    }
+}
+
+static void reportJitterBufferStats(long now) {
+    if (now - statsStartedAtMs < JITTER_BUFFER_STATS_INTERVAL_MS) {
+        return;
+    }
+
+    printf(
+        "[JitterBuffer] delay %d ms, jitter %.1f ms, late %lu, extrapolated %lu\n",
+        delayMs,
+        jitterMs,
+        lateCommands,
+        extrapolatedCommands
+    );
+
+    lateCommands = 0;
+    extrapolatedCommands = 0;
+    statsStartedAtMs = now;
+}
+
+static void onJitterBufferPlayout(int fd, uint32_t events, void *arg) {
+    const long now = nowMs();
+    int played = 0;
+
+    while (played < bufferedCount && bufferedCommands[played].playoutAtMs <= now) {
+        playJitterBufferCommand(&bufferedCommands[played], now);
+        played++;
+    }
+
+    if (played > 0) {
+        bufferedCount -= played;
+        memmove(bufferedCommands, bufferedCommands + played, sizeof(JitterBufferCommand) * bufferedCount);
+    } else if (bufferedCount == 0) {
+        for (int i = 0; i < trackCount; i++) {
+            if (isTrackExtrapolating(&tracks[i], now) && now - tracks[i].playedAtMs >= getExpectedIntervalMs(&tracks[i])) {
+                extrapolateJitterBuffer(&tracks[i], now);
+            }
+        }
+    }
+
+    reportJitterBufferStats(now);
+    scheduleJitterBufferPlayout(now);
+}
+
+void pushJitterBufferCommand(long sentAtMs, int action, float value, bool isExtrapolatable) {
+    const long now = nowMs();
+    JitterBufferCommand command;
+
+    detectJitterBufferClockJump(sentAtMs, now);
+    updateJitterEstimate(sentAtMs, now);
+
+    if (sentAtMs <= lastPlayedSentAtMs) {
+        lateCommands++;
+        return;
+    }
+
+    if (bufferedCount == JITTER_BUFFER_CAPACITY) {
+        playJitterBufferCommand(&bufferedCommands[0], now);
+        bufferedCount--;
+        memmove(bufferedCommands, bufferedCommands + 1, sizeof(JitterBufferCommand) * bufferedCount);
+    }
+
+    command.sentAtMs = sentAtMs;
+    command.playoutAtMs = sentAtMs + getTransitEstimatorBaseMs(&transitEstimator) + delayMs;
+    command.action = action;
+    command.value = value;
+    command.isExtrapolatable = isExtrapolatable;
+
+    int index = bufferedCount;
+    while (index > 0 && bufferedCommands[index - 1].sentAtMs > sentAtMs) {
+        bufferedCommands[index] = bufferedCommands[index - 1];
+        index--;
+    }
+    bufferedCommands[index] = command;
+    bufferedCount++;
+
+    if (index == 0) {
+        scheduleJitterBufferPlayout(now);
+    }
+}
+
+void flushJitterBuffer(long sentAtMs) {
+    const long now = nowMs();
+
+    detectJitterBufferClockJump(sentAtMs, now);
+    updateJitterEstimate(sentAtMs, now);
+    playBufferedCommands(sentAtMs, now);
+
+    if (sentAtMs > lastPlayedSentAtMs) {
+        lastPlayedSentAtMs = sentAtMs;
+    }
+    scheduleJitterBufferPlayout(now);
+}
+
+void resetJitterBuffer() {
+    if (playoutTimerFd >= 0) {
+        resetJitterBufferTiming(nowMs());
+    }
+}
+
+bool isJitterBufferEnabled() {
+    return playoutTimerFd >= 0;
+}
+
+int getJitterBufferDelayMs() {
+    return delayMs;
+}
+
+int startJitterBuffer(JitterBufferPlayoutCallback callback) {
+    const char *isEnabled = getenv("JITTER_BUFFER");
+
+    if (isEnabled == NULL || strcmp(isEnabled, "1") != 0) {
+        return -1;
+    }
+
+    minDelayMs = getJitterBufferSetting("JITTER_BUFFER_MIN_DELAY_MS", JITTER_BUFFER_DEFAULT_MIN_DELAY_MS);
+    maxDelayMs = getJitterBufferSetting("JITTER_BUFFER_MAX_DELAY_MS", JITTER_BUFFER_DEFAULT_MAX_DELAY_MS);
+    extrapolateMs = getJitterBufferSetting("JITTER_BUFFER_EXTRAPOLATE_MS", JITTER_BUFFER_DEFAULT_EXTRAPOLATE_MS);
+    if (maxDelayMs < minDelayMs) {
+        maxDelayMs = minDelayMs;
+    }
+
+    playoutCallback = callback;
+    delayMs = minDelayMs;
+    statsStartedAtMs = nowMs();
+    resetTransitEstimator(&transitEstimator, JITTER_BUFFER_TRANSIT_WINDOW_MS, statsStartedAtMs);
+
+    playoutTimerFd = addReactorTimer(0, onJitterBufferPlayout, NULL);
+    if (playoutTimerFd < 0) {
+        printf("[JitterBuffer] Failed to create playout timer\n");
+        return -1;
+    }
+
+    printf("[JitterBuffer] Buffering commands with %d-%d ms adaptive delay\n", minDelayMs, maxDelayMs);
+
+    return 0;
+}
+
+void stopJitterBuffer() {
+    if (playoutTimerFd < 0) {
+        return;
+    }
+
+    removeReactorTimer(playoutTimerFd);
+    playoutTimerFd = -1;
+    bufferedCount = 0;
+}
@@ -0,0 +1,42 @@
+#ifndef JITTER_BUFFER_H
+#define JITTER_BUFFER_H
+
+#include <stdbool.h>
+
+#define JITTER_BUFFER_CAPACITY 32
+#define JITTER_BUFFER_DEFAULT_MIN_DELAY_MS 5
+#define JITTER_BUFFER_DEFAULT_MAX_DELAY_MS 120
+#define JITTER_BUFFER_DEFAULT_EXTRAPOLATE_MS 60
+#define JITTER_BUFFER_JITTER_MULTIPLIER 3.0f
+#define JITTER_BUFFER_TRANSIT_WINDOW_MS 2000
+#define JITTER_BUFFER_MIN_INTERVAL_MS 10
+#define JITTER_BUFFER_MAX_INTERVAL_MS 50
+#define JITTER_BUFFER_STATS_INTERVAL_MS 10000
+#define JITTER_BUFFER_MAX_TRACKS 4
+
+typedef void (*JitterBufferPlayoutCallback)(int action, float value);
+
+typedef struct {
+    long sentAtMs;
+    long playoutAtMs;
+    int action;
+    float value;
+    bool isExtrapolatable;
+} JitterBufferCommand;
+
+typedef struct {
+    int action;
+    JitterBufferCommand history[2];
+    int historyCount;
+    long playedAtMs;
+    long extrapolatedUntilMs;
+} JitterBufferTrack;
+
+int startJitterBuffer(JitterBufferPlayoutCallback callback);
+void stopJitterBuffer();
+bool isJitterBufferEnabled();
+void pushJitterBufferCommand(long sentAtMs, int action, float value, bool isExtrapolatable);
+void flushJitterBuffer(long sentAtMs);
+void resetJitterBuffer();
+int getJitterBufferDelayMs();
+#endif
@@ -0,0 +1,143 @@
+#include <fcntl.h>
+#include <pigpio.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "mpu6050.h"
+
+static Mpu6050RegisterSegment *simulatedSegment = NULL;
+static int simulatedOpenCount = 0;
+
+static int openSimulatedMPU6050(const char *name) {
+    if (simulatedSegment == NULL) {
+        const int fd = shm_open(name, O_RDONLY, 0);
+        if (fd < 0) {
+            printf("[MPU6050] Simulated registers %s are not available\n", name);
+            return -1;
+        }
+
+        void *mapping = mmap(NULL, sizeof(Mpu6050RegisterSegment), PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+
+        if (mapping == MAP_FAILED || ((Mpu6050RegisterSegment *)mapping)->magic != MPU6050_SIMULATED_MAGIC) {
+            printf("[MPU6050] Simulated registers %s are malformed\n", name);
+            if (mapping != MAP_FAILED) {
+                munmap(mapping, sizeof(Mpu6050RegisterSegment));
+            }
+            return -1;
+        }
+
+        simulatedSegment = (Mpu6050RegisterSegment *)mapping;
+        printf("[MPU6050] Reading simulated registers from %s\n", name);
+    }
+
+    simulatedOpenCount++;
+
+    return MPU6050_SIMULATED_HANDLE;
+}
+
+static int readSimulatedMPU6050Block(int reg, uint8_t *buffer, int count) {
+    _Atomic uint32_t *sequence = (_Atomic uint32_t *)&simulatedSegment->sequence;
+    const volatile uint8_t *registers = simulatedSegment->registers;
+
+    for (int attempt = 0; attempt < MPU6050_SIMULATED_READ_RETRIES; attempt++) {
+        const uint32_t before = atomic_load_explicit(sequence, memory_order_acquire);
+
+        if (before & 1u) {
+            continue;
+        }
+
+        for (int i = 0; i < count; i++) {
+            buffer[i] = registers[reg + i];
+        }
+        atomic_thread_fence(memory_order_acquire);
+
+        if (atomic_load_explicit(sequence, memory_order_relaxed) == before) {
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+int openMPU6050() {
+    const char *simulated = getenv("MPU6050_SIM");
+
+    if (simulated != NULL && simulated[0] != '\0') {
+        return openSimulatedMPU6050(simulated);
+    }
+
+    const int handle = i2cOpen(MPU6050_I2C_BUS, MPU6050_ADDRESS, 0);
+
+    if (handle < 0) {
+        printf("[MPU6050] Failed to open I2C connection\n");
+        return -1;
+    }
+
+    initMPU6050(handle);
+
+    return handle;
+}
+
+void initMPU6050(int handle) {
+    if (handle == MPU6050_SIMULATED_HANDLE) {
+        return;
+    }
+
+    i2cWriteByteData(handle, MPU6050_PWR_MGMT_1, 0x00);
+    usleep(MPU6050_WAKE_UP_DELAY_US);
+}
+
+void deinitMPU6050(int handle) {
+    if (handle != MPU6050_SIMULATED_HANDLE) {
+        i2cClose(handle);
+        return;
+    }
+
+    if (--simulatedOpenCount == 0) {
+        munmap(simulatedSegment, sizeof(Mpu6050RegisterSegment));
+        simulatedSegment = NULL;
+    }
+}
+
+short readMPU6050Data(int handle, int reg) {
+    if (handle == MPU6050_SIMULATED_HANDLE) {
+        uint8_t buffer[2];
+        if (readSimulatedMPU6050Block(reg, buffer, 2) != 0) {
+            return 0;
+        }
+        return (short)((buffer[0] << 8) | buffer[1]);
+    }
+
+    int high = i2cReadByteData(handle, reg);
+    int low = i2cReadByteData(handle, reg + 1);
+    return (short)((high << 8) | low);
+}
+
+float readMPU6050Temperature(int handle) {
+    return readMPU6050Data(handle, TEMP_OUT_H) / 340.0f + 36.53f;
+}
+
+int readMPU6050Motion(int handle, Mpu6050Motion *motion) {
+    uint8_t buffer[MPU6050_MOTION_SIZE];
+
+    if (handle == MPU6050_SIMULATED_HANDLE) {
+        if (readSimulatedMPU6050Block(ACCEL_XOUT_H, buffer, MPU6050_MOTION_SIZE) != 0) {
+            return -1;
+        }
+    } else if (i2cReadI2CBlockData(handle, ACCEL_XOUT_H, (char *)buffer, MPU6050_MOTION_SIZE) != MPU6050_MOTION_SIZE) {
+        return -1;
+    }
+
+    motion->accelX = (short)((buffer[0] << 8) | buffer[1]);
+    motion->accelY = (short)((buffer[2] << 8) | buffer[3]);
+    motion->accelZ = (short)((buffer[4] << 8) | buffer[5]);
+    motion->temperature = (short)((buffer[6] << 8) | buffer[7]);
+    motion->gyroX = (short)((buffer[8] << 8) | buffer[9]);
+    motion->gyroY = (short)((buffer[10] << 8) | buffer[11]);
+    motion->gyroZ = (short)((buffer[12] << 8) | buffer[13]);
+
+    return 0;
+}
@@ -0,0 +1,47 @@
+#ifndef MPU6050_H
+#define MPU6050_H
+
+#include <stdint.h>
+
+#define MPU6050_ADDRESS 0x68
+#define MPU6050_I2C_BUS 1
+#define MPU6050_PWR_MGMT_1 0x6B
+#define MPU6050_WAKE_UP_DELAY_US 30000
+#define ACCEL_XOUT_H 0x3B
+#define ACCEL_YOUT_H 0x3D
+#define ACCEL_ZOUT_H 0x3F
+#define TEMP_OUT_H 0x41
+#define GYRO_XOUT_H 0x43
+#define GYRO_YOUT_H 0x45
+#define GYRO_ZOUT_H 0x47
+#define GYRO_SENSITIVITY 131.0
+#define ACCEL_SENSITIVITY 16384.0
+#define MPU6050_REGISTER_COUNT 128
+#define MPU6050_SIMULATED_HANDLE 0x5100
+#define MPU6050_SIMULATED_MAGIC 0x4d505553u
+#define MPU6050_SIMULATED_READ_RETRIES 1000
+#define MPU6050_MOTION_SIZE 14
+
+typedef struct {
+    uint32_t magic;
+    uint32_t sequence;
+    uint8_t registers[MPU6050_REGISTER_COUNT];
+} Mpu6050RegisterSegment;
+
+typedef struct {
+    short accelX;
+    short accelY;
+    short accelZ;
+    short temperature;
+    short gyroX;
+    short gyroY;
+    short gyroZ;
+} Mpu6050Motion;
+
+int openMPU6050();
+void initMPU6050(int handle);
+void deinitMPU6050(int handle);
+short readMPU6050Data(int handle, int reg);
+float readMPU6050Temperature(int handle);
+int readMPU6050Motion(int handle, Mpu6050Motion *motion);
+#endif
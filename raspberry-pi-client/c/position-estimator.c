@@ -0,0 +1,177 @@
+#include <math.h>
+#include <string.h>
+#include "position-estimator.h"
+
+#define N POSITION_ESTIMATOR_STATE_SIZE
+#define P(estimator, row, column) ((estimator)->covariance[(row) * N + (column)])
+#define DEGREES_TO_RADIANS(value) ((value) * (float)M_PI / 180.0f)
+#define RADIANS_TO_DEGREES(value) ((value) * 180.0f / (float)M_PI)
+
+static float wrapAngle(float angle) {
+    while (angle > (float)M_PI) {
+        angle -= 2.0f * (float)M_PI;
+    }
+    while (angle < -(float)M_PI) {
+        angle += 2.0f * (float)M_PI;
+    }
+    return angle;
+}
+
+void resetPositionEstimator(PositionEstimator *estimator) {
+    memset(estimator, 0, sizeof(PositionEstimator));
+}
+
+static void initializePositionEstimator(PositionEstimator *estimator, double latitude, double longitude, float speed) {
+    resetPositionEstimator(estimator);
+    estimator->isInitialized = true;
+    estimator->originLatitude = latitude;
+    estimator->originLongitude = longitude;
+    estimator->metersPerDegreeLongitude = POSITION_ESTIMATOR_EARTH_RADIUS * M_PI / 180.0 * cos(latitude * M_PI / 180.0);
+    estimator->state[ESTIMATE_SPEED] = speed;
+
+    P(estimator, ESTIMATE_X, ESTIMATE_X) = POSITION_ESTIMATOR_GPS_POSITION_NOISE * POSITION_ESTIMATOR_GPS_POSITION_NOISE;
+    P(estimator, ESTIMATE_Y, ESTIMATE_Y) = POSITION_ESTIMATOR_GPS_POSITION_NOISE * POSITION_ESTIMATOR_GPS_POSITION_NOISE;
+    P(estimator, ESTIMATE_HEADING, ESTIMATE_HEADING) = (float)(M_PI * M_PI);
+    P(estimator, ESTIMATE_SPEED, ESTIMATE_SPEED) = POSITION_ESTIMATOR_GPS_SPEED_NOISE * POSITION_ESTIMATOR_GPS_SPEED_NOISE;
+}
+
+void predictPositionEstimator(PositionEstimator *estimator, float yawRate, float forwardAcceleration, float dt) {
+    if (!estimator->isInitialized || dt <= 0.0f) {
+        return;
+    }
+
+    float *x = estimator->state;
+    const float heading = x[ESTIMATE_HEADING];
+    const float speed = x[ESTIMATE_SPEED];
+    const float cosHeading = cosf(heading);
+    const float sinHeading = sinf(heading);
+
+    x[ESTIMATE_X] += speed * cosHeading * dt;
+    x[ESTIMATE_Y] += speed * sinHeading * dt;
+    x[ESTIMATE_HEADING] = wrapAngle(heading + DEGREES_TO_RADIANS(yawRate) * dt);
+    x[ESTIMATE_SPEED] = fmaxf(0.0f, speed + forwardAcceleration * dt);
+
+    float f[N * N] = {
+        1, 0, -speed * sinHeading * dt, cosHeading * dt,
+        0, 1, speed * cosHeading * dt, sinHeading * dt,
+        0, 0, 1, 0,
+        0, 0, 0, 1
+    };
+    float fp[N * N];
+    float next[N * N];
+
+    for (int row = 0; row < N; row++) {
+        for (int column = 0; column < N; column++) {
+            float sum = 0.0f;
+            for (int k = 0; k < N; k++) {
+                sum += f[row * N + k] * P(estimator, k, column);
+            }
+            fp[row * N + column] = sum;
+        }
+    }
+
+    for (int row = 0; row < N; row++) {
+        for (int column = 0; column < N; column++) {
+            float sum = 0.0f;
+            for (int k = 0; k < N; k++) {
+                sum += fp[row * N + k] * f[column * N + k];
+            }
+            next[row * N + column] = sum;
+        }
+    }
+
+    const float gyroNoise = DEGREES_TO_RADIANS(POSITION_ESTIMATOR_GYRO_NOISE) * dt;
+    const float accelNoise = POSITION_ESTIMATOR_ACCEL_NOISE * dt;
+    next[ESTIMATE_HEADING * N + ESTIMATE_HEADING] += gyroNoise * gyroNoise + 1e-5f * dt;
+    next[ESTIMATE_SPEED * N + ESTIMATE_SPEED] += accelNoise * accelNoise;
+
+    memcpy(estimator->covariance, next, sizeof(next));
+}
+
+static void applyScalarMeasurement(PositionEstimator *estimator, PositionEstimateState index, float innovation, float noise) {
+    float gain[N];
+    const float innovationVariance = P(estimator, index, index) + noise * noise;
+
+    if (innovationVariance <= 0.0f) {
+        return;
+    }
+
+    for (int row = 0; row < N; row++) {
+        gain[row] = P(estimator, row, index) / innovationVariance;
+    }
+
+    for (int row = 0; row < N; row++) {
+        estimator->state[row] += gain[row] * innovation;
+    }
+    estimator->state[ESTIMATE_HEADING] = wrapAngle(estimator->state[ESTIMATE_HEADING]);
+    estimator->state[ESTIMATE_SPEED] = fmaxf(0.0f, estimator->state[ESTIMATE_SPEED]);
+
+    float row[N];
+    for (int column = 0; column < N; column++) {
+        row[column] = P(estimator, index, column);
+    }
+
+    for (int i = 0; i < N; i++) {
+        for (int column = 0; column < N; column++) {
+            P(estimator, i, column) -= gain[i] * row[column];
+        }
+    }
+}
+
+void updatePositionEstimatorWithGps(
+    PositionEstimator *estimator,
+    double latitude,
+    double longitude,
+    float speed,
+    float track,
+    bool hasTrack
+) {
+    if (!estimator->isInitialized) {
+        initializePositionEstimator(estimator, latitude, longitude, speed);
+        if (hasTrack && speed >= POSITION_ESTIMATOR_MIN_TRACK_SPEED) {
+            estimator->state[ESTIMATE_HEADING] = wrapAngle(DEGREES_TO_RADIANS(90.0f - track));
+            P(estimator, ESTIMATE_HEADING, ESTIMATE_HEADING) = POSITION_ESTIMATOR_GPS_TRACK_NOISE * POSITION_ESTIMATOR_GPS_TRACK_NOISE;
+        }
+        return;
+    }
+
+    const float x = (float)((longitude - estimator->originLongitude) * estimator->metersPerDegreeLongitude);
+    const float y = (float)((latitude - estimator->originLatitude) * POSITION_ESTIMATOR_EARTH_RADIUS * M_PI / 180.0);
+
+    applyScalarMeasurement(estimator, ESTIMATE_X, x - estimator->state[ESTIMATE_X], POSITION_ESTIMATOR_GPS_POSITION_NOISE);
+    applyScalarMeasurement(estimator, ESTIMATE_Y, y - estimator->state[ESTIMATE_Y], POSITION_ESTIMATOR_GPS_POSITION_NOISE);
+    applyScalarMeasurement(estimator, ESTIMATE_SPEED, speed - estimator->state[ESTIMATE_SPEED], POSITION_ESTIMATOR_GPS_SPEED_NOISE);
+
+    if (hasTrack && speed >= POSITION_ESTIMATOR_MIN_TRACK_SPEED) {
+        const float heading = DEGREES_TO_RADIANS(90.0f - track);
+        applyScalarMeasurement(
+            estimator,
+            ESTIMATE_HEADING,
+            wrapAngle(heading - estimator->state[ESTIMATE_HEADING]),
+            POSITION_ESTIMATOR_GPS_TRACK_NOISE
+        );
+    }
+}
+
+bool getPositionEstimate(const PositionEstimator *estimator, PositionEstimate *estimate) {
+    if (!estimator->isInitialized) {
+        return false;
+    }
+
+    float heading = 90.0f - RADIANS_TO_DEGREES(estimator->state[ESTIMATE_HEADING]);
+    if (heading < 0.0f) {
+        heading += 360.0f;
+    }
+    if (heading >= 360.0f) {
+        heading -= 360.0f;
+    }
+
+    estimate->latitude = estimator->originLatitude + estimator->state[ESTIMATE_Y] / (POSITION_ESTIMATOR_EARTH_RADIUS * M_PI / 180.0);
+    estimate->longitude = estimator->originLongitude + estimator->state[ESTIMATE_X] / estimator->metersPerDegreeLongitude;
+    estimate->heading = heading;
+    estimate->speed = estimator->state[ESTIMATE_SPEED];
+    estimate->positionStdDev = sqrtf(fmaxf(0.0f, P(estimator, ESTIMATE_X, ESTIMATE_X) + P(estimator, ESTIMATE_Y, ESTIMATE_Y)));
+    estimate->headingStdDev = RADIANS_TO_DEGREES(sqrtf(fmaxf(0.0f, P(estimator, ESTIMATE_HEADING, ESTIMATE_HEADING))));
+
+    return true;
+}
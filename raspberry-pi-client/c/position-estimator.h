@@ -0,0 +1,52 @@
+#ifndef POSITION_ESTIMATOR_H
+#define POSITION_ESTIMATOR_H
+
+#include <stdbool.h>
+
+#define POSITION_ESTIMATOR_RATE_HZ 50
+#define POSITION_ESTIMATOR_STATE_SIZE 4
+#define POSITION_ESTIMATOR_EARTH_RADIUS 6371000.0
+#define POSITION_ESTIMATOR_GYRO_NOISE 0.02f
+#define POSITION_ESTIMATOR_ACCEL_NOISE 0.5f
+#define POSITION_ESTIMATOR_GPS_POSITION_NOISE 2.5f
+#define POSITION_ESTIMATOR_GPS_SPEED_NOISE 0.3f
+#define POSITION_ESTIMATOR_GPS_TRACK_NOISE 0.15f
+#define POSITION_ESTIMATOR_MIN_TRACK_SPEED 1.0f
+
+typedef enum {
+    ESTIMATE_X,
+    ESTIMATE_Y,
+    ESTIMATE_HEADING,
+    ESTIMATE_SPEED
+} PositionEstimateState;
+
+typedef struct {
+    bool isInitialized;
+    double originLatitude;
+    double originLongitude;
+    double metersPerDegreeLongitude;
+    float state[POSITION_ESTIMATOR_STATE_SIZE];
+    float covariance[POSITION_ESTIMATOR_STATE_SIZE * POSITION_ESTIMATOR_STATE_SIZE];
+} PositionEstimator;
+
+typedef struct {
+    double latitude;
+    double longitude;
+    float heading;
+    float speed;
+    float positionStdDev;
+    float headingStdDev;
+} PositionEstimate;
+
+void resetPositionEstimator(PositionEstimator *estimator);
+void predictPositionEstimator(PositionEstimator *estimator, float yawRate, float forwardAcceleration, float dt);
+void updatePositionEstimatorWithGps(
+    PositionEstimator *estimator,
+    double latitude,
+    double longitude,
+    float speed,
+    float track,
+    bool hasTrack
+);
+bool getPositionEstimate(const PositionEstimator *estimator, PositionEstimate *estimate);
+#endif
@@ -0,0 +1,105 @@
+#include <math.h>
+#include <string.h>
+#include "pure-pursuit.h"
+
+#define DEGREES_TO_RADIANS(degrees) ((degrees) * (float)M_PI / 180.0f)
+#define RADIANS_TO_DEGREES(radians) ((radians) * 180.0f / (float)M_PI)
+
+typedef struct {
+    float x;
+    float y;
+} LocalPoint;
+
+void initPurePursuitConfig(PurePursuitConfig *config) {
+    config->wheelbase = PURE_PURSUIT_DEFAULT_WHEELBASE_M;
+    config->lookaheadGain = PURE_PURSUIT_DEFAULT_LOOKAHEAD_GAIN_S;
+    config->minLookahead = PURE_PURSUIT_DEFAULT_MIN_LOOKAHEAD_M;
+    config->acceptanceRadius = PURE_PURSUIT_DEFAULT_ACCEPTANCE_RADIUS_M;
+    config->maxSteeringAngle = PURE_PURSUIT_DEFAULT_MAX_STEERING_DEGREES;
+}
+
+void resetPurePursuitPath(PurePursuitPath *path, const Waypoint *start, const Waypoint *waypoints, int count) {
+    if (count > PURE_PURSUIT_MAX_WAYPOINTS) {
+        count = PURE_PURSUIT_MAX_WAYPOINTS;
+    }
+
+    path->waypoints[0] = *start;
+    memcpy(&path->waypoints[1], waypoints, sizeof(Waypoint) * count);
+    path->count = count + 1;
+    path->targetIndex = 1;
+}
+
+static LocalPoint toLocalPoint(const Waypoint *waypoint, const PositionEstimate *origin) {
+    const double metersPerDegreeLatitude = POSITION_ESTIMATOR_EARTH_RADIUS * M_PI / 180.0;
+    const double metersPerDegreeLongitude = metersPerDegreeLatitude * cos(origin->latitude * M_PI / 180.0);
+    LocalPoint point;
+
+    point.x = (float)((waypoint->longitude - origin->longitude) * metersPerDegreeLongitude);
+    point.y = (float)((waypoint->latitude - origin->latitude) * metersPerDegreeLatitude);
+
+    return point;
+}
+
+static bool findLookaheadPoint(LocalPoint from, LocalPoint to, float lookahead, LocalPoint *point) {
+    const float dx = to.x - from.x;
+    const float dy = to.y - from.y;
+    const float a = dx * dx + dy * dy;
+    const float b = 2.0f * (from.x * dx + from.y * dy);
+    const float c = from.x * from.x + from.y * from.y - lookahead * lookahead;
+    const float discriminant = b * b - 4.0f * a * c;
+
+    if (a <= 0.0f || discriminant < 0.0f) {
+        return false;
+    }
+
+    const float t = (-b + sqrtf(discriminant)) / (2.0f * a);
+    if (t < 0.0f || t > 1.0f) {
+        return false;
+    }
+
+    point->x = from.x + t * dx;
+    point->y = from.y + t * dy;
+
+    return true;
+}
+
+bool computePurePursuitSteering(PurePursuitPath *path, const PurePursuitConfig *config, const PositionEstimate *estimate, float *steeringAngle) {
+    while (path->targetIndex < path->count) {
+        const LocalPoint target = toLocalPoint(&path->waypoints[path->targetIndex], estimate);
+
+        if (hypotf(target.x, target.y) > config->acceptanceRadius) {
+            break;
+        }
+        path->targetIndex++;
+    }
+
+    if (path->targetIndex >= path->count) {
+        *steeringAngle = 0.0f;
+        return false;
+    }
+
+    const float lookahead = fmaxf(config->minLookahead, config->lookaheadGain * estimate->speed);
+    LocalPoint aim = toLocalPoint(&path->waypoints[path->targetIndex], estimate);
+
+    for (int i = path->targetIndex; i < path->count; i++) {
+        if (findLookaheadPoint(toLocalPoint(&path->waypoints[i - 1], estimate), toLocalPoint(&path->waypoints[i], estimate), lookahead, &aim)) {
+            break;
+        }
+    }
+
+    const float distance = fmaxf(hypotf(aim.x, aim.y), 0.01f);
+    const float alpha = atan2f(aim.x, aim.y) - DEGREES_TO_RADIANS(estimate->heading);
+    const float curvature = 2.0f * sinf(alpha) / distance;
+    float angle = -RADIANS_TO_DEGREES(atanf(config->wheelbase * curvature));
+
+    if (angle > config->maxSteeringAngle) {
+        angle = config->maxSteeringAngle;
+    }
+    if (angle < -config->maxSteeringAngle) {
+        angle = -config->maxSteeringAngle;
+    }
+
+    *steeringAngle = angle;
+
+    return true;
+}
@@ -0,0 +1,36 @@
+#ifndef PURE_PURSUIT_H
+#define PURE_PURSUIT_H
+
+#include <stdbool.h>
+#include "position-estimator.h"
+
+#define PURE_PURSUIT_MAX_WAYPOINTS 64
+#define PURE_PURSUIT_DEFAULT_WHEELBASE_M 0.26f
+#define PURE_PURSUIT_DEFAULT_LOOKAHEAD_GAIN_S 0.8f
+#define PURE_PURSUIT_DEFAULT_MIN_LOOKAHEAD_M 1.5f
+#define PURE_PURSUIT_DEFAULT_ACCEPTANCE_RADIUS_M 2.0f
+#define PURE_PURSUIT_DEFAULT_MAX_STEERING_DEGREES 30.0f
+
+typedef struct {
+    double latitude;
+    double longitude;
+} Waypoint;
+
+typedef struct {
+    float wheelbase;
+    float lookaheadGain;
+    float minLookahead;
+    float acceptanceRadius;
+    float maxSteeringAngle;
+} PurePursuitConfig;
+
+typedef struct {
+    Waypoint waypoints[PURE_PURSUIT_MAX_WAYPOINTS + 1];
+    int count;
+    int targetIndex;
+} PurePursuitPath;
+
+void initPurePursuitConfig(PurePursuitConfig *config);
+void resetPurePursuitPath(PurePursuitPath *path, const Waypoint *start, const Waypoint *waypoints, int count);
+bool computePurePursuitSteering(PurePursuitPath *path, const PurePursuitConfig *config, const PositionEstimate *estimate, float *steeringAngle);
+#endif
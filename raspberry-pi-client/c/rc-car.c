@@ -1,127 +1,85 @@
 #include <cjson/cJSON.h>
 #include <math.h>
 #include <pigpio.h>
+#include <pthread.h>
 #include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include "stdbool.h"
-#include <sys/types.h>
-#include <sys/wait.h>
 #include <unistd.h>
 
+#include "camera.h"
+#include "car-command.h"
+#include "control-state.h"
+#include "flight-recorder.h"
+#include "gimbal-stabilizer.h"
+#include "imu-calibration.h"
+#include "jitter-buffer.h"
+#include "json-arena.h"
+#include "mpu6050.h"
 #include "rc-car.h"
+#include "speed-governor.h"
+#include "state-bus.h"
+#include "telemetry.h"
+#include "trajectory.h"
+#include "waypoint-follower.h"
 #include "websocket.h"
 
-pid_t mediaMtxPid = -1;
+typedef struct {
+  int handle;
+  bool isBackgroundImuCalibrationEnabled;
+  ImuCalibration calibration;
+  ImuBiasEstimator biasEstimator;
+} SteeringWheelCorrection;
 
-float gyroZOffset = 0.0;
+SteeringWheelCorrection steeringWheelCorrection = {-1, false, {0}, {0}};
+bool isSteeringWheelCorrectionRunning = false;
 float scalingFactor = 15.0;
 float deadZone = 0.5;
 int MPU6050Handle = -1;
 
-bool isCarTurning = false;
-float correctionAngle = 0.0;
-float previousCorrectionAngle = 0.0;
-pthread_mutex_t steeringWheelCorrectionMutex = PTHREAD_MUTEX_INITIALIZER;
 pthread_t steeringWheelCorrectionThreadHandle;
 
-typedef enum {
-  TURN_TO,
-  STEERING_CALIBRATION_ON,
-  STEERING_CALIBRATION_OFF,
-  FORWARD,
-  BACKWARD,
-  RESET_TURNS,
-  START_CAMERA,
-  STOP_CAMERA,
-  CAMERA_GIMBAL_TURN_TO,
-  CAMERA_GIMBAL_SET_PITCH_ANGLE,
-  RESET_CAMERA_GIMBAL,
-  CHANGE_DEGREE_OF_TURNS,
-  INIT,
-  SET_ESC_TO_NEUTRAL_POSITION,
-  ACTION_UNKNOWN
-} ActionType;
-
-ActionType getActionType(const char *action) {
-  if (strcmp(action, "turn-to") == 0) {
-    return TURN_TO;
-  } else if (strcmp(action, "reset-turns") == 0) {
-    return RESET_TURNS;
-  } else if (strcmp(action, "steering-calibration-on") == 0) {
-    return STEERING_CALIBRATION_ON;
-  } else if (strcmp(action, "steering-calibration-off") == 0) {
-    return STEERING_CALIBRATION_OFF;
-  } else if (strcmp(action, "change-degree-of-turns") == 0) {
-    return CHANGE_DEGREE_OF_TURNS;
-  } else if (strcmp(action, "forward") == 0) {
-    return FORWARD;
-  } else if (strcmp(action, "backward") == 0) {
-    return BACKWARD;
-  } else if (strcmp(action, "camera-gimbal-turn-to") == 0) {
-    return CAMERA_GIMBAL_TURN_TO;
-  } else if (strcmp(action, "camera-gimbal-set-pitch-angle") == 0) {
-    return CAMERA_GIMBAL_SET_PITCH_ANGLE;
-  } else if (strcmp(action, "reset-camera-gimbal") == 0) {
-    return RESET_CAMERA_GIMBAL;
-  } else if (strcmp(action, "set-esc-to-neutral-position") == 0) {
-    return SET_ESC_TO_NEUTRAL_POSITION;
-  } else if (strcmp(action, "init") == 0) {
-    return INIT;
-  } else if (strcmp(action, "start-camera") == 0) {
-    return START_CAMERA;
-  } else if (strcmp(action, "stop-camera") == 0) {
-    return STOP_CAMERA;
-  } else {
-    return ACTION_UNKNOWN;
-  }
-}
-
-void initMPU6050(int handle) {
-  i2cWriteByteData(handle, 0x6B, 0x00);
-  usleep(100000);
-}
-
-void deinitMPU6050(int handle) {
-  i2cClose(handle);
-}
-
-short readMPU6050Data(int handle, int reg) {
-  int high = i2cReadByteData(handle, reg);
-  int low = i2cReadByteData(handle, reg + 1);
-  return (short)((high << 8) | low);
-}
-
-void calibrateMPU6050(int handle, int samples) {
-  printf("[MPU6050] Calibrating gyro...\n");
-  float sumZ = 0.0;
-  for (int i = 0; i < samples; i++) {
-    short gyroZ = readMPU6050Data(handle, GYRO_ZOUT_H);
-    sumZ += gyroZ / GYRO_SENSITIVITY;
-    usleep(10000);
-  }
-  gyroZOffset = sumZ / samples;
-  printf("[MPU6050] Gyro Z Offset: %.2f\n", gyroZOffset);
+static int getSteeringPulseWidth(float degrees) {
+  return (int)floor(CAR_TURNS_MIN_PWM + ((degrees / 180.0f) *
+                                         (CAR_TURNS_MAX_PWM - CAR_TURNS_MIN_PWM)));
 }
 
 void turnTo(const float *degrees) {
-  const int pulseWidth =
-      (int)floor(CAR_TURNS_MIN_PWM + ((*degrees / 180.0f) *
-                                      (CAR_TURNS_MAX_PWM - CAR_TURNS_MIN_PWM)));
-  gpioServo(CAR_TURNS_SERVO_PIN, pulseWidth);
+  setTrajectoryTarget(CAR_TURNS_SERVO_PIN, getSteeringPulseWidth(*degrees));
 }
 
 void *steeringWheelCorrectionThread(void *arg) {
-  int handle = *(int *)arg;
+  SteeringWheelCorrection *correction = (SteeringWheelCorrection *)arg;
+  const int handle = correction->handle;
+  float correctionAngle = 0.0;
+  float previousCorrectionAngle = 0.0;
+  ControlState controlState;
 
   while (1) {
-    if (isCarTurning) {
+    const uint32_t controlStateSequence = readControlState(&controlState);
+
+    if (controlState.isCarTurning) {
+      usleep(20000);
       continue;
     }
 
     short gyroZ = readMPU6050Data(handle, GYRO_ZOUT_H);
-    float angularVelocityZ = (gyroZ / GYRO_SENSITIVITY) - gyroZOffset;
+    float angularVelocityZ = (gyroZ / GYRO_SENSITIVITY) - correction->calibration.gyroZOffset;
+
+    if (correction->isBackgroundImuCalibrationEnabled && controlState.escPulseWidth == CAR_ESC_NEUTRAL_PWM) {
+      const float rawGyroX = readMPU6050Data(handle, GYRO_XOUT_H) / GYRO_SENSITIVITY;
+      const float rawGyroY = readMPU6050Data(handle, GYRO_YOUT_H) / GYRO_SENSITIVITY;
+
+      if (updateImuBiasEstimator(&correction->biasEstimator, &correction->calibration, rawGyroX, rawGyroY, gyroZ / GYRO_SENSITIVITY)) {
+        correction->calibration.temperature = readMPU6050Temperature(handle);
+        saveImuCalibration(getImuCalibrationPath(), &correction->calibration);
+        printf("[MPU6050] Background gyro Z offset: %.2f\n", correction->calibration.gyroZOffset);
+      }
+    } else {
+      resetImuBiasEstimator(&correction->biasEstimator);
+    }
     float tempCorrectionAngle = 0.0;
 
     if (fabs(angularVelocityZ) > deadZone) {
@@ -136,8 +94,6 @@ void *steeringWheelCorrectionThread(void *arg) {
       tempCorrectionAngle = -MAX_CORRECTION_ANGLE;
     }
 
-    pthread_mutex_lock(&steeringWheelCorrectionMutex);
-
     correctionAngle = previousCorrectionAngle + (tempCorrectionAngle - previousCorrectionAngle) * 0.05f;
     previousCorrectionAngle = correctionAngle;
 
@@ -151,14 +107,33 @@ void *steeringWheelCorrectionThread(void *arg) {
       currentServoAngle = 0.0;
     }
 
-    turnTo(&currentServoAngle);
-    pthread_mutex_unlock(&steeringWheelCorrectionMutex);
+    const int steeringTarget = getTrajectoryTarget(CAR_TURNS_SERVO_PIN);
+
+    if (!isControlStateCurrent(controlStateSequence) ||
+        !replaceTrajectoryTarget(CAR_TURNS_SERVO_PIN, steeringTarget, getSteeringPulseWidth(currentServoAngle))) {
+      usleep(20000);
+      continue;
+    }
+
+    updateTelemetryImu(angularVelocityZ, correctionAngle);
+    recordFlightSteeringCorrection(angularVelocityZ, correctionAngle);
+    updateStateBusSteeringCorrection(angularVelocityZ, correctionAngle);
     usleep(20000);
   }
 
   return NULL;
 }
 
+void commitEscPulseWidth(int pulseWidth) {
+  setControlEscPulseWidth(pulseWidth);
+  setTrajectoryTarget(CAR_ESC_PIN, pulseWidth);
+}
+
+void cutEscToNeutral() {
+  setControlEscPulseWidth(CAR_ESC_NEUTRAL_PWM);
+  cutTrajectoryTarget(CAR_ESC_PIN, CAR_ESC_NEUTRAL_PWM);
+}
+
 void move(const int *speed, const char *direction) {
   int pulseWidth = CAR_ESC_NEUTRAL_PWM;
 
@@ -168,10 +143,13 @@ void move(const int *speed, const char *direction) {
     pulseWidth = (int)floorf(CAR_ESC_NEUTRAL_PWM - ((float)(*speed) / 100.0f) * (CAR_ESC_NEUTRAL_PWM - CAR_ESC_MIN_PWM));
   }
 
-  gpioServo(CAR_ESC_PIN, pulseWidth);
+  commitEscPulseWidth(governEscPulseWidth(pulseWidth));
 }
 
-void setEscToNeutralPosition() { gpioServo(CAR_ESC_PIN, CAR_ESC_NEUTRAL_PWM); }
+void setEscToNeutralPosition() {
+  governEscPulseWidth(CAR_ESC_NEUTRAL_PWM);
+  cutEscToNeutral();
+}
 
 void enableDisableEsc() {
   gpioWrite(CAR_ESC_ENABLE_PIN, 1);
@@ -182,56 +160,158 @@ void enableDisableEsc() {
   sleep(5);
 }
 
-void startCamera() {
-  mediaMtxPid = fork();
+void initCameraGimbal() {
+  setTrajectoryTarget(CAR_CAMERA_GIMBAL_PIN1, CAR_CAMERA_GIMBAL_MAX_PMW);
+}
 
-  if (mediaMtxPid == -1) {
-    perror("fork");
-    exit(EXIT_FAILURE);
-  } else if (mediaMtxPid == 0) {
-    execlp(getenv("MEDIAMTX_BIN_PATH"), "mediamtx", getenv("MEDIAMTX_CONFIG_PATH"), NULL);
-    perror("execlp");
-    exit(EXIT_FAILURE);
+void cameraGimbalSetYaw(const float *degrees) {
+  if (isGimbalStabilizerActive()) {
+    setGimbalStabilizerYaw(*degrees);
+    return;
   }
 
-  printf("[MediaMTX] started with PID %d \n", mediaMtxPid);
+  const int pulseWidth = (int)floorf(((*degrees + 90) / 180.0f) * (CAR_CAMERA_GIMBAL_MAX_PMW - CAR_CAMERA_GIMBAL_MIN_PMW) + CAR_CAMERA_GIMBAL_MIN_PMW);
+  setTrajectoryTarget(CAR_CAMERA_GIMBAL_PIN4, pulseWidth);
 }
 
-void stopCamera() {
-  if (kill(mediaMtxPid, SIGTERM) == 0) {
-    printf("[MediaMTX] process (PID %d) terminated successfully.\n", mediaMtxPid);
-    int status;
-    waitpid(mediaMtxPid, &status, 0);
-    if (WIFEXITED(status)) {
-      printf("[MediaMTX] exited with status %d.\n", WEXITSTATUS(status));
-    } else if (WIFSIGNALED(status)) {
-      printf("[MediaMTX] was terminated by signal %d.\n", WTERMSIG(status));
-    }
-  } else {
-    perror("[MediaMTX] Failed to terminate process");
+void cameraGimbalSetPitch(const float *degrees) {
+  if (isGimbalStabilizerActive()) {
+    setGimbalStabilizerPitch(*degrees);
+    return;
   }
+
+  const int pulseWidth = (int)floorf(((*degrees + 90) / 180.0f) * (CAR_CAMERA_GIMBAL_MAX_PMW - CAR_CAMERA_GIMBAL_MIN_PMW) + CAR_CAMERA_GIMBAL_MIN_PMW);
+  setTrajectoryTarget(CAR_CAMERA_GIMBAL_PIN3, pulseWidth);
 }
 
-void initCameraGimbal() {
-  gpioServo(CAR_CAMERA_GIMBAL_PIN1, CAR_CAMERA_GIMBAL_MAX_PMW);
+bool isStateAction(ActionType action) {
+  switch (action) {
+    case TURN_TO:
+    case CHANGE_DEGREE_OF_TURNS:
+    case RESET_TURNS:
+    case FORWARD:
+    case BACKWARD:
+    case SET_ESC_TO_NEUTRAL_POSITION:
+    case CAMERA_GIMBAL_TURN_TO:
+    case CAMERA_GIMBAL_SET_PITCH_ANGLE:
+    case RESET_CAMERA_GIMBAL:
+      return true;
+    default:
+      return false;
+  }
 }
 
-void cameraGimbalSetYaw(const float *degrees) {
-  const int pulseWidth = (int)floorf(((*degrees + 90) / 180.0f) * (CAR_CAMERA_GIMBAL_MAX_PMW - CAR_CAMERA_GIMBAL_MIN_PMW) + CAR_CAMERA_GIMBAL_MIN_PMW);
-  gpioServo(CAR_CAMERA_GIMBAL_PIN4, pulseWidth);
+void applyStateAction(int action, float value) {
+  switch ((ActionType)action) {
+    case CHANGE_DEGREE_OF_TURNS:
+    case TURN_TO: {
+      const float degrees = value < 0.0f ? 0.0f : (value > 180.0f ? 180.0f : value);
+      setControlCarTurning(true);
+      turnTo(&degrees);
+    } break;
+    case RESET_TURNS: {
+      setControlCarTurning(false);
+      turnTo(&value);
+    } break;
+    case FORWARD:
+    case BACKWARD: {
+      const int speed = (int)value;
+      move(&speed, action == FORWARD ? "forward" : "backward");
+    } break;
+    case SET_ESC_TO_NEUTRAL_POSITION: {
+      setEscToNeutralPosition();
+    } break;
+    case CAMERA_GIMBAL_TURN_TO: {
+      cameraGimbalSetYaw(&value);
+    } break;
+    case CAMERA_GIMBAL_SET_PITCH_ANGLE: {
+      cameraGimbalSetPitch(&value);
+    } break;
+    case RESET_CAMERA_GIMBAL: {
+      const float degrees = 0;
+      cameraGimbalSetYaw(&degrees);
+    } break;
+    default:
+      break;
+  }
 }
 
-void cameraGimbalSetPitch(const float *degrees) {
-  const int pulseWidth = (int)floorf(((*degrees + 90) / 180.0f) * (CAR_CAMERA_GIMBAL_MAX_PMW - CAR_CAMERA_GIMBAL_MIN_PMW) + CAR_CAMERA_GIMBAL_MIN_PMW);
-  gpioServo(CAR_CAMERA_GIMBAL_PIN3, pulseWidth);
+void driveAutonomously(float steeringAngle, int speed) {
+  static bool isDriving = false;
+
+  if (speed > 0) {
+    if (isDriving && getSpeedGovernorState() == SPEED_GOVERNOR_NEUTRAL) {
+      stopWaypointFollower("speed governor cut the throttle");
+      return;
+    }
+
+    markSpeedGovernorCommand(-1);
+    applyStateAction(TURN_TO, NEUTRAL_ANGLE + steeringAngle);
+    applyStateAction(FORWARD, (float)speed);
+    isDriving = true;
+  } else {
+    isDriving = false;
+    applyStateAction(SET_ESC_TO_NEUTRAL_POSITION, 0.0f);
+    applyStateAction(RESET_TURNS, NEUTRAL_ANGLE);
+  }
+}
+
+void followWaypoints(const cJSON *data) {
+  Waypoint waypoints[PURE_PURSUIT_MAX_WAYPOINTS];
+  const cJSON *rawWaypoints = cJSON_GetObjectItem(data, "waypoints");
+  const cJSON *rawSpeed = cJSON_GetObjectItem(data, "speed");
+  const cJSON *rawWaypoint = NULL;
+  int count = 0;
+
+  cJSON_ArrayForEach(rawWaypoint, rawWaypoints) {
+    const cJSON *latitude = cJSON_GetArrayItem(rawWaypoint, 0);
+    const cJSON *longitude = cJSON_GetArrayItem(rawWaypoint, 1);
+
+    if (count == PURE_PURSUIT_MAX_WAYPOINTS || !cJSON_IsNumber(latitude) || !cJSON_IsNumber(longitude)) {
+      break;
+    }
+
+    waypoints[count].latitude = latitude->valuedouble;
+    waypoints[count].longitude = longitude->valuedouble;
+    count++;
+  }
+
+  const int speed = cJSON_IsString(rawSpeed) ? (int)strtof(rawSpeed->valuestring, NULL) : 0;
+
+  if (count == 0 || speed <= 0) {
+    printf("[Waypoints] Ignoring route without waypoints or speed\n");
+    return;
+  }
+
+  startWaypointFollower(waypoints, count, speed);
 }
 
 void processWebSocketEvents(const char *message) {
-  cJSON *json = cJSON_Parse(message);
-  const cJSON *data = cJSON_GetObjectItem(json, "data");
-  const cJSON *rawAction = cJSON_GetObjectItem(data, "action");
-  if (rawAction && cJSON_IsString(rawAction)) {
-    ActionType action = getActionType(rawAction->valuestring);
+  CarCommand command;
+  const size_t arenaMark = beginJsonArenaScope();
+
+  if (decodeCarCommand(message, &command)) {
+    const cJSON *data = command.data;
+    const ActionType action = command.action;
+    const float value = command.value;
+
+    recordFlightCommand(command.actionName, value);
+    markTelemetryCommandReceived();
+    markSpeedGovernorCommand(command.sentAtMs);
+
+    if (isWaypointFollowerActive() && isStateAction(action)) {
+      stopWaypointFollower("manual override");
+    }
+
+    if (isJitterBufferEnabled() && action == SET_ESC_TO_NEUTRAL_POSITION && command.hasSentAt) {
+      flushJitterBuffer(command.sentAtMs);
+    } else if (isJitterBufferEnabled() && isStateAction(action) && command.hasSentAt) {
+      pushJitterBufferCommand(command.sentAtMs, action, value, action == TURN_TO);
+      releaseCarCommand(&command);
+      endJsonArenaScope(arenaMark);
+      return;
+    }
+
     switch (action) {
       case INIT: {
         const cJSON *rawDegrees = cJSON_GetObjectItem(data, "degrees");
@@ -242,67 +322,65 @@ void processWebSocketEvents(const char *message) {
         initCameraGimbal();
       } break;
       case CHANGE_DEGREE_OF_TURNS:
-      case TURN_TO: {
-        const cJSON *rawDegrees = cJSON_GetObjectItem(data, "degrees");
-        const float degrees = strtof(rawDegrees->valuestring, NULL);
-        isCarTurning = true;
-        turnTo(&degrees);
-      } break;
-      case RESET_TURNS: {
-        const cJSON *rawDegrees = cJSON_GetObjectItem(data, "degrees");
-        const float degrees = strtof(rawDegrees->valuestring, NULL);
-        isCarTurning = false;
-        turnTo(&degrees);
+      case TURN_TO:
+      case RESET_TURNS:
+      case FORWARD:
+      case BACKWARD:
+      case SET_ESC_TO_NEUTRAL_POSITION:
+      case CAMERA_GIMBAL_TURN_TO:
+      case CAMERA_GIMBAL_SET_PITCH_ANGLE:
+      case RESET_CAMERA_GIMBAL: {
+        applyStateAction(action, value);
       } break;
       case STEERING_CALIBRATION_ON: {
-        MPU6050Handle = i2cOpen(1, MPU6050_ADDRESS, 0);
-        if (MPU6050Handle < 0) {
-          printf("MPU6050 Failed to open I2C connection\n");
+        if (isSteeringWheelCorrectionRunning) {
+          break;
         }
 
-        initMPU6050(MPU6050Handle);
-        calibrateMPU6050(MPU6050Handle, 100);
+        if (MPU6050Handle < 0) {
+          MPU6050Handle = openMPU6050();
+        }
 
-        if (pthread_create(&steeringWheelCorrectionThreadHandle, NULL, steeringWheelCorrectionThread, &MPU6050Handle) != 0) {
-          printf("MPU6050 Failed to create correction thread\n");
+        if (MPU6050Handle < 0) {
+          break;
         }
 
-        float angle = 90.0f;
+        const char *backgroundImuCalibration = getenv("IMU_BACKGROUND_CALIBRATION");
+        steeringWheelCorrection.handle = MPU6050Handle;
+        steeringWheelCorrection.isBackgroundImuCalibrationEnabled = backgroundImuCalibration != NULL && strcmp(backgroundImuCalibration, "1") == 0;
+
+        activateImuCalibration(MPU6050Handle, &steeringWheelCorrection.calibration);
+        resetImuBiasEstimator(&steeringWheelCorrection.biasEstimator);
+
+        float angle = NEUTRAL_ANGLE;
         turnTo(&angle);
-        usleep(1000000);
+
+        if (pthread_create(&steeringWheelCorrectionThreadHandle, NULL, steeringWheelCorrectionThread, &steeringWheelCorrection) != 0) {
+          printf("MPU6050 Failed to create correction thread\n");
+        } else {
+          isSteeringWheelCorrectionRunning = true;
+        }
       } break;
       case STEERING_CALIBRATION_OFF: {
-        deinitMPU6050(MPU6050Handle);
+        if (!isSteeringWheelCorrectionRunning) {
+          break;
+        }
+
         pthread_cancel(steeringWheelCorrectionThreadHandle);
-      } break;
-      case FORWARD:
-      case BACKWARD: {
-        const cJSON *rawDegrees = cJSON_GetObjectItem(data, "speed");
-        const int speed = (int)strtof(rawDegrees->valuestring, NULL);
-        move(&speed, rawAction->valuestring);
-      } break;
-      case SET_ESC_TO_NEUTRAL_POSITION: {
-        setEscToNeutralPosition();
+        pthread_join(steeringWheelCorrectionThreadHandle, NULL);
+        isSteeringWheelCorrectionRunning = false;
       } break;
       case STOP_CAMERA: {
-        stopCamera();
+        setCameraPublishing(false);
       } break;
       case START_CAMERA: {
-        startCamera();
-      } break;
-      case CAMERA_GIMBAL_TURN_TO: {
-        const cJSON *rawDegrees = cJSON_GetObjectItem(data, "degrees");
-        const float degrees = strtof(rawDegrees->valuestring, NULL);
-        cameraGimbalSetYaw(&degrees);
+        setCameraPublishing(true);
       } break;
-      case CAMERA_GIMBAL_SET_PITCH_ANGLE: {
-        const cJSON *rawDegrees = cJSON_GetObjectItem(data, "degrees");
-        const float degrees = strtof(rawDegrees->valuestring, NULL);
-        cameraGimbalSetPitch(&degrees);
+      case FOLLOW_WAYPOINTS: {
+        followWaypoints(data);
       } break;
-      case RESET_CAMERA_GIMBAL: {
-        const float degrees = 0;
-        cameraGimbalSetYaw(&degrees);
+      case STOP_WAYPOINTS: {
+        stopWaypointFollower("operator request");
       } break;
 
       default:
@@ -310,11 +388,31 @@ void processWebSocketEvents(const char *message) {
     }
   }
 
-  cJSON_Delete(json);
+  releaseCarCommand(&command);
+  endJsonArenaScope(arenaMark);
+}
+
+void destroyRcCar() {
+  if (isSteeringWheelCorrectionRunning) {
+    pthread_cancel(steeringWheelCorrectionThreadHandle);
+    pthread_join(steeringWheelCorrectionThreadHandle, NULL);
+    isSteeringWheelCorrectionRunning = false;
+  }
+
+  if (MPU6050Handle >= 0) {
+    deinitMPU6050(MPU6050Handle);
+    MPU6050Handle = -1;
+  }
 }
 
 RcCar *newRcCar() {
   RcCar *rcCar = (RcCar *)malloc(sizeof(RcCar));
   rcCar->processWebSocketEvents = processWebSocketEvents;
+  rcCar->destroy = destroyRcCar;
+  rcCar->applyStateAction = applyStateAction;
+  rcCar->commitEscPulseWidth = commitEscPulseWidth;
+  rcCar->cutEscToNeutral = cutEscToNeutral;
+  setWaypointFollowerDriveCallback(driveAutonomously);
+  resetControlState();
   return rcCar;
 }
@@ -15,14 +15,15 @@
 #define CAR_CAMERA_GIMBAL_MIN_PMW 1000
 #define CAR_CAMERA_GIMBAL_MAX_PMW 2000
 
-#define MPU6050_ADDRESS 0x68
-#define GYRO_ZOUT_H 0x47
-#define GYRO_SENSITIVITY 131.0
 #define MAX_CORRECTION_ANGLE 20.0
 #define NEUTRAL_ANGLE 90.0
 
 typedef struct RcCar {
     void (*processWebSocketEvents)(const char *message);
+    void (*destroy)();
+    void (*applyStateAction)(int action, float value);
+    void (*commitEscPulseWidth)(int pulseWidth);
+    void (*cutEscToNeutral)();
 } RcCar;
 RcCar *newRcCar();
 #endif
@@ -0,0 +1,257 @@
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include "reactor.h"
+
+typedef struct {
+    ReactorCallback callback;
+    void *arg;
+    uint32_t events;
+} ReactorHandler;
+
+static ReactorHandler reactorHandlers[REACTOR_MAX_FDS];
+static int epollFd = -1;
+static int signalFd = -1;
+static volatile bool isReactorRunning = false;
+static struct lws_context *reactorWebSocketContext = NULL;
+static sigset_t reactorSignals;
+
+void blockReactorSignals() {
+    sigemptyset(&reactorSignals);
+    sigaddset(&reactorSignals, SIGINT);
+    sigaddset(&reactorSignals, SIGTERM);
+    sigaddset(&reactorSignals, SIGTSTP);
+    pthread_sigmask(SIG_BLOCK, &reactorSignals, NULL);
+}
+
+static void onReactorSignal(int fd, uint32_t events, void *arg) {
+    struct signalfd_siginfo signalInfo;
+
+    if (read(fd, &signalInfo, sizeof(signalInfo)) == sizeof(signalInfo)) {
+        printf("[Reactor] Received signal %u, shutting down\n", signalInfo.ssi_signo);
+        stopReactor();
+    }
+}
+
+int initReactor() {
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd < 0) {
+        perror("[Reactor] epoll_create1");
+        return -1;
+    }
+
+    signalFd = signalfd(-1, &reactorSignals, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (signalFd < 0) {
+        perror("[Reactor] signalfd");
+        return -1;
+    }
+
+    return addReactorFd(signalFd, EPOLLIN, onReactorSignal, NULL);
+}
+
+int addReactorFd(int fd, uint32_t events, ReactorCallback callback, void *arg) {
+    struct epoll_event event = {0};
+
+    if (fd < 0 || fd >= REACTOR_MAX_FDS) {
+        printf("[Reactor] fd %d is out of range\n", fd);
+        return -1;
+    }
+
+    event.events = events;
+    event.data.fd = fd;
+
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+        perror("[Reactor] epoll_ctl add");
+        return -1;
+    }
+
+    reactorHandlers[fd].callback = callback;
+    reactorHandlers[fd].arg = arg;
+    reactorHandlers[fd].events = events;
+
+    return 0;
+}
+
+int modifyReactorFd(int fd, uint32_t events) {
+    struct epoll_event event = {0};
+
+    if (fd < 0 || fd >= REACTOR_MAX_FDS || reactorHandlers[fd].callback == NULL) {
+        return -1;
+    }
+
+    event.events = events;
+    event.data.fd = fd;
+    reactorHandlers[fd].events = events;
+
+    return epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &event);
+}
+
+void removeReactorFd(int fd) {
+    if (fd < 0 || fd >= REACTOR_MAX_FDS || reactorHandlers[fd].callback == NULL) {
+        return;
+    }
+
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, NULL);
+    memset(&reactorHandlers[fd], 0, sizeof(ReactorHandler));
+}
+
+static void onReactorTimer(int fd, uint32_t events, void *arg) {
+    uint64_t expirations;
+    ReactorHandler *timer = (ReactorHandler *)arg;
+
+    if (read(fd, &expirations, sizeof(expirations)) == sizeof(expirations)) {
+        timer->callback(fd, events, timer->arg);
+    }
+}
+
+int addReactorTimer(long periodUs, ReactorCallback callback, void *arg) {
+    static ReactorHandler timers[REACTOR_MAX_FDS];
+    struct itimerspec period = {0};
+
+    const int fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (fd < 0 || fd >= REACTOR_MAX_FDS) {
+        perror("[Reactor] timerfd_create");
+        return -1;
+    }
+
+    period.it_interval.tv_sec = periodUs / 1000000L;
+    period.it_interval.tv_nsec = (periodUs % 1000000L) * 1000L;
+    period.it_value = period.it_interval;
+    if (periodUs > 0) {
+        timerfd_settime(fd, 0, &period, NULL);
+    }
+
+    timers[fd].callback = callback;
+    timers[fd].arg = arg;
+
+    if (addReactorFd(fd, EPOLLIN, onReactorTimer, &timers[fd]) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+int armReactorTimer(int fd, long delayUs) {
+    struct itimerspec deadline = {0};
+
+    if (delayUs < 1) {
+        delayUs = 1;
+    }
+
+    deadline.it_value.tv_sec = delayUs / 1000000L;
+    deadline.it_value.tv_nsec = (delayUs % 1000000L) * 1000L;
+
+    return timerfd_settime(fd, 0, &deadline, NULL);
+}
+
+void removeReactorTimer(int fd) {
+    removeReactorFd(fd);
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+static uint32_t pollToEpollEvents(int events) {
+    return (events & POLLIN ? EPOLLIN : 0) | (events & POLLOUT ? EPOLLOUT : 0);
+}
+
+static void onReactorWebSocketFd(int fd, uint32_t events, void *arg) {
+    struct lws_pollfd pollFd;
+
+    pollFd.fd = fd;
+    pollFd.events = (short)((reactorHandlers[fd].events & EPOLLIN ? POLLIN : 0) | (reactorHandlers[fd].events & EPOLLOUT ? POLLOUT : 0));
+    pollFd.revents = (short)(
+        (events & EPOLLIN ? POLLIN : 0)
+        | (events & EPOLLOUT ? POLLOUT : 0)
+        | (events & EPOLLHUP ? POLLHUP : 0)
+        | (events & EPOLLERR ? POLLERR : 0)
+    );
+
+    lws_service_fd(reactorWebSocketContext, &pollFd);
+}
+
+void attachReactorWebSocketContext(struct lws_context *context) {
+    reactorWebSocketContext = context;
+}
+
+int handleReactorWebSocketPoll(enum lws_callback_reasons reason, void *in) {
+    const struct lws_pollargs *pollArgs = (const struct lws_pollargs *)in;
+
+    switch (reason) {
+        case LWS_CALLBACK_ADD_POLL_FD:
+            addReactorFd(pollArgs->fd, pollToEpollEvents(pollArgs->events), onReactorWebSocketFd, NULL);
+            return 1;
+        case LWS_CALLBACK_DEL_POLL_FD:
+            removeReactorFd(pollArgs->fd);
+            return 1;
+        case LWS_CALLBACK_CHANGE_MODE_POLL_FD:
+            modifyReactorFd(pollArgs->fd, pollToEpollEvents(pollArgs->events));
+            return 1;
+        case LWS_CALLBACK_LOCK_POLL:
+        case LWS_CALLBACK_UNLOCK_POLL:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+void runReactor() {
+    struct epoll_event events[REACTOR_MAX_EVENTS];
+
+    isReactorRunning = true;
+
+    while (isReactorRunning) {
+        int timeoutMs = REACTOR_WEB_SOCKET_SERVICE_MS;
+
+        if (reactorWebSocketContext != NULL) {
+            timeoutMs = lws_service_adjust_timeout(reactorWebSocketContext, REACTOR_WEB_SOCKET_SERVICE_MS, 0);
+        }
+
+        const int count = epoll_wait(epollFd, events, REACTOR_MAX_EVENTS, timeoutMs);
+
+        if (count < 0 && errno != EINTR) {
+            perror("[Reactor] epoll_wait");
+            break;
+        }
+
+        for (int i = 0; i < count; i++) {
+            const int fd = events[i].data.fd;
+
+            if (fd >= 0 && fd < REACTOR_MAX_FDS && reactorHandlers[fd].callback != NULL) {
+                reactorHandlers[fd].callback(fd, events[i].events, reactorHandlers[fd].arg);
+            }
+        }
+
+        if (reactorWebSocketContext != NULL) {
+            if (timeoutMs == 0) {
+                lws_service_tsi(reactorWebSocketContext, -1, 0);
+            }
+            lws_service_fd(reactorWebSocketContext, NULL);
+        }
+    }
+}
+
+void stopReactor() {
+    isReactorRunning = false;
+}
+
+void closeReactor() {
+    if (signalFd >= 0) {
+        removeReactorFd(signalFd);
+        close(signalFd);
+        signalFd = -1;
+    }
+
+    if (epollFd >= 0) {
+        close(epollFd);
+        epollFd = -1;
+    }
+}
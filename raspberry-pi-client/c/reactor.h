@@ -0,0 +1,26 @@
+#ifndef REACTOR_H
+#define REACTOR_H
+
+#include <libwebsockets.h>
+#include <stdint.h>
+
+#define REACTOR_MAX_FDS 256
+#define REACTOR_MAX_EVENTS 32
+#define REACTOR_WEB_SOCKET_SERVICE_MS 100
+
+typedef void (*ReactorCallback)(int fd, uint32_t events, void *arg);
+
+void blockReactorSignals();
+int initReactor();
+int addReactorFd(int fd, uint32_t events, ReactorCallback callback, void *arg);
+int modifyReactorFd(int fd, uint32_t events);
+void removeReactorFd(int fd);
+int addReactorTimer(long periodUs, ReactorCallback callback, void *arg);
+int armReactorTimer(int fd, long delayUs);
+void removeReactorTimer(int fd);
+void attachReactorWebSocketContext(struct lws_context *context);
+int handleReactorWebSocketPoll(enum lws_callback_reasons reason, void *in);
+void runReactor();
+void stopReactor();
+void closeReactor();
+#endif
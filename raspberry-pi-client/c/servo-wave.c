@@ -0,0 +1,166 @@
+#include <stdint.h>
+#include "servo-wave.h"
+
+static int findServoWaveChannel(const ServoWave *wave, int pin) {
+    for (int i = 0; i < wave->count; i++) {
+        if (wave->pins[i] == pin) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+void initServoWave(ServoWave *wave) {
+    wave->count = 0;
+    wave->activeWaveId = -1;
+    wave->retiredWaveId = -1;
+    wave->isDirty = false;
+}
+
+int addServoWaveChannel(ServoWave *wave, int pin, int pulseWidth) {
+    const int existing = findServoWaveChannel(wave, pin);
+
+    if (existing >= 0) {
+        return existing;
+    }
+
+    if (wave->count >= SERVO_WAVE_MAX_CHANNELS) {
+        return -1;
+    }
+
+    wave->pins[wave->count] = pin;
+    wave->pulseWidths[wave->count] = pulseWidth;
+    wave->isDirty = true;
+
+    return wave->count++;
+}
+
+bool setServoWavePulseWidth(ServoWave *wave, int pin, int pulseWidth) {
+    const int channel = findServoWaveChannel(wave, pin);
+
+    if (channel < 0) {
+        return false;
+    }
+
+    if (wave->pulseWidths[channel] != pulseWidth) {
+        wave->pulseWidths[channel] = pulseWidth;
+        wave->isDirty = true;
+    }
+
+    return true;
+}
+
+int getServoWavePulseWidth(const ServoWave *wave, int pin) {
+    const int channel = findServoWaveChannel(wave, pin);
+    return channel >= 0 ? wave->pulseWidths[channel] : -1;
+}
+
+int buildServoWavePulses(const ServoWave *wave, gpioPulse_t *pulses) {
+    int order[SERVO_WAVE_MAX_CHANNELS];
+    int active = 0;
+    int count = 0;
+    uint32_t onMask = 0;
+
+    for (int i = 0; i < wave->count; i++) {
+        if (wave->pulseWidths[i] <= 0) {
+            continue;
+        }
+
+        int j = active++;
+        while (j > 0 && wave->pulseWidths[order[j - 1]] > wave->pulseWidths[i]) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = i;
+        onMask |= 1u << wave->pins[i];
+    }
+
+    if (active == 0) {
+        return 0;
+    }
+
+    pulses[count].gpioOn = onMask;
+    pulses[count].gpioOff = 0;
+    pulses[count].usDelay = (uint32_t)wave->pulseWidths[order[0]];
+    count++;
+
+    for (int i = 0; i < active; i++) {
+        const int pulseWidth = wave->pulseWidths[order[i]];
+        uint32_t offMask = 1u << wave->pins[order[i]];
+
+        while (i + 1 < active && wave->pulseWidths[order[i + 1]] == pulseWidth) {
+            offMask |= 1u << wave->pins[order[++i]];
+        }
+
+        pulses[count].gpioOn = 0;
+        pulses[count].gpioOff = offMask;
+        pulses[count].usDelay = (uint32_t)((i + 1 < active ? wave->pulseWidths[order[i + 1]] : SERVO_WAVE_FRAME_US) - pulseWidth);
+        count++;
+    }
+
+    return count;
+}
+
+int commitServoWave(ServoWave *wave) {
+    gpioPulse_t pulses[SERVO_WAVE_MAX_PULSES];
+
+    if (wave->retiredWaveId >= 0) {
+        if (gpioWaveTxAt() == wave->retiredWaveId) {
+            return SERVO_WAVE_DEFERRED;
+        }
+
+        gpioWaveDelete((unsigned)wave->retiredWaveId);
+        wave->retiredWaveId = -1;
+    }
+
+    if (!wave->isDirty) {
+        return SERVO_WAVE_COMMITTED;
+    }
+
+    const int count = buildServoWavePulses(wave, pulses);
+    if (count == 0) {
+        gpioWaveTxStop();
+        if (wave->activeWaveId >= 0) {
+            gpioWaveDelete((unsigned)wave->activeWaveId);
+            wave->activeWaveId = -1;
+        }
+        wave->isDirty = false;
+        return SERVO_WAVE_COMMITTED;
+    }
+
+    gpioWaveAddNew();
+    if (gpioWaveAddGeneric((unsigned)count, pulses) < 0) {
+        return -1;
+    }
+
+    const int waveId = gpioWaveCreate();
+    if (waveId < 0) {
+        return waveId;
+    }
+
+    const int result = gpioWaveTxSend((unsigned)waveId, PI_WAVE_MODE_REPEAT_SYNC);
+    if (result < 0) {
+        gpioWaveDelete((unsigned)waveId);
+        return result;
+    }
+
+    wave->retiredWaveId = wave->activeWaveId;
+    wave->activeWaveId = waveId;
+    wave->isDirty = false;
+
+    return SERVO_WAVE_COMMITTED;
+}
+
+void releaseServoWave(ServoWave *wave) {
+    gpioWaveTxStop();
+
+    if (wave->retiredWaveId >= 0) {
+        gpioWaveDelete((unsigned)wave->retiredWaveId);
+    }
+    if (wave->activeWaveId >= 0) {
+        gpioWaveDelete((unsigned)wave->activeWaveId);
+    }
+
+    initServoWave(wave);
+}
@@ -0,0 +1,29 @@
+#ifndef SERVO_WAVE_H
+#define SERVO_WAVE_H
+
+#include <pigpio.h>
+#include <stdbool.h>
+
+#define SERVO_WAVE_FRAME_US 20000
+#define SERVO_WAVE_MAX_CHANNELS 8
+#define SERVO_WAVE_MAX_PULSES (SERVO_WAVE_MAX_CHANNELS + 1)
+#define SERVO_WAVE_COMMITTED 0
+#define SERVO_WAVE_DEFERRED 1
+
+typedef struct {
+    int pins[SERVO_WAVE_MAX_CHANNELS];
+    int pulseWidths[SERVO_WAVE_MAX_CHANNELS];
+    int count;
+    int activeWaveId;
+    int retiredWaveId;
+    bool isDirty;
+} ServoWave;
+
+void initServoWave(ServoWave *wave);
+int addServoWaveChannel(ServoWave *wave, int pin, int pulseWidth);
+bool setServoWavePulseWidth(ServoWave *wave, int pin, int pulseWidth);
+int getServoWavePulseWidth(const ServoWave *wave, int pin);
+int buildServoWavePulses(const ServoWave *wave, gpioPulse_t *pulses);
+int commitServoWave(ServoWave *wave);
+void releaseServoWave(ServoWave *wave);
+#endif
@@ -0,0 +1,230 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "pigpio.h"
+
+typedef struct {
+    bool isUsed;
+    uint32_t pinMask;
+    int pulseWidths[32];
+} SimulatedWave;
+
+static _Atomic int servoPulseWidths[PI_SIMULATED_GPIO_COUNT];
+static _Atomic int levels[PI_SIMULATED_GPIO_COUNT];
+static _Atomic long servoWriteCount = 0;
+static _Atomic long waveSendCount = 0;
+static pthread_mutex_t servoOutputMutex = PTHREAD_MUTEX_INITIALIZER;
+static SimulatedWave waves[PI_SIMULATED_WAVE_COUNT];
+static gpioPulse_t pendingPulses[PI_SIMULATED_WAVE_PULSES];
+static unsigned pendingPulseCount = 0;
+static int transmittingWaveId = -1;
+
+int gpioInitialise(void) {
+    for (int i = 0; i < PI_SIMULATED_GPIO_COUNT; i++) {
+        atomic_store(&servoPulseWidths[i], 0);
+        atomic_store(&levels[i], 0);
+    }
+
+    printf("[GPIO] Using simulated backend, no pins are driven\n");
+
+    return 0;
+}
+
+void gpioTerminate(void) {
+    printf(
+        "[GPIO] Simulated backend saw %ld servo writes and %ld waveform sends\n",
+        atomic_load(&servoWriteCount),
+        atomic_load(&waveSendCount)
+    );
+}
+
+int gpioSetMode(unsigned gpio, unsigned mode) {
+    return gpio < PI_SIMULATED_GPIO_COUNT ? 0 : PI_BAD_GPIO;
+}
+
+int gpioWrite(unsigned gpio, unsigned level) {
+    if (gpio >= PI_SIMULATED_GPIO_COUNT) {
+        return PI_BAD_GPIO;
+    }
+
+    atomic_store_explicit(&levels[gpio], level != 0, memory_order_relaxed);
+
+    return 0;
+}
+
+int gpioServo(unsigned gpio, unsigned pulseWidth) {
+    if (gpio >= PI_SIMULATED_GPIO_COUNT) {
+        return PI_BAD_GPIO;
+    }
+
+    if (pulseWidth != 0 && (pulseWidth < PI_SIMULATED_MIN_SERVO_PULSEWIDTH || pulseWidth > PI_SIMULATED_MAX_SERVO_PULSEWIDTH)) {
+        return PI_BAD_PULSEWIDTH;
+    }
+
+    pthread_mutex_lock(&servoOutputMutex);
+    atomic_store_explicit(&servoPulseWidths[gpio], (int)pulseWidth, memory_order_relaxed);
+    pthread_mutex_unlock(&servoOutputMutex);
+    atomic_fetch_add_explicit(&servoWriteCount, 1, memory_order_relaxed);
+
+    return 0;
+}
+
+int gpioGetServoPulsewidth(unsigned gpio) {
+    return gpio < PI_SIMULATED_GPIO_COUNT ? atomic_load_explicit(&servoPulseWidths[gpio], memory_order_relaxed) : PI_BAD_GPIO;
+}
+
+int gpioWaveAddNew(void) {
+    pendingPulseCount = 0;
+    return 0;
+}
+
+int gpioWaveAddGeneric(unsigned numPulses, gpioPulse_t *pulses) {
+    if (pendingPulseCount + numPulses > PI_SIMULATED_WAVE_PULSES) {
+        return PI_TOO_MANY_CBS;
+    }
+
+    for (unsigned i = 0; i < numPulses; i++) {
+        pendingPulses[pendingPulseCount++] = pulses[i];
+    }
+
+    return (int)pendingPulseCount;
+}
+
+int gpioWaveCreate(void) {
+    int onAtUs[32];
+    int timeUs = 0;
+    int waveId = -1;
+
+    if (pendingPulseCount == 0) {
+        return PI_EMPTY_WAVEFORM;
+    }
+
+    for (int i = 0; i < PI_SIMULATED_WAVE_COUNT && waveId < 0; i++) {
+        if (!waves[i].isUsed) {
+            waveId = i;
+        }
+    }
+
+    if (waveId < 0) {
+        return PI_NO_WAVEFORM_ID;
+    }
+
+    SimulatedWave *wave = &waves[waveId];
+    wave->isUsed = true;
+    wave->pinMask = 0;
+
+    for (int pin = 0; pin < 32; pin++) {
+        onAtUs[pin] = -1;
+        wave->pulseWidths[pin] = 0;
+    }
+
+    for (unsigned i = 0; i < pendingPulseCount; i++) {
+        for (int pin = 0; pin < 32; pin++) {
+            if (pendingPulses[i].gpioOn & (1u << pin)) {
+                onAtUs[pin] = timeUs;
+                wave->pinMask |= 1u << pin;
+            }
+            if ((pendingPulses[i].gpioOff & (1u << pin)) && onAtUs[pin] >= 0) {
+                wave->pulseWidths[pin] = timeUs - onAtUs[pin];
+                onAtUs[pin] = -1;
+            }
+        }
+        timeUs += (int)pendingPulses[i].usDelay;
+    }
+
+    pendingPulseCount = 0;
+
+    return waveId;
+}
+
+int gpioWaveDelete(unsigned waveId) {
+    if (waveId >= PI_SIMULATED_WAVE_COUNT || !waves[waveId].isUsed) {
+        return PI_BAD_WAVE_ID;
+    }
+
+    waves[waveId].isUsed = false;
+
+    return 0;
+}
+
+int gpioWaveTxSend(unsigned waveId, unsigned waveMode) {
+    if (waveId >= PI_SIMULATED_WAVE_COUNT || !waves[waveId].isUsed) {
+        return PI_BAD_WAVE_ID;
+    }
+
+    if (waveMode > PI_WAVE_MODE_REPEAT_SYNC) {
+        return PI_BAD_WAVE_MODE;
+    }
+
+    pthread_mutex_lock(&servoOutputMutex);
+    for (int pin = 0; pin < 32; pin++) {
+        if (waves[waveId].pinMask & (1u << pin)) {
+            atomic_store_explicit(&servoPulseWidths[pin], waves[waveId].pulseWidths[pin], memory_order_relaxed);
+        }
+    }
+    transmittingWaveId = (int)waveId;
+    pthread_mutex_unlock(&servoOutputMutex);
+    atomic_fetch_add_explicit(&waveSendCount, 1, memory_order_relaxed);
+
+    return 0;
+}
+
+int gpioWaveTxAt(void) {
+    pthread_mutex_lock(&servoOutputMutex);
+    const int waveId = transmittingWaveId;
+    pthread_mutex_unlock(&servoOutputMutex);
+
+    return waveId >= 0 ? waveId : PI_NO_TX_WAVE;
+}
+
+int gpioWaveTxStop(void) {
+    pthread_mutex_lock(&servoOutputMutex);
+    if (transmittingWaveId >= 0) {
+        for (int pin = 0; pin < 32; pin++) {
+            if (waves[transmittingWaveId].pinMask & (1u << pin)) {
+                atomic_store_explicit(&servoPulseWidths[pin], 0, memory_order_relaxed);
+            }
+        }
+    }
+    transmittingWaveId = -1;
+    pthread_mutex_unlock(&servoOutputMutex);
+
+    return 0;
+}
+
+long gpioSimulatedServoWriteCount(void) {
+    return atomic_load(&servoWriteCount);
+}
+
+long gpioSimulatedWaveSendCount(void) {
+    return atomic_load(&waveSendCount);
+}
+
+void gpioSimulatedServoSnapshot(const unsigned *gpios, int *pulseWidths, unsigned count) {
+    pthread_mutex_lock(&servoOutputMutex);
+    for (unsigned i = 0; i < count; i++) {
+        pulseWidths[i] = gpios[i] < PI_SIMULATED_GPIO_COUNT ? atomic_load_explicit(&servoPulseWidths[gpios[i]], memory_order_relaxed) : PI_BAD_GPIO;
+    }
+    pthread_mutex_unlock(&servoOutputMutex);
+}
+
+int i2cOpen(unsigned bus, unsigned address, unsigned flags) {
+    return PI_NO_HANDLE;
+}
+
+int i2cClose(unsigned handle) {
+    return PI_NO_HANDLE;
+}
+
+int i2cReadByteData(unsigned handle, unsigned reg) {
+    return PI_NO_HANDLE;
+}
+
+int i2cWriteByteData(unsigned handle, unsigned reg, unsigned value) {
+    return PI_NO_HANDLE;
+}
+
+int i2cReadI2CBlockData(unsigned handle, unsigned reg, char *buffer, unsigned count) {
+    return PI_NO_HANDLE;
+}
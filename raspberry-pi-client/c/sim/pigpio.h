@@ -0,0 +1,54 @@
+#ifndef SIMULATED_PIGPIO_H
+#define SIMULATED_PIGPIO_H
+
+#include <stdint.h>
+
+#define PI_INPUT 0
+#define PI_OUTPUT 1
+#define PI_SIMULATED_GPIO_COUNT 54
+#define PI_SIMULATED_MIN_SERVO_PULSEWIDTH 500
+#define PI_SIMULATED_MAX_SERVO_PULSEWIDTH 2500
+#define PI_BAD_GPIO -3
+#define PI_BAD_PULSEWIDTH -7
+#define PI_NO_HANDLE -24
+#define PI_BAD_WAVE_MODE -33
+#define PI_BAD_WAVE_ID -66
+#define PI_TOO_MANY_CBS -67
+#define PI_EMPTY_WAVEFORM -69
+#define PI_NO_WAVEFORM_ID -70
+#define PI_WAVE_MODE_ONE_SHOT 0
+#define PI_WAVE_MODE_REPEAT 1
+#define PI_WAVE_MODE_ONE_SHOT_SYNC 2
+#define PI_WAVE_MODE_REPEAT_SYNC 3
+#define PI_NO_TX_WAVE 9999
+#define PI_SIMULATED_WAVE_COUNT 16
+#define PI_SIMULATED_WAVE_PULSES 64
+
+typedef struct {
+    uint32_t gpioOn;
+    uint32_t gpioOff;
+    uint32_t usDelay;
+} gpioPulse_t;
+
+int gpioInitialise(void);
+void gpioTerminate(void);
+int gpioSetMode(unsigned gpio, unsigned mode);
+int gpioWrite(unsigned gpio, unsigned level);
+int gpioServo(unsigned gpio, unsigned pulseWidth);
+int gpioGetServoPulsewidth(unsigned gpio);
+int i2cOpen(unsigned bus, unsigned address, unsigned flags);
+int i2cClose(unsigned handle);
+int i2cReadByteData(unsigned handle, unsigned reg);
+int i2cWriteByteData(unsigned handle, unsigned reg, unsigned value);
+int i2cReadI2CBlockData(unsigned handle, unsigned reg, char *buffer, unsigned count);
+int gpioWaveAddNew(void);
+int gpioWaveAddGeneric(unsigned numPulses, gpioPulse_t *pulses);
+int gpioWaveCreate(void);
+int gpioWaveDelete(unsigned waveId);
+int gpioWaveTxSend(unsigned waveId, unsigned waveMode);
+int gpioWaveTxAt(void);
+int gpioWaveTxStop(void);
+long gpioSimulatedServoWriteCount(void);
+long gpioSimulatedWaveSendCount(void);
+void gpioSimulatedServoSnapshot(const unsigned *gpios, int *pulseWidths, unsigned count);
+#endif
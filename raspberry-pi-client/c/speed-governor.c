@@ -0,0 +1,177 @@
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "rc-car.h"
+#include "reactor.h"
+#include "speed-governor.h"
+#include "telemetry.h"
+#include "transit-estimator.h"
+
+static SpeedGovernorCallback governorCallback = NULL;
+static SpeedGovernorCutCallback governorCutCallback = NULL;
+static int governorTimerFd = -1;
+static int lowLatencyMs = SPEED_GOVERNOR_DEFAULT_LOW_LATENCY_MS;
+static int highLatencyMs = SPEED_GOVERNOR_DEFAULT_HIGH_LATENCY_MS;
+static int silenceMs = SPEED_GOVERNOR_DEFAULT_SILENCE_MS;
+static int minCapPercent = SPEED_GOVERNOR_DEFAULT_MIN_CAP_PERCENT;
+
+static long lastCommandAtMs = -1;
+static long lastExcessTransitMs = 0;
+static TransitEstimator transitEstimator = {SPEED_GOVERNOR_TRANSIT_WINDOW_MS, LONG_MAX, LONG_MAX, 0};
+
+static int requestedPulseWidth = CAR_ESC_NEUTRAL_PWM;
+static int governedPulseWidth = CAR_ESC_NEUTRAL_PWM;
+static int capPercent = 100;
+static SpeedGovernorState governorState = SPEED_GOVERNOR_OPEN;
+
+static long nowMs() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000L + now.tv_nsec / 1000000L;
+}
+
+static int getSpeedGovernorSetting(const char *name, int fallback, int minimum) {
+    const char *value = getenv(name);
+    return value != NULL && value[0] != '\0' && atoi(value) >= minimum ? atoi(value) : fallback;
+}
+
+static int getLinkLatencyMs(long now) {
+    if (lastCommandAtMs < 0) {
+        return silenceMs;
+    }
+
+    return (int)(now - lastCommandAtMs + lastExcessTransitMs);
+}
+
+static void updateSpeedGovernorCap(long now) {
+    const int latencyMs = getLinkLatencyMs(now);
+
+    if (latencyMs >= silenceMs) {
+        capPercent = 0;
+        governorState = SPEED_GOVERNOR_NEUTRAL;
+    } else if (latencyMs <= lowLatencyMs) {
+        capPercent = 100;
+        governorState = SPEED_GOVERNOR_OPEN;
+    } else if (latencyMs >= highLatencyMs) {
+        capPercent = minCapPercent;
+        governorState = SPEED_GOVERNOR_LIMITING;
+    } else {
+        capPercent = 100 - (100 - minCapPercent) * (latencyMs - lowLatencyMs) / (highLatencyMs - lowLatencyMs);
+        governorState = SPEED_GOVERNOR_LIMITING;
+    }
+
+    updateTelemetryGovernor(capPercent, latencyMs, governorState);
+}
+
+static int applySpeedGovernorCap(int pulseWidth) {
+    return CAR_ESC_NEUTRAL_PWM + (pulseWidth - CAR_ESC_NEUTRAL_PWM) * capPercent / 100;
+}
+
+static void onSpeedGovernorTick(int fd, uint32_t events, void *arg) {
+    const SpeedGovernorState previousState = governorState;
+
+    updateSpeedGovernorCap(nowMs());
+
+    if (governorState == SPEED_GOVERNOR_NEUTRAL) {
+        requestedPulseWidth = CAR_ESC_NEUTRAL_PWM;
+    }
+
+    const int pulseWidth = applySpeedGovernorCap(requestedPulseWidth);
+    if (pulseWidth != governedPulseWidth) {
+        governedPulseWidth = pulseWidth;
+        if (governorState == SPEED_GOVERNOR_NEUTRAL) {
+            governorCutCallback();
+        } else {
+            governorCallback(pulseWidth);
+        }
+    }
+
+    if (governorState != previousState) {
+        printf("[Governor] %s, ESC capped at %d%%\n", governorState == SPEED_GOVERNOR_NEUTRAL ? "Link silent" : (governorState == SPEED_GOVERNOR_LIMITING ? "Link degraded" : "Link healthy"), capPercent);
+    }
+}
+
+void markSpeedGovernorCommand(long sentAtMs) {
+    const long now = nowMs();
+
+    lastCommandAtMs = now;
+
+    if (sentAtMs < 0) {
+        lastExcessTransitMs = 0;
+        return;
+    }
+
+    const long transit = updateTransitEstimator(&transitEstimator, sentAtMs, now);
+
+    lastExcessTransitMs = transit - getTransitEstimatorBaseMs(&transitEstimator);
+}
+
+int governEscPulseWidth(int pulseWidth) {
+    requestedPulseWidth = pulseWidth;
+
+    if (governorTimerFd < 0) {
+        return pulseWidth;
+    }
+
+    updateSpeedGovernorCap(nowMs());
+    governedPulseWidth = applySpeedGovernorCap(pulseWidth);
+
+    return governedPulseWidth;
+}
+
+SpeedGovernorState getSpeedGovernorState() {
+    if (governorTimerFd >= 0) {
+        updateSpeedGovernorCap(nowMs());
+    }
+
+    return governorState;
+}
+
+int startSpeedGovernor(SpeedGovernorCallback callback, SpeedGovernorCutCallback cutCallback) {
+    const char *isEnabled = getenv("SPEED_GOVERNOR");
+
+    if (isEnabled == NULL || strcmp(isEnabled, "1") != 0) {
+        return -1;
+    }
+
+    lowLatencyMs = getSpeedGovernorSetting("SPEED_GOVERNOR_LOW_LATENCY_MS", SPEED_GOVERNOR_DEFAULT_LOW_LATENCY_MS, 1);
+    highLatencyMs = getSpeedGovernorSetting("SPEED_GOVERNOR_HIGH_LATENCY_MS", SPEED_GOVERNOR_DEFAULT_HIGH_LATENCY_MS, 1);
+    silenceMs = getSpeedGovernorSetting("SPEED_GOVERNOR_SILENCE_MS", SPEED_GOVERNOR_DEFAULT_SILENCE_MS, 1);
+    minCapPercent = getSpeedGovernorSetting("SPEED_GOVERNOR_MIN_CAP_PERCENT", SPEED_GOVERNOR_DEFAULT_MIN_CAP_PERCENT, 0);
+
+    if (highLatencyMs <= lowLatencyMs) {
+        highLatencyMs = lowLatencyMs + 1;
+    }
+    if (silenceMs < highLatencyMs) {
+        silenceMs = highLatencyMs;
+    }
+    if (minCapPercent > 100) {
+        minCapPercent = 100;
+    }
+
+    governorCallback = callback;
+    governorCutCallback = cutCallback;
+    resetTransitEstimator(&transitEstimator, SPEED_GOVERNOR_TRANSIT_WINDOW_MS, nowMs());
+
+    governorTimerFd = addReactorTimer(1000000L / SPEED_GOVERNOR_RATE_HZ, onSpeedGovernorTick, NULL);
+    if (governorTimerFd < 0) {
+        printf("[Governor] Failed to schedule speed governor\n");
+        return -1;
+    }
+
+    setTelemetryGovernorThresholds(lowLatencyMs, highLatencyMs, silenceMs, minCapPercent);
+    printf("[Governor] Capping ESC between %d and %d ms, neutral after %d ms of silence\n", lowLatencyMs, highLatencyMs, silenceMs);
+
+    return 0;
+}
+
+void stopSpeedGovernor() {
+    if (governorTimerFd < 0) {
+        return;
+    }
+
+    removeReactorTimer(governorTimerFd);
+    governorTimerFd = -1;
+}
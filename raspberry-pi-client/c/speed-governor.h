@@ -0,0 +1,25 @@
+#ifndef SPEED_GOVERNOR_H
+#define SPEED_GOVERNOR_H
+
+#define SPEED_GOVERNOR_RATE_HZ 50
+#define SPEED_GOVERNOR_DEFAULT_LOW_LATENCY_MS 150
+#define SPEED_GOVERNOR_DEFAULT_HIGH_LATENCY_MS 400
+#define SPEED_GOVERNOR_DEFAULT_SILENCE_MS 800
+#define SPEED_GOVERNOR_DEFAULT_MIN_CAP_PERCENT 30
+#define SPEED_GOVERNOR_TRANSIT_WINDOW_MS 5000
+
+typedef enum {
+    SPEED_GOVERNOR_OPEN,
+    SPEED_GOVERNOR_LIMITING,
+    SPEED_GOVERNOR_NEUTRAL
+} SpeedGovernorState;
+
+typedef void (*SpeedGovernorCallback)(int pulseWidth);
+typedef void (*SpeedGovernorCutCallback)();
+
+int startSpeedGovernor(SpeedGovernorCallback callback, SpeedGovernorCutCallback cutCallback);
+void stopSpeedGovernor();
+void markSpeedGovernorCommand(long sentAtMs);
+int governEscPulseWidth(int pulseWidth);
+SpeedGovernorState getSpeedGovernorState();
+#endif
@@ -0,0 +1,68 @@
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "state-bus.h"
+
+int openStateBusReader(StateBusReader *reader, const char *name) {
+    reader->segment = NULL;
+
+    const int fd = shm_open(name != NULL ? name : STATE_BUS_DEFAULT_NAME, O_RDONLY, 0);
+    if (fd < 0) {
+        return -1;
+    }
+
+    void *mapping = mmap(NULL, sizeof(StateBusSegment), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (mapping == MAP_FAILED) {
+        return -1;
+    }
+
+    StateBusSegment *segment = (StateBusSegment *)mapping;
+
+    if (segment->magic != STATE_BUS_MAGIC || segment->version != STATE_BUS_VERSION || segment->stateSize != sizeof(CarState)) {
+        munmap(mapping, sizeof(StateBusSegment));
+        return -1;
+    }
+
+    reader->segment = segment;
+
+    return 0;
+}
+
+bool readStateBus(const StateBusReader *reader, CarState *state, uint32_t *sequence) {
+    if (reader->segment == NULL) {
+        return false;
+    }
+
+    _Atomic uint32_t *segmentSequence = (_Atomic uint32_t *)&reader->segment->sequence;
+
+    for (int attempt = 0; attempt < STATE_BUS_READ_RETRIES; attempt++) {
+        const uint32_t before = atomic_load_explicit(segmentSequence, memory_order_acquire);
+
+        if (before & 1u) {
+            continue;
+        }
+
+        memcpy(state, (const void *)&reader->segment->state, sizeof(CarState));
+        atomic_thread_fence(memory_order_acquire);
+
+        if (atomic_load_explicit(segmentSequence, memory_order_relaxed) == before) {
+            if (sequence != NULL) {
+                *sequence = before;
+            }
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void closeStateBusReader(StateBusReader *reader) {
+    if (reader->segment != NULL) {
+        munmap(reader->segment, sizeof(StateBusSegment));
+        reader->segment = NULL;
+    }
+}
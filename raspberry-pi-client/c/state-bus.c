@@ -0,0 +1,188 @@
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+#include "rc-car.h"
+#include "state-bus.h"
+
+static StateBusSegment *stateBusSegment = NULL;
+static char stateBusName[128];
+static atomic_flag stateBusWriterLock = ATOMIC_FLAG_INIT;
+
+static uint64_t nowNs() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+}
+
+int openStateBus() {
+    const char *name = getenv("STATE_BUS_NAME");
+
+    if (name != NULL && strcmp(name, "off") == 0) {
+        return -1;
+    }
+
+    snprintf(stateBusName, sizeof(stateBusName), "%s", name != NULL && name[0] != '\0' ? name : STATE_BUS_DEFAULT_NAME);
+
+    const int fd = shm_open(stateBusName, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        perror("[StateBus] shm_open");
+        return -1;
+    }
+
+    if (ftruncate(fd, sizeof(StateBusSegment)) != 0) {
+        perror("[StateBus] ftruncate");
+        close(fd);
+        return -1;
+    }
+
+    void *mapping = mmap(NULL, sizeof(StateBusSegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (mapping == MAP_FAILED) {
+        perror("[StateBus] mmap");
+        return -1;
+    }
+
+    stateBusSegment = (StateBusSegment *)mapping;
+    memset(stateBusSegment, 0, sizeof(StateBusSegment));
+    stateBusSegment->magic = STATE_BUS_MAGIC;
+    stateBusSegment->version = STATE_BUS_VERSION;
+    stateBusSegment->stateSize = sizeof(CarState);
+
+    printf("[StateBus] Publishing car state to %s\n", stateBusName);
+
+    return 0;
+}
+
+void closeStateBus() {
+    if (stateBusSegment == NULL) {
+        return;
+    }
+
+    munmap(stateBusSegment, sizeof(StateBusSegment));
+    shm_unlink(stateBusName);
+    stateBusSegment = NULL;
+}
+
+static CarState *beginStateBusWrite() {
+    if (stateBusSegment == NULL) {
+        return NULL;
+    }
+
+    while (atomic_flag_test_and_set_explicit(&stateBusWriterLock, memory_order_acquire)) {
+    }
+
+    _Atomic uint32_t *sequence = (_Atomic uint32_t *)&stateBusSegment->sequence;
+    atomic_store_explicit(sequence, atomic_load_explicit(sequence, memory_order_relaxed) + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    return &stateBusSegment->state;
+}
+
+static void endStateBusWrite(CarState *state) {
+    state->updatedAtNs = nowNs();
+
+    _Atomic uint32_t *sequence = (_Atomic uint32_t *)&stateBusSegment->sequence;
+    atomic_store_explicit(sequence, atomic_load_explicit(sequence, memory_order_relaxed) + 1, memory_order_release);
+    atomic_flag_clear_explicit(&stateBusWriterLock, memory_order_release);
+}
+
+void updateStateBusActuator(int pin, int pulseWidth) {
+    CarState *state = beginStateBusWrite();
+
+    if (state == NULL) {
+        return;
+    }
+
+    switch (pin) {
+        case CAR_TURNS_SERVO_PIN:
+            state->steeringPulseWidth = pulseWidth;
+            break;
+        case CAR_ESC_PIN:
+            state->escPulseWidth = pulseWidth;
+            break;
+        case CAR_CAMERA_GIMBAL_PIN4:
+            state->gimbalYawPulseWidth = pulseWidth;
+            break;
+        case CAR_CAMERA_GIMBAL_PIN3:
+            state->gimbalPitchPulseWidth = pulseWidth;
+            break;
+        default:
+            break;
+    }
+
+    endStateBusWrite(state);
+}
+
+void updateStateBusGps(double latitude, double longitude, float speed, float track, int fixMode) {
+    CarState *state = beginStateBusWrite();
+
+    if (state == NULL) {
+        return;
+    }
+
+    state->latitude = latitude;
+    state->longitude = longitude;
+    state->speed = speed;
+    state->track = track;
+    state->fixMode = fixMode;
+
+    endStateBusWrite(state);
+}
+
+void updateStateBusYawRate(float yawRate) {
+    CarState *state = beginStateBusWrite();
+
+    if (state == NULL) {
+        return;
+    }
+
+    state->yawRate = yawRate;
+
+    endStateBusWrite(state);
+}
+
+void updateStateBusForwardAcceleration(float forwardAcceleration) {
+    CarState *state = beginStateBusWrite();
+
+    if (state == NULL) {
+        return;
+    }
+
+    state->forwardAcceleration = forwardAcceleration;
+
+    endStateBusWrite(state);
+}
+
+void updateStateBusSteeringCorrection(float yawRate, float correctionAngle) {
+    CarState *state = beginStateBusWrite();
+
+    if (state == NULL) {
+        return;
+    }
+
+    state->correctionYawRate = yawRate;
+    state->correctionAngle = correctionAngle;
+
+    endStateBusWrite(state);
+}
+
+void updateStateBusEstimate(double latitude, double longitude, float heading, float positionStdDev) {
+    CarState *state = beginStateBusWrite();
+
+    if (state == NULL) {
+        return;
+    }
+
+    state->estimatedLatitude = latitude;
+    state->estimatedLongitude = longitude;
+    state->estimatedHeading = heading;
+    state->positionStdDev = positionStdDev;
+
+    endStateBusWrite(state);
+}
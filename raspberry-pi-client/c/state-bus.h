@@ -0,0 +1,57 @@
+#ifndef STATE_BUS_H
+#define STATE_BUS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define STATE_BUS_MAGIC 0x52435342u
+#define STATE_BUS_VERSION 2
+#define STATE_BUS_DEFAULT_NAME "/rc-car-state"
+#define STATE_BUS_READ_RETRIES 1000
+
+typedef struct {
+    uint64_t updatedAtNs;
+    int32_t steeringPulseWidth;
+    int32_t escPulseWidth;
+    int32_t gimbalYawPulseWidth;
+    int32_t gimbalPitchPulseWidth;
+    double latitude;
+    double longitude;
+    float speed;
+    float track;
+    int32_t fixMode;
+    float yawRate;
+    float forwardAcceleration;
+    float correctionAngle;
+    float correctionYawRate;
+    double estimatedLatitude;
+    double estimatedLongitude;
+    float estimatedHeading;
+    float positionStdDev;
+} CarState;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t stateSize;
+    uint32_t sequence;
+    CarState state;
+} StateBusSegment;
+
+typedef struct {
+    StateBusSegment *segment;
+} StateBusReader;
+
+int openStateBus();
+void closeStateBus();
+void updateStateBusActuator(int pin, int pulseWidth);
+void updateStateBusGps(double latitude, double longitude, float speed, float track, int fixMode);
+void updateStateBusYawRate(float yawRate);
+void updateStateBusForwardAcceleration(float forwardAcceleration);
+void updateStateBusSteeringCorrection(float yawRate, float correctionAngle);
+void updateStateBusEstimate(double latitude, double longitude, float heading, float positionStdDev);
+
+int openStateBusReader(StateBusReader *reader, const char *name);
+bool readStateBus(const StateBusReader *reader, CarState *state, uint32_t *sequence);
+void closeStateBusReader(StateBusReader *reader);
+#endif
@@ -0,0 +1,273 @@
+#include <math.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "reactor.h"
+#include "telemetry.h"
+#include "websocket.h"
+
+static TelemetrySample latestSample = {0};
+static int governorThresholds[4] = {0, 0, 0, 0};
+static _Atomic int latestYawRateCentiDegrees = 0;
+static _Atomic int latestCorrectionAngleCentiDegrees = 0;
+static _Atomic int latestActuatorPulseWidths[TELEMETRY_ACTUATOR_COUNT];
+static long lastCommandReceivedAtMs = -1;
+static int commandsInCurrentSecond = 0;
+static long currentSecondStartedAtMs = 0;
+
+static int telemetryTimerFd = -1;
+static TelemetrySampleCallback telemetrySampleCallback = NULL;
+
+static TelemetrySample pendingSamples[TELEMETRY_MAX_BATCH];
+static int pendingHead = 0;
+static int pendingCount = 0;
+static int batchSize = 1;
+static int unchokedPublishes = 0;
+static unsigned long droppedSamples = 0;
+static unsigned char telemetryFrame[LWS_PRE + TELEMETRY_FRAME_SIZE];
+
+static long nowMs() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000L + now.tv_nsec / 1000000L;
+}
+
+void updateTelemetryGps(double latitude, double longitude, double speed, int fixMode) {
+    latestSample.latitudeE7 = isfinite(latitude) ? (int)lround(latitude * TELEMETRY_COORDINATE_SCALE) : 0;
+    latestSample.longitudeE7 = isfinite(longitude) ? (int)lround(longitude * TELEMETRY_COORDINATE_SCALE) : 0;
+    latestSample.speedCmPerSecond = isfinite(speed) ? (int)lround(speed * 100.0) : 0;
+    latestSample.fixMode = fixMode;
+}
+
+void updateTelemetryImu(float yawRate, float correctionAngle) {
+    atomic_store_explicit(&latestYawRateCentiDegrees, (int)lroundf(yawRate * 100.0f), memory_order_relaxed);
+    atomic_store_explicit(&latestCorrectionAngleCentiDegrees, (int)lroundf(correctionAngle * 100.0f), memory_order_relaxed);
+}
+
+void updateTelemetryEstimate(double latitude, double longitude, float heading, float positionStdDev) {
+    latestSample.estimatedLatitudeE7 = (int)lround(latitude * TELEMETRY_COORDINATE_SCALE);
+    latestSample.estimatedLongitudeE7 = (int)lround(longitude * TELEMETRY_COORDINATE_SCALE);
+    latestSample.headingCentiDegrees = (int)lroundf(heading * 100.0f);
+    latestSample.positionStdDevCm = (int)lroundf(positionStdDev * 100.0f);
+}
+
+void updateTelemetryActuator(TelemetryActuator actuator, int pulseWidth) {
+    atomic_store_explicit(&latestActuatorPulseWidths[actuator], pulseWidth, memory_order_relaxed);
+}
+
+void updateTelemetryCommandDelay(int delayMs) {
+    latestSample.commandDelayMs = delayMs;
+}
+
+void updateTelemetryGovernor(int capPercent, int linkLatencyMs, int state) {
+    latestSample.governorCapPercent = capPercent;
+    latestSample.linkLatencyMs = linkLatencyMs;
+    latestSample.governorState = state;
+}
+
+void setTelemetryGovernorThresholds(int lowLatencyMs, int highLatencyMs, int silenceMs, int minCapPercent) {
+    governorThresholds[0] = lowLatencyMs;
+    governorThresholds[1] = highLatencyMs;
+    governorThresholds[2] = silenceMs;
+    governorThresholds[3] = minCapPercent;
+}
+
+void markTelemetryCommandReceived() {
+    const long now = nowMs();
+
+    lastCommandReceivedAtMs = now;
+    if (now - currentSecondStartedAtMs >= 1000) {
+        latestSample.commandsPerSecond = commandsInCurrentSecond;
+        commandsInCurrentSecond = 0;
+        currentSecondStartedAtMs = now;
+    }
+    commandsInCurrentSecond++;
+}
+
+int encodeTelemetryFrame(const TelemetrySample *samples, int count, char *out, size_t outSize) {
+    if (count <= 0) {
+        return 0;
+    }
+
+    const TelemetrySample *base = &samples[0];
+    int length = snprintf(
+        out,
+        outSize,
+        "{\"to\":\"" TELEMETRY_DESTINATION "\",\"type\":\"telemetry\",\"t\":%ld,\"lat\":%d,\"lon\":%d,",
+        base->timestampMs,
+        base->latitudeE7,
+        base->longitudeE7
+    );
+
+    if (governorThresholds[1] > 0 && length > 0 && (size_t)length < outSize) {
+        length += snprintf(
+            out + length,
+            outSize - length,
+            "\"gov\":[%d,%d,%d,%d],",
+            governorThresholds[0],
+            governorThresholds[1],
+            governorThresholds[2],
+            governorThresholds[3]
+        );
+    }
+
+    if (length > 0 && (size_t)length < outSize) {
+        length += snprintf(out + length, outSize - length, "\"s\":[");
+    }
+
+    for (int i = 0; i < count && length > 0 && (size_t)length < outSize; i++) {
+        const TelemetrySample *sample = &samples[i];
+        length += snprintf(
+            out + length,
+            outSize - length,
+            "%s[%ld,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d]",
+            i == 0 ? "" : ",",
+            sample->timestampMs - base->timestampMs,
+            sample->latitudeE7 - base->latitudeE7,
+            sample->longitudeE7 - base->longitudeE7,
+            sample->speedCmPerSecond,
+            sample->fixMode,
+            sample->yawRateCentiDegrees,
+            sample->correctionAngleCentiDegrees,
+            sample->actuatorPulseWidths[TELEMETRY_STEERING],
+            sample->actuatorPulseWidths[TELEMETRY_ESC],
+            sample->actuatorPulseWidths[TELEMETRY_GIMBAL_YAW],
+            sample->actuatorPulseWidths[TELEMETRY_GIMBAL_PITCH],
+            sample->commandAgeMs,
+            sample->commandsPerSecond,
+            sample->estimatedLatitudeE7 - base->latitudeE7,
+            sample->estimatedLongitudeE7 - base->longitudeE7,
+            sample->headingCentiDegrees,
+            sample->positionStdDevCm,
+            sample->commandDelayMs,
+            sample->governorCapPercent,
+            sample->linkLatencyMs,
+            sample->governorState
+        );
+    }
+
+    if (length <= 0 || (size_t)length + 2 >= outSize) {
+        return -1;
+    }
+
+    out[length++] = ']';
+    out[length++] = '}';
+    out[length] = '\0';
+
+    return length;
+}
+
+static void collectTelemetrySample() {
+    TelemetrySample sample;
+    const long now = nowMs();
+
+    sample = latestSample;
+    sample.yawRateCentiDegrees = atomic_load_explicit(&latestYawRateCentiDegrees, memory_order_relaxed);
+    sample.correctionAngleCentiDegrees = atomic_load_explicit(&latestCorrectionAngleCentiDegrees, memory_order_relaxed);
+    for (int i = 0; i < TELEMETRY_ACTUATOR_COUNT; i++) {
+        sample.actuatorPulseWidths[i] = atomic_load_explicit(&latestActuatorPulseWidths[i], memory_order_relaxed);
+    }
+    sample.timestampMs = now;
+    sample.commandAgeMs = lastCommandReceivedAtMs < 0 ? -1 : (int)(now - lastCommandReceivedAtMs);
+
+    if (pendingCount == TELEMETRY_MAX_BATCH) {
+        pendingHead = (pendingHead + 1) % TELEMETRY_MAX_BATCH;
+        pendingCount--;
+        droppedSamples++;
+    }
+
+    pendingSamples[(pendingHead + pendingCount) % TELEMETRY_MAX_BATCH] = sample;
+    pendingCount++;
+}
+
+static void onTelemetryChoked() {
+    unchokedPublishes = 0;
+    if (batchSize < TELEMETRY_MAX_BATCH) {
+        batchSize *= 2;
+        printf("[Telemetry] Link is choked, batching %d samples per frame\n", batchSize);
+    }
+}
+
+static void telemetryTick(int fd, uint32_t events, void *arg) {
+    struct lws *webSocketInstance = getWebSocketInstanceFor(TELEMETRY_DESTINATION);
+
+    if (telemetrySampleCallback) {
+        telemetrySampleCallback();
+    }
+
+    collectTelemetrySample();
+
+    if (webSocketInstance != NULL && pendingCount >= batchSize) {
+        if (lws_send_pipe_choked(webSocketInstance)) {
+            onTelemetryChoked();
+        } else {
+            lws_callback_on_writable(webSocketInstance);
+        }
+    }
+}
+
+void onTelemetryWritable(struct lws *webSocketInstance) {
+    TelemetrySample samples[TELEMETRY_MAX_BATCH];
+    char *frame = (char *)telemetryFrame + LWS_PRE;
+
+    if (webSocketInstance != getWebSocketInstanceFor(TELEMETRY_DESTINATION) || pendingCount == 0) {
+        return;
+    }
+
+    if (lws_send_pipe_choked(webSocketInstance)) {
+        onTelemetryChoked();
+        return;
+    }
+
+    for (int i = 0; i < pendingCount; i++) {
+        samples[i] = pendingSamples[(pendingHead + i) % TELEMETRY_MAX_BATCH];
+    }
+
+    const int length = encodeTelemetryFrame(samples, pendingCount, frame, TELEMETRY_FRAME_SIZE);
+    pendingHead = 0;
+    pendingCount = 0;
+
+    if (length <= 0) {
+        printf("[Telemetry] Frame does not fit into %d bytes\n", TELEMETRY_FRAME_SIZE);
+        return;
+    }
+
+    lws_write(webSocketInstance, telemetryFrame + LWS_PRE, (size_t)length, LWS_WRITE_TEXT);
+
+    if (batchSize > 1 && ++unchokedPublishes >= TELEMETRY_UNCHOKED_PUBLISHES_TO_SHRINK) {
+        unchokedPublishes = 0;
+        batchSize /= 2;
+    }
+}
+
+void setTelemetrySampleCallback(TelemetrySampleCallback callback) {
+    telemetrySampleCallback = callback;
+}
+
+void startTelemetryPublisher() {
+    const char *publishRate = getenv("TELEMETRY_PUBLISH_HZ");
+    const int publishHz = publishRate != NULL && atoi(publishRate) > 0 ? atoi(publishRate) : TELEMETRY_DEFAULT_PUBLISH_HZ;
+
+    telemetryTimerFd = addReactorTimer(1000000L / publishHz, telemetryTick, NULL);
+    if (telemetryTimerFd < 0) {
+        printf("[Telemetry] Failed to schedule publisher\n");
+        return;
+    }
+
+    printf("[Telemetry] Publishing at %d Hz\n", publishHz);
+}
+
+void stopTelemetryPublisher() {
+    if (telemetryTimerFd < 0) {
+        return;
+    }
+
+    removeReactorTimer(telemetryTimerFd);
+    telemetryTimerFd = -1;
+
+    if (droppedSamples > 0) {
+        printf("[Telemetry] Dropped %lu samples on a choked link\n", droppedSamples);
+    }
+}
@@ -0,0 +1,57 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <libwebsockets.h>
+
+#define TELEMETRY_DESTINATION "rc-car-client-map"
+#define TELEMETRY_DEFAULT_PUBLISH_HZ 10
+#define TELEMETRY_MAX_BATCH 16
+#define TELEMETRY_FRAME_SIZE 4096
+#define TELEMETRY_UNCHOKED_PUBLISHES_TO_SHRINK 20
+#define TELEMETRY_COORDINATE_SCALE 10000000.0
+
+typedef enum {
+    TELEMETRY_STEERING,
+    TELEMETRY_ESC,
+    TELEMETRY_GIMBAL_YAW,
+    TELEMETRY_GIMBAL_PITCH,
+    TELEMETRY_ACTUATOR_COUNT
+} TelemetryActuator;
+
+typedef struct {
+    long timestampMs;
+    int latitudeE7;
+    int longitudeE7;
+    int speedCmPerSecond;
+    int fixMode;
+    int yawRateCentiDegrees;
+    int correctionAngleCentiDegrees;
+    int actuatorPulseWidths[TELEMETRY_ACTUATOR_COUNT];
+    int commandAgeMs;
+    int commandsPerSecond;
+    int estimatedLatitudeE7;
+    int estimatedLongitudeE7;
+    int headingCentiDegrees;
+    int positionStdDevCm;
+    int commandDelayMs;
+    int governorCapPercent;
+    int linkLatencyMs;
+    int governorState;
+} TelemetrySample;
+
+typedef void (*TelemetrySampleCallback)();
+
+void setTelemetrySampleCallback(TelemetrySampleCallback callback);
+void startTelemetryPublisher();
+void stopTelemetryPublisher();
+void onTelemetryWritable(struct lws *webSocketInstance);
+void updateTelemetryGps(double latitude, double longitude, double speed, int fixMode);
+void updateTelemetryImu(float yawRate, float correctionAngle);
+void updateTelemetryEstimate(double latitude, double longitude, float heading, float positionStdDev);
+void updateTelemetryActuator(TelemetryActuator actuator, int pulseWidth);
+void updateTelemetryCommandDelay(int delayMs);
+void updateTelemetryGovernor(int capPercent, int linkLatencyMs, int state);
+void setTelemetryGovernorThresholds(int lowLatencyMs, int highLatencyMs, int silenceMs, int minCapPercent);
+void markTelemetryCommandReceived();
+int encodeTelemetryFrame(const TelemetrySample *samples, int count, char *out, size_t outSize);
+#endif
@@ -0,0 +1,95 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../control-state.h"
+
+#define CONTROL_STATE_STRESS_DEFAULT_WRITES 2000000L
+#define CONTROL_STATE_STRESS_DEFAULT_READERS 3
+#define CONTROL_STATE_STRESS_MAX_READERS 16
+
+typedef struct {
+    long snapshots;
+    long violations;
+} StressCounters;
+
+static atomic_bool isWriting = false;
+
+static void *readControlStateLoop(void *arg) {
+    StressCounters *counters = arg;
+    ControlState state;
+    unsigned char isCarTurning;
+    int lastPulseWidth = 0;
+
+    while (atomic_load_explicit(&isWriting, memory_order_relaxed)) {
+        readControlState(&state);
+        memcpy(&isCarTurning, &state.isCarTurning, sizeof(isCarTurning));
+        counters->snapshots++;
+
+        if (state.escPulseWidth < lastPulseWidth || isCarTurning > 1 || state.isCarTurning != (state.escPulseWidth & 1)) {
+            counters->violations++;
+        }
+        lastPulseWidth = state.escPulseWidth;
+    }
+
+    return NULL;
+}
+
+int main(int argc, char **argv) {
+    long writes = CONTROL_STATE_STRESS_DEFAULT_WRITES;
+    int readerCount = CONTROL_STATE_STRESS_DEFAULT_READERS;
+    pthread_t readers[CONTROL_STATE_STRESS_MAX_READERS];
+    StressCounters counters[CONTROL_STATE_STRESS_MAX_READERS];
+    long snapshots = 0;
+    long violations = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--writes") == 0 && i + 1 < argc) {
+            writes = atol(argv[++i]);
+        } else if (strcmp(argv[i], "--readers") == 0 && i + 1 < argc) {
+            readerCount = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "Usage: %s [--writes count] [--readers 1-%d]\n", argv[0], CONTROL_STATE_STRESS_MAX_READERS);
+            return 1;
+        }
+    }
+
+    if (writes <= 0 || readerCount <= 0 || readerCount > CONTROL_STATE_STRESS_MAX_READERS) {
+        fprintf(stderr, "Write count must be positive and readers between 1 and %d\n", CONTROL_STATE_STRESS_MAX_READERS);
+        return 1;
+    }
+
+    setControlState(&(ControlState){.isCarTurning = false, .escPulseWidth = 0});
+    atomic_store(&isWriting, true);
+
+    for (int i = 0; i < readerCount; i++) {
+        memset(&counters[i], 0, sizeof(StressCounters));
+        if (pthread_create(&readers[i], NULL, readControlStateLoop, &counters[i]) != 0) {
+            fprintf(stderr, "Failed to start reader\n");
+            return 1;
+        }
+    }
+
+    for (long write = 1; write <= writes; write++) {
+        setControlState(&(ControlState){.isCarTurning = write & 1, .escPulseWidth = (int)write});
+    }
+
+    atomic_store(&isWriting, false);
+    for (int i = 0; i < readerCount; i++) {
+        pthread_join(readers[i], NULL);
+        snapshots += counters[i].snapshots;
+        violations += counters[i].violations;
+    }
+
+    printf(
+        "{\"benchmark\": \"control-state-stress\", \"writes\": %ld, \"readers\": %d, \"snapshots\": %ld, \"violations\": %ld}\n",
+        writes,
+        readerCount,
+        snapshots,
+        violations
+    );
+
+    return violations == 0 ? 0 : 1;
+}
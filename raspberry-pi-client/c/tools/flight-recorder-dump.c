@@ -0,0 +1,230 @@
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../flight-recorder.h"
+
+static const char *getFlightRecordTypeName(uint16_t type) {
+    switch (type) {
+        case FLIGHT_RECORD_COMMAND:
+            return "command";
+        case FLIGHT_RECORD_ACTUATOR:
+            return "actuator";
+        case FLIGHT_RECORD_GPS:
+            return "gps";
+        case FLIGHT_RECORD_IMU:
+            return "imu";
+        case FLIGHT_RECORD_STEERING_CORRECTION:
+            return "steering-correction";
+        default:
+            return "unknown";
+    }
+}
+
+static bool getFlightRecordWallTime(const FlightRecorderHeader *header, const FlightRecord *record, double *wallTime) {
+    const FlightRecorderBoot *boot = &header->boots[record->boot % FLIGHT_RECORDER_MAX_BOOTS];
+
+    if (record->boot == 0 || boot->boot != record->boot) {
+        return false;
+    }
+
+    *wallTime = ((double)boot->realtimeBaseNs + ((double)record->timestampNs - (double)boot->monotonicBaseNs)) / 1e9;
+
+    return true;
+}
+
+static void printJsonString(const char *value, size_t maxLength) {
+    putchar('"');
+
+    for (size_t i = 0; i < maxLength && value[i] != '\0'; i++) {
+        const unsigned char character = (unsigned char)value[i];
+
+        if (character == '"' || character == '\\') {
+            printf("\\%c", character);
+        } else if (character < 0x20) {
+            printf("\\u%04x", character);
+        } else {
+            putchar(character);
+        }
+    }
+
+    putchar('"');
+}
+
+static void printCsvString(const char *value, size_t maxLength) {
+    putchar('"');
+
+    for (size_t i = 0; i < maxLength && value[i] != '\0'; i++) {
+        const unsigned char character = (unsigned char)value[i];
+
+        if (character == '"') {
+            printf("\"\"");
+        } else {
+            putchar(character < 0x20 ? ' ' : character);
+        }
+    }
+
+    putchar('"');
+}
+
+static void printCsvRecord(const FlightRecord *record, const char *wallTime) {
+    printf("%" PRIu64 ",%" PRIu64 ",%s,%s,", record->sequence, record->timestampNs, wallTime, getFlightRecordTypeName(record->type));
+
+    switch (record->type) {
+        case FLIGHT_RECORD_COMMAND:
+            printCsvString(record->data.command.action, FLIGHT_RECORDER_ACTION_SIZE);
+            printf(",%f,,,\n", record->data.command.value);
+            break;
+        case FLIGHT_RECORD_ACTUATOR:
+            printf("%u,%d,,,\n", record->code, record->data.actuator.pulseWidth);
+            break;
+        case FLIGHT_RECORD_GPS:
+            printf(
+                "%.8f,%.8f,%f,%f,%d\n",
+                record->data.gps.latitude,
+                record->data.gps.longitude,
+                record->data.gps.speed,
+                record->data.gps.track,
+                record->data.gps.fixMode
+            );
+            break;
+        case FLIGHT_RECORD_IMU:
+            printf("%f,%f,,,\n", record->data.imu.yawRate, record->data.imu.forwardAcceleration);
+            break;
+        case FLIGHT_RECORD_STEERING_CORRECTION:
+            printf("%f,%f,,,\n", record->data.steeringCorrection.yawRate, record->data.steeringCorrection.correctionAngle);
+            break;
+        default:
+            printf(",,,,\n");
+            break;
+    }
+}
+
+static void printJsonRecord(const FlightRecord *record, const char *wallTime) {
+    printf(
+        "{\"sequence\":%" PRIu64 ",\"timestampNs\":%" PRIu64 ",\"time\":%s,\"type\":\"%s\"",
+        record->sequence,
+        record->timestampNs,
+        wallTime,
+        getFlightRecordTypeName(record->type)
+    );
+
+    switch (record->type) {
+        case FLIGHT_RECORD_COMMAND:
+            printf(",\"action\":");
+            printJsonString(record->data.command.action, FLIGHT_RECORDER_ACTION_SIZE);
+            printf(",\"value\":%f}\n", record->data.command.value);
+            break;
+        case FLIGHT_RECORD_ACTUATOR:
+            printf(",\"pin\":%u,\"pulseWidth\":%d}\n", record->code, record->data.actuator.pulseWidth);
+            break;
+        case FLIGHT_RECORD_GPS:
+            printf(
+                ",\"latitude\":%.8f,\"longitude\":%.8f,\"speed\":%f,\"track\":%f,\"fixMode\":%d}\n",
+                record->data.gps.latitude,
+                record->data.gps.longitude,
+                record->data.gps.speed,
+                record->data.gps.track,
+                record->data.gps.fixMode
+            );
+            break;
+        case FLIGHT_RECORD_IMU:
+            printf(",\"yawRate\":%f,\"forwardAcceleration\":%f}\n", record->data.imu.yawRate, record->data.imu.forwardAcceleration);
+            break;
+        case FLIGHT_RECORD_STEERING_CORRECTION:
+            printf(
+                ",\"yawRate\":%f,\"correctionAngle\":%f}\n",
+                record->data.steeringCorrection.yawRate,
+                record->data.steeringCorrection.correctionAngle
+            );
+            break;
+        default:
+            printf("}\n");
+            break;
+    }
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <flight-recorder.bin> [--json]\n", argv[0]);
+        return 1;
+    }
+
+    const int isJson = argc > 2 && strcmp(argv[2], "--json") == 0;
+    const int fd = open(argv[1], O_RDONLY);
+    struct stat fileStat;
+
+    if (fd < 0 || fstat(fd, &fileStat) != 0 || (size_t)fileStat.st_size < sizeof(FlightRecorderHeader)) {
+        fprintf(stderr, "Failed to open %s\n", argv[1]);
+        return 1;
+    }
+
+    const void *mapping = mmap(NULL, (size_t)fileStat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (mapping == MAP_FAILED) {
+        perror("mmap");
+        return 1;
+    }
+
+    const FlightRecorderHeader *header = (const FlightRecorderHeader *)mapping;
+    const FlightRecord *records = (const FlightRecord *)((const char *)mapping + sizeof(FlightRecorderHeader));
+
+    if (
+        header->magic != FLIGHT_RECORDER_MAGIC
+        || header->version != FLIGHT_RECORDER_VERSION
+        || header->recordSize != sizeof(FlightRecord)
+        || sizeof(FlightRecorderHeader) + (size_t)header->capacity * sizeof(FlightRecord) > (size_t)fileStat.st_size
+    ) {
+        fprintf(stderr, "%s is not a flight recorder file\n", argv[1]);
+        return 1;
+    }
+
+    const uint64_t writeIndex = header->writeIndex;
+    const uint64_t first = writeIndex > header->capacity ? writeIndex - header->capacity : 0;
+
+    if (!isJson) {
+        printf("sequence,timestamp_ns,time,type,a,b,c,d,e\n");
+    }
+
+    for (uint64_t sequence = first; sequence < writeIndex; sequence++) {
+        const FlightRecord *slot = &records[sequence % header->capacity];
+        _Atomic uint64_t *slotSequence = (_Atomic uint64_t *)&slot->sequence;
+        FlightRecord record;
+        double wallTime;
+        char wallTimeText[32];
+
+        if (atomic_load_explicit(slotSequence, memory_order_acquire) != sequence) {
+            continue;
+        }
+
+        memcpy(&record, slot, sizeof(FlightRecord));
+        atomic_thread_fence(memory_order_acquire);
+
+        if (atomic_load_explicit(slotSequence, memory_order_relaxed) != sequence) {
+            continue;
+        }
+
+        if (getFlightRecordWallTime(header, &record, &wallTime)) {
+            snprintf(wallTimeText, sizeof(wallTimeText), "%.6f", wallTime);
+        } else {
+            snprintf(wallTimeText, sizeof(wallTimeText), "%s", isJson ? "null" : "");
+        }
+
+        if (isJson) {
+            printJsonRecord(&record, wallTimeText);
+        } else {
+            printCsvRecord(&record, wallTimeText);
+        }
+    }
+
+    munmap((void *)mapping, (size_t)fileStat.st_size);
+
+    return 0;
+}
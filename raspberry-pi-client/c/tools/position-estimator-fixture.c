@@ -0,0 +1,115 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../position-estimator.h"
+
+#define FIXTURE_ORIGIN_LATITUDE 50.4501
+#define FIXTURE_ORIGIN_LONGITUDE 30.5234
+#define FIXTURE_DEFAULT_DURATION_S 30.0
+#define FIXTURE_DEFAULT_SEED 1
+#define FIXTURE_IMU_RATE_HZ POSITION_ESTIMATOR_RATE_HZ
+#define FIXTURE_GPS_RATE_HZ 1
+#define FIXTURE_TRUTH_RATE_HZ 10
+#define FIXTURE_CRUISE_SPEED 3.0
+#define FIXTURE_ACCELERATION_S 3.0
+#define FIXTURE_STRAIGHT_S 6.0
+#define FIXTURE_TURN_RATE 20.0
+#define FIXTURE_GYRO_NOISE 0.5
+#define FIXTURE_ACCEL_NOISE 0.2
+#define FIXTURE_GPS_POSITION_NOISE 2.0
+#define FIXTURE_GPS_SPEED_NOISE 0.2
+#define FIXTURE_GPS_TRACK_NOISE 3.0
+
+static unsigned int fixtureSeed = FIXTURE_DEFAULT_SEED;
+
+static double gaussian(double sigma) {
+    const double u1 = (rand_r(&fixtureSeed) + 1.0) / ((double)RAND_MAX + 2.0);
+    const double u2 = (rand_r(&fixtureSeed) + 1.0) / ((double)RAND_MAX + 2.0);
+
+    return sigma * sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+static double getForwardAcceleration(double timestamp) {
+    return timestamp < FIXTURE_ACCELERATION_S ? FIXTURE_CRUISE_SPEED / FIXTURE_ACCELERATION_S : 0.0;
+}
+
+static double getYawRate(double timestamp) {
+    return timestamp < FIXTURE_STRAIGHT_S ? 0.0 : FIXTURE_TURN_RATE;
+}
+
+static void toLatitudeLongitude(double x, double y, double *latitude, double *longitude) {
+    const double metersPerDegree = POSITION_ESTIMATOR_EARTH_RADIUS * M_PI / 180.0;
+
+    *latitude = FIXTURE_ORIGIN_LATITUDE + y / metersPerDegree;
+    *longitude = FIXTURE_ORIGIN_LONGITUDE + x / (metersPerDegree * cos(FIXTURE_ORIGIN_LATITUDE * M_PI / 180.0));
+}
+
+static double getTrack(double heading) {
+    const double track = fmod(90.0 - heading * 180.0 / M_PI, 360.0);
+
+    return track < 0.0 ? track + 360.0 : track;
+}
+
+int main(int argc, char **argv) {
+    double duration = FIXTURE_DEFAULT_DURATION_S;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--duration") == 0 && i + 1 < argc) {
+            duration = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            fixtureSeed = (unsigned int)atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "Usage: %s [--duration seconds] [--seed n] > replay.csv\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (duration <= 0.0) {
+        fprintf(stderr, "Duration must be positive\n");
+        return 1;
+    }
+
+    const double dt = 1.0 / FIXTURE_IMU_RATE_HZ;
+    const long steps = lround(duration * FIXTURE_IMU_RATE_HZ);
+    const long gpsEvery = FIXTURE_IMU_RATE_HZ / FIXTURE_GPS_RATE_HZ;
+    const long truthEvery = FIXTURE_IMU_RATE_HZ / FIXTURE_TRUTH_RATE_HZ;
+    double x = 0.0;
+    double y = 0.0;
+    double heading = 0.0;
+    double speed = 0.0;
+
+    for (long step = 0; step <= steps; step++) {
+        const double timestamp = step * dt;
+        const double yawRate = getYawRate(timestamp);
+        const double forwardAcceleration = getForwardAcceleration(timestamp);
+        double latitude;
+        double longitude;
+
+        printf("imu,%.3f,%.4f,%.4f\n", timestamp, yawRate + gaussian(FIXTURE_GYRO_NOISE), forwardAcceleration + gaussian(FIXTURE_ACCEL_NOISE));
+
+        if (step > 0 && step % gpsEvery == 0) {
+            toLatitudeLongitude(x + gaussian(FIXTURE_GPS_POSITION_NOISE), y + gaussian(FIXTURE_GPS_POSITION_NOISE), &latitude, &longitude);
+            printf(
+                "gps,%.3f,%.8f,%.8f,%.3f,%.2f\n",
+                timestamp,
+                latitude,
+                longitude,
+                fmax(0.0, speed + gaussian(FIXTURE_GPS_SPEED_NOISE)),
+                getTrack(heading + gaussian(FIXTURE_GPS_TRACK_NOISE) * M_PI / 180.0)
+            );
+        }
+
+        if (step % truthEvery == 0) {
+            toLatitudeLongitude(x, y, &latitude, &longitude);
+            printf("truth,%.3f,%.8f,%.8f\n", timestamp, latitude, longitude);
+        }
+
+        x += speed * cos(heading) * dt;
+        y += speed * sin(heading) * dt;
+        heading += yawRate * M_PI / 180.0 * dt;
+        speed += forwardAcceleration * dt;
+    }
+
+    return 0;
+}
@@ -0,0 +1,129 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../position-estimator.h"
+
+#define REPLAY_LINE_SIZE 256
+
+typedef struct {
+    long count;
+    long totalNs;
+    long maxNs;
+} ReplayCost;
+
+typedef struct {
+    long count;
+    double sumSquares;
+} ReplayError;
+
+static long nowNs() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000000L + now.tv_nsec;
+}
+
+static void addCost(ReplayCost *cost, long elapsedNs) {
+    cost->count++;
+    cost->totalNs += elapsedNs;
+    if (elapsedNs > cost->maxNs) {
+        cost->maxNs = elapsedNs;
+    }
+}
+
+static double distanceMeters(double latitudeA, double longitudeA, double latitudeB, double longitudeB) {
+    const double metersPerDegree = POSITION_ESTIMATOR_EARTH_RADIUS * M_PI / 180.0;
+    const double dx = (longitudeA - longitudeB) * metersPerDegree * cos(latitudeA * M_PI / 180.0);
+    const double dy = (latitudeA - latitudeB) * metersPerDegree;
+    return sqrt(dx * dx + dy * dy);
+}
+
+static void addError(ReplayError *error, double meters) {
+    error->count++;
+    error->sumSquares += meters * meters;
+}
+
+static double rms(const ReplayError *error) {
+    return error->count > 0 ? sqrt(error->sumSquares / error->count) : 0.0;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <replay.csv>\n", argv[0]);
+        fprintf(stderr, "  imu,<seconds>,<yaw rate deg/s>,<forward acceleration m/s^2>\n");
+        fprintf(stderr, "  gps,<seconds>,<latitude>,<longitude>,<speed m/s>,<track deg>\n");
+        fprintf(stderr, "  truth,<seconds>,<latitude>,<longitude>\n");
+        return 1;
+    }
+
+    FILE *file = fopen(argv[1], "r");
+    if (file == NULL) {
+        perror("fopen");
+        return 1;
+    }
+
+    PositionEstimator estimator;
+    ReplayCost predictCost = {0};
+    ReplayCost gpsCost = {0};
+    ReplayError estimateError = {0};
+    ReplayError gpsError = {0};
+    char line[REPLAY_LINE_SIZE];
+    double lastImuAt = -1.0;
+    double lastGpsLatitude = NAN;
+    double lastGpsLongitude = NAN;
+
+    resetPositionEstimator(&estimator);
+
+    while (fgets(line, sizeof(line), file) != NULL) {
+        double timestamp;
+        double a;
+        double b;
+        double c;
+        double d;
+
+        if (sscanf(line, "imu,%lf,%lf,%lf", &timestamp, &a, &b) == 3) {
+            if (lastImuAt >= 0.0) {
+                const long startedAtNs = nowNs();
+                predictPositionEstimator(&estimator, (float)a, (float)b, (float)(timestamp - lastImuAt));
+                addCost(&predictCost, nowNs() - startedAtNs);
+            }
+            lastImuAt = timestamp;
+        } else if (sscanf(line, "gps,%lf,%lf,%lf,%lf,%lf", &timestamp, &a, &b, &c, &d) == 5) {
+            const long startedAtNs = nowNs();
+            updatePositionEstimatorWithGps(&estimator, a, b, (float)c, (float)d, true);
+            addCost(&gpsCost, nowNs() - startedAtNs);
+            lastGpsLatitude = a;
+            lastGpsLongitude = b;
+        } else if (sscanf(line, "truth,%lf,%lf,%lf", &timestamp, &a, &b) == 3) {
+            PositionEstimate estimate;
+
+            if (getPositionEstimate(&estimator, &estimate)) {
+                addError(&estimateError, distanceMeters(estimate.latitude, estimate.longitude, a, b));
+            }
+
+            if (isfinite(lastGpsLatitude)) {
+                addError(&gpsError, distanceMeters(lastGpsLatitude, lastGpsLongitude, a, b));
+            }
+        }
+    }
+
+    fclose(file);
+
+    printf(
+        "{\"predictions\":%ld,\"predictAvgNs\":%ld,\"predictMaxNs\":%ld,"
+        "\"gpsUpdates\":%ld,\"gpsUpdateAvgNs\":%ld,\"gpsUpdateMaxNs\":%ld,"
+        "\"estimateRmsErrorM\":%.3f,\"gpsHoldRmsErrorM\":%.3f,\"truthSamples\":%ld}\n",
+        predictCost.count,
+        predictCost.count > 0 ? predictCost.totalNs / predictCost.count : 0,
+        predictCost.maxNs,
+        gpsCost.count,
+        gpsCost.count > 0 ? gpsCost.totalNs / gpsCost.count : 0,
+        gpsCost.maxNs,
+        rms(&estimateError),
+        rms(&gpsError),
+        estimateError.count
+    );
+
+    return 0;
+}
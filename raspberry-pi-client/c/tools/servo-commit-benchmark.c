@@ -0,0 +1,170 @@
+#include <pigpio.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../rc-car.h"
+#include "../servo-wave.h"
+
+#define SERVO_COMMIT_BENCHMARK_DEFAULT_FRAMES 200000L
+#define SERVO_COMMIT_BENCHMARK_CHANNEL_COUNT 4
+#define SERVO_COMMIT_BENCHMARK_BASE_PULSE_WIDTH 1000
+#define SERVO_COMMIT_BENCHMARK_CHANNEL_SPACING 100
+#define SERVO_COMMIT_BENCHMARK_FRAME_STEPS 800
+
+typedef void (*ServoCommitPath)(long frame);
+
+typedef struct {
+    const char *name;
+    ServoCommitPath commit;
+} ServoCommitBenchmark;
+
+typedef struct {
+    long snapshots;
+    long tornSnapshots;
+} TearCounters;
+
+static const unsigned benchmarkPins[SERVO_COMMIT_BENCHMARK_CHANNEL_COUNT] = {
+    CAR_TURNS_SERVO_PIN,
+    CAR_ESC_PIN,
+    CAR_CAMERA_GIMBAL_PIN4,
+    CAR_CAMERA_GIMBAL_PIN3
+};
+
+static ServoWave benchmarkWave;
+static atomic_bool isSampling = false;
+
+static long nowNs() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000000L + now.tv_nsec;
+}
+
+static int getFramePulseWidth(long frame, int channel) {
+    return SERVO_COMMIT_BENCHMARK_BASE_PULSE_WIDTH
+        + (int)(frame % SERVO_COMMIT_BENCHMARK_FRAME_STEPS)
+        + channel * SERVO_COMMIT_BENCHMARK_CHANNEL_SPACING;
+}
+
+static void commitPerPin(long frame) {
+    for (int i = 0; i < SERVO_COMMIT_BENCHMARK_CHANNEL_COUNT; i++) {
+        gpioServo(benchmarkPins[i], (unsigned)getFramePulseWidth(frame, i));
+    }
+}
+
+static void commitWaveform(long frame) {
+    for (int i = 0; i < SERVO_COMMIT_BENCHMARK_CHANNEL_COUNT; i++) {
+        setServoWavePulseWidth(&benchmarkWave, (int)benchmarkPins[i], getFramePulseWidth(frame, i));
+    }
+
+    if (commitServoWave(&benchmarkWave) < 0) {
+        fprintf(stderr, "Failed to commit servo waveform\n");
+        exit(1);
+    }
+}
+
+static const ServoCommitBenchmark benchmarks[] = {
+    {"perPinServo", commitPerPin},
+    {"waveform", commitWaveform}
+};
+
+static void *sampleServoOutputs(void *arg) {
+    TearCounters *counters = arg;
+    int pulseWidths[SERVO_COMMIT_BENCHMARK_CHANNEL_COUNT];
+
+    while (atomic_load_explicit(&isSampling, memory_order_relaxed)) {
+        gpioSimulatedServoSnapshot(benchmarkPins, pulseWidths, SERVO_COMMIT_BENCHMARK_CHANNEL_COUNT);
+        counters->snapshots++;
+
+        for (int i = 1; i < SERVO_COMMIT_BENCHMARK_CHANNEL_COUNT; i++) {
+            if (pulseWidths[i] - i * SERVO_COMMIT_BENCHMARK_CHANNEL_SPACING != pulseWidths[0]) {
+                counters->tornSnapshots++;
+                break;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+static void resetOutputs() {
+    gpioWaveTxStop();
+    commitPerPin(0);
+    initServoWave(&benchmarkWave);
+
+    for (int i = 0; i < SERVO_COMMIT_BENCHMARK_CHANNEL_COUNT; i++) {
+        addServoWaveChannel(&benchmarkWave, (int)benchmarkPins[i], getFramePulseWidth(0, i));
+    }
+}
+
+static void runBenchmark(const ServoCommitBenchmark *benchmark, long frames, bool isLast) {
+    TearCounters counters = {0, 0};
+    pthread_t sampler;
+
+    resetOutputs();
+    const long servoWritesBefore = gpioSimulatedServoWriteCount();
+    const long waveSendsBefore = gpioSimulatedWaveSendCount();
+    const long startedAtNs = nowNs();
+
+    for (long frame = 1; frame <= frames; frame++) {
+        benchmark->commit(frame);
+    }
+
+    const long elapsedNs = nowNs() - startedAtNs;
+    const long backendCalls = gpioSimulatedServoWriteCount() - servoWritesBefore + gpioSimulatedWaveSendCount() - waveSendsBefore;
+
+    atomic_store(&isSampling, true);
+    if (pthread_create(&sampler, NULL, sampleServoOutputs, &counters) != 0) {
+        fprintf(stderr, "Failed to start sampler\n");
+        exit(1);
+    }
+    for (long frame = 1; frame <= frames; frame++) {
+        benchmark->commit(frame);
+    }
+    atomic_store(&isSampling, false);
+    pthread_join(sampler, NULL);
+    releaseServoWave(&benchmarkWave);
+
+    printf(
+        "    {\"name\": \"%s\", \"frames\": %ld, \"nsPerFrame\": %.1f, \"backendCallsPerFrame\": %.2f, "
+        "\"snapshots\": %ld, \"tornSnapshots\": %ld, \"tornFraction\": %.6f}%s\n",
+        benchmark->name,
+        frames,
+        (double)elapsedNs / frames,
+        (double)backendCalls / frames,
+        counters.snapshots,
+        counters.tornSnapshots,
+        counters.snapshots > 0 ? (double)counters.tornSnapshots / counters.snapshots : 0.0,
+        isLast ? "" : ","
+    );
+}
+
+int main(int argc, char **argv) {
+    long frames = SERVO_COMMIT_BENCHMARK_DEFAULT_FRAMES;
+    const int benchmarkCount = (int)(sizeof(benchmarks) / sizeof(benchmarks[0]));
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = atol(argv[++i]);
+        } else {
+            fprintf(stderr, "Usage: %s [--frames count]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (frames <= 0) {
+        fprintf(stderr, "Frame count must be positive\n");
+        return 1;
+    }
+
+    printf("{\n  \"benchmark\": \"servo-commit\",\n  \"channels\": %d,\n  \"results\": [\n", SERVO_COMMIT_BENCHMARK_CHANNEL_COUNT);
+    for (int i = 0; i < benchmarkCount; i++) {
+        runBenchmark(&benchmarks[i], frames, i == benchmarkCount - 1);
+    }
+    printf("  ]\n}\n");
+
+    return 0;
+}
@@ -0,0 +1,45 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "../state-bus.h"
+
+int main(int argc, char **argv) {
+    const char *name = argc > 1 ? argv[1] : STATE_BUS_DEFAULT_NAME;
+    const int rateHz = argc > 2 && atoi(argv[2]) > 0 ? atoi(argv[2]) : 10;
+    StateBusReader reader;
+    CarState state;
+    uint32_t sequence;
+
+    if (openStateBusReader(&reader, name) != 0) {
+        fprintf(stderr, "Failed to open state bus %s\n", name);
+        return 1;
+    }
+
+    while (1) {
+        if (readStateBus(&reader, &state, &sequence)) {
+            printf(
+                "seq=%u steering=%d esc=%d yaw=%d pitch=%d lat=%.7f lon=%.7f fix=%d speed=%.2f yawRate=%.2f correction=%.2f correctionYawRate=%.2f heading=%.1f\n",
+                sequence,
+                state.steeringPulseWidth,
+                state.escPulseWidth,
+                state.gimbalYawPulseWidth,
+                state.gimbalPitchPulseWidth,
+                state.estimatedLatitude != 0.0 ? state.estimatedLatitude : state.latitude,
+                state.estimatedLongitude != 0.0 ? state.estimatedLongitude : state.longitude,
+                state.fixMode,
+                state.speed,
+                state.yawRate,
+                state.correctionAngle,
+                state.correctionYawRate,
+                state.estimatedHeading
+            );
+            fflush(stdout);
+        }
+
+        usleep(1000000 / rateHz);
+    }
+
+    closeStateBusReader(&reader);
+
+    return 0;
+}
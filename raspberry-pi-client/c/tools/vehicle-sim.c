@@ -0,0 +1,327 @@
+#define _GNU_SOURCE
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+#include "../rc-car.h"
+#include "../state-bus.h"
+#include "../vehicle-sim.h"
+
+#define VEHICLE_SIM_DEFAULT_RATE_HZ 200
+#define VEHICLE_SIM_DEFAULT_PORT 2947
+#define VEHICLE_SIM_DEFAULT_REGISTERS "/rc-car-mpu6050"
+#define VEHICLE_SIM_MAX_CLIENTS 8
+#define VEHICLE_SIM_REPORT_SIZE 512
+#define VEHICLE_SIM_STATUS_INTERVAL_US 5000000L
+
+typedef struct {
+    int fd;
+    bool isWatching;
+} GpsdClient;
+
+static volatile sig_atomic_t isRunning = 1;
+static GpsdClient clients[VEHICLE_SIM_MAX_CLIENTS];
+
+static void onSignal(int signal) {
+    isRunning = 0;
+}
+
+static Mpu6050RegisterSegment *createRegisterSegment(const char *name) {
+    const int fd = shm_open(name, O_CREAT | O_RDWR, 0644);
+    if (fd < 0) {
+        perror("shm_open");
+        return NULL;
+    }
+
+    if (ftruncate(fd, sizeof(Mpu6050RegisterSegment)) != 0) {
+        perror("ftruncate");
+        close(fd);
+        return NULL;
+    }
+
+    void *mapping = mmap(NULL, sizeof(Mpu6050RegisterSegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (mapping == MAP_FAILED) {
+        perror("mmap");
+        return NULL;
+    }
+
+    Mpu6050RegisterSegment *segment = (Mpu6050RegisterSegment *)mapping;
+    segment->sequence = 0;
+    segment->magic = MPU6050_SIMULATED_MAGIC;
+
+    return segment;
+}
+
+static void publishRegisters(Mpu6050RegisterSegment *segment, const VehicleSim *sim) {
+    _Atomic uint32_t *sequence = (_Atomic uint32_t *)&segment->sequence;
+    const uint32_t current = atomic_load_explicit(sequence, memory_order_relaxed);
+
+    atomic_store_explicit(sequence, current + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    memcpy(segment->registers, sim->registers, MPU6050_REGISTER_COUNT);
+    atomic_store_explicit(sequence, current + 2, memory_order_release);
+}
+
+static int openGpsdListener(int port) {
+    const int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    const int reuse = 1;
+    struct sockaddr_in address;
+
+    if (fd < 0) {
+        perror("socket");
+        return -1;
+    }
+
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons((uint16_t)port);
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    if (bind(fd, (struct sockaddr *)&address, sizeof(address)) != 0 || listen(fd, VEHICLE_SIM_MAX_CLIENTS) != 0) {
+        perror("bind");
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+static void sendToClient(GpsdClient *client, const char *message) {
+    if (send(client->fd, message, strlen(message), MSG_NOSIGNAL | MSG_DONTWAIT) < 0 && errno != EAGAIN) {
+        close(client->fd);
+        client->fd = -1;
+    }
+}
+
+static void acceptGpsdClients(int listenerFd) {
+    int fd;
+
+    while ((fd = accept4(listenerFd, NULL, NULL, SOCK_NONBLOCK)) >= 0) {
+        GpsdClient *client = NULL;
+
+        for (int i = 0; i < VEHICLE_SIM_MAX_CLIENTS && client == NULL; i++) {
+            if (clients[i].fd < 0) {
+                client = &clients[i];
+            }
+        }
+
+        if (client == NULL) {
+            close(fd);
+            continue;
+        }
+
+        client->fd = fd;
+        client->isWatching = false;
+        sendToClient(client, "{\"class\":\"VERSION\",\"release\":\"3.22\",\"rev\":\"vehiclesim\",\"proto_major\":3,\"proto_minor\":14}\r\n");
+    }
+}
+
+static void readGpsdCommands() {
+    char buffer[VEHICLE_SIM_REPORT_SIZE];
+
+    for (int i = 0; i < VEHICLE_SIM_MAX_CLIENTS; i++) {
+        GpsdClient *client = &clients[i];
+
+        if (client->fd < 0) {
+            continue;
+        }
+
+        const ssize_t length = recv(client->fd, buffer, sizeof(buffer) - 1, MSG_DONTWAIT);
+
+        if (length == 0 || (length < 0 && errno != EAGAIN)) {
+            close(client->fd);
+            client->fd = -1;
+            continue;
+        }
+
+        if (length < 0) {
+            continue;
+        }
+
+        buffer[length] = '\0';
+
+        if (strstr(buffer, "?WATCH") != NULL) {
+            client->isWatching = strstr(buffer, "\"enable\":false") == NULL;
+            sendToClient(client, "{\"class\":\"DEVICES\",\"devices\":[{\"class\":\"DEVICE\",\"path\":\"/dev/vehiclesim\",\"driver\":\"vehiclesim\",\"activated\":\"2026-01-01T00:00:00.000Z\"}]}\r\n");
+            if (client->fd >= 0) {
+                sendToClient(client, client->isWatching ? "{\"class\":\"WATCH\",\"enable\":true,\"json\":true}\r\n" : "{\"class\":\"WATCH\",\"enable\":false}\r\n");
+            }
+        }
+    }
+}
+
+static void broadcastGpsFix(const VehicleSimGpsFix *fix) {
+    char report[VEHICLE_SIM_REPORT_SIZE];
+
+    formatVehicleSimGpsReport(fix, report, sizeof(report));
+
+    for (int i = 0; i < VEHICLE_SIM_MAX_CLIENTS; i++) {
+        if (clients[i].fd >= 0 && clients[i].isWatching) {
+            sendToClient(&clients[i], report);
+        }
+    }
+}
+
+static void addTimespecUs(struct timespec *time, long us) {
+    time->tv_nsec += us * 1000L;
+    while (time->tv_nsec >= 1000000000L) {
+        time->tv_nsec -= 1000000000L;
+        time->tv_sec++;
+    }
+}
+
+static void printUsage(const char *program) {
+    fprintf(
+        stderr,
+        "Usage: %s [--state-bus name] [--registers name] [--port n] [--rate hz] [--origin lat lon] [--heading deg]\n"
+        "          [--gps-rate hz] [--gps-noise m] [--gps-latency-ms ms] [--gyro-noise deg/s] [--gyro-bias deg/s]\n"
+        "          [--imu-latency-ms ms] [--seed n]\n",
+        program
+    );
+}
+
+int main(int argc, char **argv) {
+    const char *stateBusName = STATE_BUS_DEFAULT_NAME;
+    const char *registersName = VEHICLE_SIM_DEFAULT_REGISTERS;
+    int port = VEHICLE_SIM_DEFAULT_PORT;
+    int rateHz = VEHICLE_SIM_DEFAULT_RATE_HZ;
+    VehicleSimConfig config;
+    VehicleSim sim;
+    StateBusReader reader = {NULL};
+    CarState state;
+
+    initVehicleSimConfig(&config);
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--state-bus") == 0 && i + 1 < argc) {
+            stateBusName = argv[++i];
+        } else if (strcmp(argv[i], "--registers") == 0 && i + 1 < argc) {
+            registersName = argv[++i];
+        } else if (strcmp(argv[i], "--port") == 0 && i + 1 < argc) {
+            port = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--rate") == 0 && i + 1 < argc) {
+            rateHz = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--origin") == 0 && i + 2 < argc) {
+            config.originLatitude = atof(argv[++i]);
+            config.originLongitude = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--heading") == 0 && i + 1 < argc) {
+            config.initialHeading = (float)atof(argv[++i]);
+        } else if (strcmp(argv[i], "--gps-rate") == 0 && i + 1 < argc) {
+            config.gpsRateHz = (float)atof(argv[++i]);
+        } else if (strcmp(argv[i], "--gps-noise") == 0 && i + 1 < argc) {
+            config.gpsPositionNoise = (float)atof(argv[++i]);
+        } else if (strcmp(argv[i], "--gps-latency-ms") == 0 && i + 1 < argc) {
+            config.gpsLatencyMs = (float)atof(argv[++i]);
+        } else if (strcmp(argv[i], "--gyro-noise") == 0 && i + 1 < argc) {
+            config.gyroNoise = (float)atof(argv[++i]);
+        } else if (strcmp(argv[i], "--gyro-bias") == 0 && i + 1 < argc) {
+            config.gyroBias = (float)atof(argv[++i]);
+        } else if (strcmp(argv[i], "--imu-latency-ms") == 0 && i + 1 < argc) {
+            config.imuLatencyMs = (float)atof(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            config.seed = (unsigned int)atoi(argv[++i]);
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (rateHz <= 0) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    Mpu6050RegisterSegment *segment = createRegisterSegment(registersName);
+    const int listenerFd = openGpsdListener(port);
+
+    if (segment == NULL || listenerFd < 0) {
+        return 1;
+    }
+
+    for (int i = 0; i < VEHICLE_SIM_MAX_CLIENTS; i++) {
+        clients[i].fd = -1;
+    }
+
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+
+    resetVehicleSim(&sim, &config);
+    publishRegisters(segment, &sim);
+
+    printf("Simulating at %d Hz, MPU6050 registers in %s, gpsd on 127.0.0.1:%d\n", rateHz, registersName, port);
+    printf("Run the car with MPU6050_SIM=%s GPS_SOURCE=socket GPSD_HOST=127.0.0.1 GPSD_PORT=%d\n", registersName, port);
+
+    const long periodUs = 1000000L / rateHz;
+    const float dt = (float)periodUs / 1e6f;
+    long nextStatusAtUs = VEHICLE_SIM_STATUS_INTERVAL_US;
+    struct timespec deadline;
+    VehicleSimGpsFix fix;
+
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+
+    while (isRunning) {
+        if (reader.segment == NULL && sim.timeUs % 1000000L < periodUs && openStateBusReader(&reader, stateBusName) == 0) {
+            printf("Reading actuators from state bus %s\n", stateBusName);
+        }
+
+        if (reader.segment != NULL && readStateBus(&reader, &state, NULL)) {
+            setVehicleSimPulseWidth(&sim, CAR_TURNS_SERVO_PIN, state.steeringPulseWidth);
+            setVehicleSimPulseWidth(&sim, CAR_ESC_PIN, state.escPulseWidth);
+        }
+
+        stepVehicleSim(&sim, dt);
+        publishRegisters(segment, &sim);
+
+        acceptGpsdClients(listenerFd);
+        readGpsdCommands();
+        while (pollVehicleSimGpsFix(&sim, &fix)) {
+            broadcastGpsFix(&fix);
+        }
+
+        if (sim.timeUs >= nextStatusAtUs) {
+            double heading = fmod(sim.heading * 180.0 / M_PI, 360.0);
+            printf(
+                "t=%.1f x=%.2f y=%.2f heading=%.1f speed=%.2f steering=%.1f yawRate=%.1f\n",
+                sim.timeUs / 1e6,
+                sim.x,
+                sim.y,
+                heading < 0.0 ? heading + 360.0 : heading,
+                sim.speed,
+                sim.steeringAngle,
+                sim.yawRate
+            );
+            fflush(stdout);
+            nextStatusAtUs += VEHICLE_SIM_STATUS_INTERVAL_US;
+        }
+
+        addTimespecUs(&deadline, periodUs);
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL);
+    }
+
+    for (int i = 0; i < VEHICLE_SIM_MAX_CLIENTS; i++) {
+        if (clients[i].fd >= 0) {
+            close(clients[i].fd);
+        }
+    }
+
+    close(listenerFd);
+    closeStateBusReader(&reader);
+    munmap(segment, sizeof(Mpu6050RegisterSegment));
+    shm_unlink(registersName);
+
+    return 0;
+}
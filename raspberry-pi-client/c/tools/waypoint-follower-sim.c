@@ -0,0 +1,194 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../position-estimator.h"
+#include "../pure-pursuit.h"
+
+#define SIM_RATE_HZ 50
+#define SIM_GPS_RATE_HZ 10
+#define SIM_MAX_SECONDS 600
+#define SIM_MAX_SPEED 5.0f
+#define SIM_THROTTLE_TIME_CONSTANT 0.5f
+#define SIM_ORIGIN_LATITUDE 50.4501
+#define SIM_ORIGIN_LONGITUDE 30.5234
+#define SIM_LINE_SIZE 128
+
+typedef struct {
+    double x;
+    double y;
+    double heading;
+    float speed;
+} SimVehicle;
+
+static double metersPerDegreeLatitude() {
+    return POSITION_ESTIMATOR_EARTH_RADIUS * M_PI / 180.0;
+}
+
+static double metersPerDegreeLongitude() {
+    return metersPerDegreeLatitude() * cos(SIM_ORIGIN_LATITUDE * M_PI / 180.0);
+}
+
+static float gaussian(float sigma) {
+    const double u1 = (rand() + 1.0) / (RAND_MAX + 2.0);
+    const double u2 = (rand() + 1.0) / (RAND_MAX + 2.0);
+    return (float)(sigma * sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2));
+}
+
+static int loadWaypoints(const char *path, Waypoint *waypoints) {
+    char line[SIM_LINE_SIZE];
+    int count = 0;
+
+    if (path == NULL) {
+        const double square[][2] = {{0, 30}, {30, 30}, {30, 0}, {0, 0}};
+        for (int i = 0; i < 4; i++) {
+            waypoints[i].latitude = SIM_ORIGIN_LATITUDE + square[i][1] / metersPerDegreeLatitude();
+            waypoints[i].longitude = SIM_ORIGIN_LONGITUDE + square[i][0] / metersPerDegreeLongitude();
+        }
+        return 4;
+    }
+
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        perror(path);
+        return -1;
+    }
+
+    while (count < PURE_PURSUIT_MAX_WAYPOINTS && fgets(line, sizeof(line), file) != NULL) {
+        if (sscanf(line, "%lf %lf", &waypoints[count].latitude, &waypoints[count].longitude) == 2) {
+            count++;
+        }
+    }
+
+    fclose(file);
+
+    return count;
+}
+
+static double segmentDistance(double px, double py, double ax, double ay, double bx, double by) {
+    const double dx = bx - ax;
+    const double dy = by - ay;
+    const double lengthSquared = dx * dx + dy * dy;
+    double t = lengthSquared > 0.0 ? ((px - ax) * dx + (py - ay) * dy) / lengthSquared : 0.0;
+
+    t = t < 0.0 ? 0.0 : (t > 1.0 ? 1.0 : t);
+
+    return hypot(px - (ax + t * dx), py - (ay + t * dy));
+}
+
+static double crossTrackError(const SimVehicle *vehicle, const PurePursuitPath *path) {
+    double best = INFINITY;
+
+    for (int i = 1; i < path->count; i++) {
+        const double ax = (path->waypoints[i - 1].longitude - SIM_ORIGIN_LONGITUDE) * metersPerDegreeLongitude();
+        const double ay = (path->waypoints[i - 1].latitude - SIM_ORIGIN_LATITUDE) * metersPerDegreeLatitude();
+        const double bx = (path->waypoints[i].longitude - SIM_ORIGIN_LONGITUDE) * metersPerDegreeLongitude();
+        const double by = (path->waypoints[i].latitude - SIM_ORIGIN_LATITUDE) * metersPerDegreeLatitude();
+        const double distance = segmentDistance(vehicle->x, vehicle->y, ax, ay, bx, by);
+
+        if (distance < best) {
+            best = distance;
+        }
+    }
+
+    return best;
+}
+
+int main(int argc, char **argv) {
+    const char *waypointPath = NULL;
+    float speedPercent = 40.0f;
+    float gpsNoise = 1.0f;
+    float gyroNoise = 0.5f;
+    Waypoint waypoints[PURE_PURSUIT_MAX_WAYPOINTS];
+    PurePursuitConfig config;
+    PurePursuitPath path;
+    PositionEstimator estimator;
+    PositionEstimate estimate;
+    SimVehicle vehicle = {0.0, 0.0, 0.0, 0.0f};
+    const float dt = 1.0f / SIM_RATE_HZ;
+    double errorSquares = 0.0;
+    double maxError = 0.0;
+    long steps = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc) {
+            speedPercent = (float)atof(argv[++i]);
+        } else if (strcmp(argv[i], "--gps-noise") == 0 && i + 1 < argc) {
+            gpsNoise = (float)atof(argv[++i]);
+        } else if (strcmp(argv[i], "--gyro-noise") == 0 && i + 1 < argc) {
+            gyroNoise = (float)atof(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            srand((unsigned int)atoi(argv[++i]));
+        } else if (argv[i][0] != '-') {
+            waypointPath = argv[i];
+        } else {
+            fprintf(stderr, "Usage: %s [waypoints-file] [--speed percent] [--gps-noise m] [--gyro-noise deg/s] [--seed n]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    const int count = loadWaypoints(waypointPath, waypoints);
+    if (count <= 0) {
+        fprintf(stderr, "No waypoints\n");
+        return 1;
+    }
+
+    Waypoint start = {SIM_ORIGIN_LATITUDE, SIM_ORIGIN_LONGITUDE};
+    initPurePursuitConfig(&config);
+    resetPurePursuitPath(&path, &start, waypoints, count);
+    resetPositionEstimator(&estimator);
+    updatePositionEstimatorWithGps(&estimator, SIM_ORIGIN_LATITUDE, SIM_ORIGIN_LONGITUDE, 0.0f, 0.0f, false);
+
+    const float targetSpeed = speedPercent / 100.0f * SIM_MAX_SPEED;
+    float steeringAngle = 0.0f;
+
+    for (steps = 0; steps < SIM_MAX_SECONDS * SIM_RATE_HZ; steps++) {
+        if (!getPositionEstimate(&estimator, &estimate) || !computePurePursuitSteering(&path, &config, &estimate, &steeringAngle)) {
+            break;
+        }
+
+        const float acceleration = (targetSpeed - vehicle.speed) / SIM_THROTTLE_TIME_CONSTANT;
+        const float yawRate = vehicle.speed / config.wheelbase * tanf(steeringAngle * (float)M_PI / 180.0f);
+
+        vehicle.speed += acceleration * dt;
+        vehicle.heading -= yawRate * dt;
+        vehicle.x += vehicle.speed * sin(vehicle.heading) * dt;
+        vehicle.y += vehicle.speed * cos(vehicle.heading) * dt;
+
+        predictPositionEstimator(&estimator, yawRate * 180.0f / (float)M_PI + gaussian(gyroNoise), acceleration + gaussian(0.2f), dt);
+
+        if (steps % (SIM_RATE_HZ / SIM_GPS_RATE_HZ) == 0) {
+            double track = fmod(vehicle.heading * 180.0 / M_PI, 360.0);
+            if (track < 0.0) {
+                track += 360.0;
+            }
+
+            updatePositionEstimatorWithGps(
+                &estimator,
+                SIM_ORIGIN_LATITUDE + (vehicle.y + gaussian(gpsNoise)) / metersPerDegreeLatitude(),
+                SIM_ORIGIN_LONGITUDE + (vehicle.x + gaussian(gpsNoise)) / metersPerDegreeLongitude(),
+                vehicle.speed + gaussian(0.1f),
+                (float)track,
+                vehicle.speed > POSITION_ESTIMATOR_MIN_TRACK_SPEED
+            );
+        }
+
+        const double error = crossTrackError(&vehicle, &path);
+        errorSquares += error * error;
+        if (error > maxError) {
+            maxError = error;
+        }
+    }
+
+    printf(
+        "%s after %.1f s, reached %d/%d waypoints, cross-track RMS %.2f m, max %.2f m\n",
+        path.targetIndex >= path.count ? "Completed" : "Stopped",
+        steps * dt,
+        path.targetIndex - 1,
+        path.count - 1,
+        steps > 0 ? sqrt(errorSquares / steps) : 0.0,
+        maxError
+    );
+
+    return path.targetIndex >= path.count ? 0 : 1;
+}
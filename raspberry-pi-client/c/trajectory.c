@@ -0,0 +1,320 @@
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "actuator.h"
+#include "rc-car.h"
+#include "trajectory.h"
+
+static const int trajectoryPins[TRAJECTORY_ACTUATOR_COUNT] = {
+    CAR_TURNS_SERVO_PIN,
+    CAR_ESC_PIN,
+    CAR_CAMERA_GIMBAL_PIN4,
+    CAR_CAMERA_GIMBAL_PIN3
+};
+
+static TrajectoryLimits trajectoryLimits[TRAJECTORY_ACTUATOR_COUNT];
+static TrajectoryLimits escReverseLimits;
+static _Atomic int trajectoryTargets[TRAJECTORY_ACTUATOR_COUNT];
+static bool isTrajectoryCut[TRAJECTORY_ACTUATOR_COUNT];
+static pthread_mutex_t trajectoryCommitMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_t trajectoryThreadHandle;
+static atomic_bool isTrajectoryEngineRunning = false;
+static int trajectoryRateHz = TRAJECTORY_DEFAULT_RATE_HZ;
+
+static float getTrajectoryLimit(const char *name) {
+    const char *value = getenv(name);
+    return value != NULL && atof(value) > 0.0 ? (float)atof(value) : 0.0f;
+}
+
+static void loadTrajectoryLimits(TrajectoryLimits *limits, const char *slewName, const char *accelerationName, const char *jerkName) {
+    limits->maxSlewRate = getTrajectoryLimit(slewName);
+    limits->maxAcceleration = getTrajectoryLimit(accelerationName);
+    limits->maxJerk = getTrajectoryLimit(jerkName);
+}
+
+static int getTrajectoryActuator(int pin) {
+    for (int i = 0; i < TRAJECTORY_ACTUATOR_COUNT; i++) {
+        if (trajectoryPins[i] == pin) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+static const TrajectoryLimits *getActiveTrajectoryLimits(int actuator, const TrajectoryAxis *axis, float target) {
+    if (actuator == TRAJECTORY_ESC) {
+        const float side = fabsf(axis->position - CAR_ESC_NEUTRAL_PWM) > 0.5f ? axis->position : target;
+        if (side < CAR_ESC_NEUTRAL_PWM) {
+            return &escReverseLimits;
+        }
+    }
+
+    return &trajectoryLimits[actuator];
+}
+
+bool hasTrajectoryLimits(const TrajectoryLimits *limits) {
+    return limits->maxSlewRate > 0.0f || limits->maxAcceleration > 0.0f || limits->maxJerk > 0.0f;
+}
+
+static float clampTrajectory(float value, float limit) {
+    if (limit <= 0.0f) {
+        return value;
+    }
+
+    return value > limit ? limit : (value < -limit ? -limit : value);
+}
+
+static float getBrakingDistance(float velocity, float acceleration, float maxAcceleration, float maxJerk) {
+    if (velocity <= 0.0f) {
+        return 0.0f;
+    }
+
+    const float rampTime = (acceleration + maxAcceleration) / maxJerk;
+    const float velocityAfterRamp = isinf(maxAcceleration) ? 0.0f : velocity + acceleration * rampTime - 0.5f * maxJerk * rampTime * rampTime;
+
+    if (velocityAfterRamp <= 0.0f) {
+        const float stopTime = (acceleration + sqrtf(acceleration * acceleration + 2.0f * maxJerk * velocity)) / maxJerk;
+        return velocity * stopTime + 0.5f * acceleration * stopTime * stopTime - maxJerk * stopTime * stopTime * stopTime / 6.0f;
+    }
+
+    return velocity * rampTime + 0.5f * acceleration * rampTime * rampTime - maxJerk * rampTime * rampTime * rampTime / 6.0f
+        + velocityAfterRamp * velocityAfterRamp / (2.0f * maxAcceleration);
+}
+
+static void stepJerkLimitedTrajectory(TrajectoryAxis *axis, const TrajectoryLimits *limits, float error, float dt) {
+    const float direction = error > 0.0f ? 1.0f : -1.0f;
+    const float distance = fabsf(error);
+    const float maxAcceleration = limits->maxAcceleration > 0.0f ? limits->maxAcceleration : INFINITY;
+    const float maxVelocity = limits->maxSlewRate > 0.0f ? limits->maxSlewRate : INFINITY;
+    const float jerkStep = limits->maxJerk * dt;
+    const float velocity = axis->velocity * direction;
+    const float acceleration = axis->acceleration * direction;
+    const float candidates[] = {
+        fminf(acceleration + jerkStep, maxAcceleration),
+        fmaxf(fminf(acceleration, maxAcceleration), -maxAcceleration),
+        fmaxf(acceleration - jerkStep, -maxAcceleration)
+    };
+    float nextAcceleration = candidates[2];
+    float nextVelocity;
+
+    for (int i = 0; i < 2; i++) {
+        nextVelocity = velocity + candidates[i] * dt;
+
+        if (nextVelocity + fmaxf(candidates[i], 0.0f) * candidates[i] / (2.0f * limits->maxJerk) > maxVelocity) {
+            continue;
+        }
+
+        if (getBrakingDistance(nextVelocity, candidates[i], maxAcceleration, limits->maxJerk) <= distance - nextVelocity * dt) {
+            nextAcceleration = candidates[i];
+            break;
+        }
+    }
+
+    nextVelocity = fminf(velocity + nextAcceleration * dt, maxVelocity);
+
+    if (velocity >= 0.0f && nextVelocity < 0.0f) {
+        nextVelocity = 0.0f;
+        nextAcceleration = 0.0f;
+    }
+
+    axis->acceleration = nextAcceleration * direction;
+    axis->velocity = nextVelocity * direction;
+}
+
+void stepTrajectory(TrajectoryAxis *axis, const TrajectoryLimits *limits, float target, float dt) {
+    const float error = target - axis->position;
+
+    if (!hasTrajectoryLimits(limits) || (fabsf(error) <= TRAJECTORY_SETTLE_PULSE_WIDTH && fabsf(axis->velocity * dt) <= TRAJECTORY_SETTLE_PULSE_WIDTH)) {
+        axis->position = target;
+        axis->velocity = 0.0f;
+        axis->acceleration = 0.0f;
+        return;
+    }
+
+    if (limits->maxJerk > 0.0f) {
+        stepJerkLimitedTrajectory(axis, limits, error, dt);
+
+        if (axis->velocity == 0.0f && axis->acceleration == 0.0f) {
+            axis->position = target;
+            return;
+        }
+    } else {
+        float desiredVelocity = error / dt;
+
+        if (limits->maxAcceleration > 0.0f) {
+            const float velocityStep = limits->maxAcceleration * dt;
+            desiredVelocity = clampTrajectory(desiredVelocity, velocityStep * (sqrtf(0.25f + 2.0f * fabsf(error) / (velocityStep * dt)) - 0.5f));
+        }
+        desiredVelocity = clampTrajectory(desiredVelocity, limits->maxSlewRate);
+
+        if (limits->maxAcceleration > 0.0f) {
+            axis->acceleration = clampTrajectory((desiredVelocity - axis->velocity) / dt, limits->maxAcceleration);
+            axis->velocity += axis->acceleration * dt;
+        } else {
+            axis->acceleration = 0.0f;
+            axis->velocity = desiredVelocity;
+        }
+    }
+
+    const float step = axis->velocity * dt;
+    if ((error > 0.0f && step > error) || (error < 0.0f && step < error)) {
+        axis->position = target;
+        axis->velocity = 0.0f;
+        axis->acceleration = 0.0f;
+    } else {
+        axis->position += step;
+    }
+}
+
+static void *trajectoryThread(void *arg) {
+    TrajectoryAxis axes[TRAJECTORY_ACTUATOR_COUNT];
+    int committedPulseWidths[TRAJECTORY_ACTUATOR_COUNT];
+    const long periodNs = 1000000000L / trajectoryRateHz;
+    const float dt = 1.0f / (float)trajectoryRateHz;
+    struct timespec nextTick;
+
+    for (int i = 0; i < TRAJECTORY_ACTUATOR_COUNT; i++) {
+        axes[i].position = (float)atomic_load(&trajectoryTargets[i]);
+        axes[i].velocity = 0.0f;
+        axes[i].acceleration = 0.0f;
+        committedPulseWidths[i] = (int)axes[i].position;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &nextTick);
+
+    while (atomic_load(&isTrajectoryEngineRunning)) {
+        pthread_mutex_lock(&trajectoryCommitMutex);
+
+        for (int i = 0; i < TRAJECTORY_ACTUATOR_COUNT; i++) {
+            const int target = atomic_load_explicit(&trajectoryTargets[i], memory_order_relaxed);
+
+            if (isTrajectoryCut[i]) {
+                isTrajectoryCut[i] = false;
+                axes[i].position = (float)target;
+                axes[i].velocity = 0.0f;
+                axes[i].acceleration = 0.0f;
+                committedPulseWidths[i] = target;
+                continue;
+            }
+
+            if (target == committedPulseWidths[i] && axes[i].velocity == 0.0f) {
+                continue;
+            }
+
+            if (committedPulseWidths[i] == 0) {
+                axes[i].position = (float)target;
+            }
+
+            stepTrajectory(&axes[i], getActiveTrajectoryLimits(i, &axes[i], (float)target), (float)target, dt);
+
+            const int pulseWidth = (int)lroundf(axes[i].position);
+            if (pulseWidth != committedPulseWidths[i]) {
+                commitServo(trajectoryPins[i], pulseWidth);
+                committedPulseWidths[i] = pulseWidth;
+            }
+        }
+
+        pthread_mutex_unlock(&trajectoryCommitMutex);
+
+        nextTick.tv_nsec += periodNs;
+        while (nextTick.tv_nsec >= 1000000000L) {
+            nextTick.tv_nsec -= 1000000000L;
+            nextTick.tv_sec++;
+        }
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &nextTick, NULL);
+    }
+
+    return NULL;
+}
+
+void setTrajectoryTarget(int pin, int pulseWidth) {
+    const int actuator = getTrajectoryActuator(pin);
+
+    if (actuator < 0 || !atomic_load(&isTrajectoryEngineRunning)) {
+        if (actuator >= 0) {
+            atomic_store_explicit(&trajectoryTargets[actuator], pulseWidth, memory_order_relaxed);
+        }
+        commitServo(pin, pulseWidth);
+        return;
+    }
+
+    atomic_store_explicit(&trajectoryTargets[actuator], pulseWidth, memory_order_relaxed);
+}
+
+int getTrajectoryTarget(int pin) {
+    const int actuator = getTrajectoryActuator(pin);
+
+    return actuator < 0 ? -1 : atomic_load_explicit(&trajectoryTargets[actuator], memory_order_relaxed);
+}
+
+bool replaceTrajectoryTarget(int pin, int expectedPulseWidth, int pulseWidth) {
+    const int actuator = getTrajectoryActuator(pin);
+
+    if (actuator < 0 || !atomic_compare_exchange_strong(&trajectoryTargets[actuator], &expectedPulseWidth, pulseWidth)) {
+        return false;
+    }
+
+    if (!atomic_load(&isTrajectoryEngineRunning)) {
+        commitServo(pin, pulseWidth);
+    }
+
+    return true;
+}
+
+void cutTrajectoryTarget(int pin, int pulseWidth) {
+    const int actuator = getTrajectoryActuator(pin);
+
+    pthread_mutex_lock(&trajectoryCommitMutex);
+    if (actuator >= 0) {
+        atomic_store_explicit(&trajectoryTargets[actuator], pulseWidth, memory_order_relaxed);
+        isTrajectoryCut[actuator] = atomic_load(&isTrajectoryEngineRunning);
+    }
+    commitServo(pin, pulseWidth);
+    pthread_mutex_unlock(&trajectoryCommitMutex);
+}
+
+int startTrajectoryEngine() {
+    const char *rate = getenv("TRAJECTORY_RATE_HZ");
+    bool isLimited = false;
+
+    loadTrajectoryLimits(&trajectoryLimits[TRAJECTORY_STEERING], "TRAJECTORY_STEERING_SLEW", "TRAJECTORY_STEERING_ACCEL", "TRAJECTORY_STEERING_JERK");
+    loadTrajectoryLimits(&trajectoryLimits[TRAJECTORY_ESC], "TRAJECTORY_ESC_FORWARD_SLEW", "TRAJECTORY_ESC_FORWARD_ACCEL", "TRAJECTORY_ESC_FORWARD_JERK");
+    loadTrajectoryLimits(&escReverseLimits, "TRAJECTORY_ESC_REVERSE_SLEW", "TRAJECTORY_ESC_REVERSE_ACCEL", "TRAJECTORY_ESC_REVERSE_JERK");
+    loadTrajectoryLimits(&trajectoryLimits[TRAJECTORY_GIMBAL_YAW], "TRAJECTORY_GIMBAL_SLEW", "TRAJECTORY_GIMBAL_ACCEL", "TRAJECTORY_GIMBAL_JERK");
+    trajectoryLimits[TRAJECTORY_GIMBAL_PITCH] = trajectoryLimits[TRAJECTORY_GIMBAL_YAW];
+
+    for (int i = 0; i < TRAJECTORY_ACTUATOR_COUNT; i++) {
+        isLimited = isLimited || hasTrajectoryLimits(&trajectoryLimits[i]);
+    }
+    isLimited = isLimited || hasTrajectoryLimits(&escReverseLimits);
+
+    if (!isLimited) {
+        return -1;
+    }
+
+    trajectoryRateHz = rate != NULL && atoi(rate) > 0 ? atoi(rate) : TRAJECTORY_DEFAULT_RATE_HZ;
+    atomic_store(&isTrajectoryEngineRunning, true);
+
+    if (pthread_create(&trajectoryThreadHandle, NULL, trajectoryThread, NULL) != 0) {
+        printf("[Trajectory] Failed to create engine thread\n");
+        atomic_store(&isTrajectoryEngineRunning, false);
+        return -1;
+    }
+
+    printf("[Trajectory] Shaping actuator setpoints at %d Hz\n", trajectoryRateHz);
+
+    return 0;
+}
+
+void stopTrajectoryEngine() {
+    if (!atomic_load(&isTrajectoryEngineRunning)) {
+        return;
+    }
+
+    atomic_store(&isTrajectoryEngineRunning, false);
+    pthread_join(trajectoryThreadHandle, NULL);
+}
@@ -0,0 +1,38 @@
+#ifndef TRAJECTORY_H
+#define TRAJECTORY_H
+
+#include <stdbool.h>
+
+#define TRAJECTORY_DEFAULT_RATE_HZ 50
+#define TRAJECTORY_SETTLE_PULSE_WIDTH 0.5f
+
+typedef enum {
+    TRAJECTORY_STEERING,
+    TRAJECTORY_ESC,
+    TRAJECTORY_GIMBAL_YAW,
+    TRAJECTORY_GIMBAL_PITCH,
+    TRAJECTORY_ACTUATOR_COUNT
+} TrajectoryActuator;
+
+typedef struct {
+    float maxSlewRate;
+    float maxAcceleration;
+    float maxJerk;
+} TrajectoryLimits;
+
+typedef struct {
+    float position;
+    float velocity;
+    float acceleration;
+} TrajectoryAxis;
+
+bool hasTrajectoryLimits(const TrajectoryLimits *limits);
+void stepTrajectory(TrajectoryAxis *axis, const TrajectoryLimits *limits, float target, float dt);
+
+int startTrajectoryEngine();
+void stopTrajectoryEngine();
+void setTrajectoryTarget(int pin, int pulseWidth);
+int getTrajectoryTarget(int pin);
+bool replaceTrajectoryTarget(int pin, int expectedPulseWidth, int pulseWidth);
+void cutTrajectoryTarget(int pin, int pulseWidth);
+#endif
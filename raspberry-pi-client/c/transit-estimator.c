@@ -0,0 +1,29 @@
+#include <limits.h>
+#include "transit-estimator.h"
+
+void resetTransitEstimator(TransitEstimator *estimator, long windowMs, long now) {
+    estimator->windowMs = windowMs;
+    estimator->currentMinMs = LONG_MAX;
+    estimator->previousMinMs = LONG_MAX;
+    estimator->windowStartedAtMs = now;
+}
+
+long updateTransitEstimator(TransitEstimator *estimator, long sentAtMs, long arrivalMs) {
+    const long transit = arrivalMs - sentAtMs;
+
+    if (arrivalMs - estimator->windowStartedAtMs >= estimator->windowMs) {
+        estimator->previousMinMs = estimator->currentMinMs;
+        estimator->currentMinMs = LONG_MAX;
+        estimator->windowStartedAtMs = arrivalMs;
+    }
+
+    if (transit < estimator->currentMinMs) {
+        estimator->currentMinMs = transit;
+    }
+
+    return transit;
+}
+
+long getTransitEstimatorBaseMs(const TransitEstimator *estimator) {
+    return estimator->currentMinMs < estimator->previousMinMs ? estimator->currentMinMs : estimator->previousMinMs;
+}
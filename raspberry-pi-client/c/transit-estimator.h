@@ -0,0 +1,14 @@
+#ifndef TRANSIT_ESTIMATOR_H
+#define TRANSIT_ESTIMATOR_H
+
+typedef struct {
+    long windowMs;
+    long currentMinMs;
+    long previousMinMs;
+    long windowStartedAtMs;
+} TransitEstimator;
+
+void resetTransitEstimator(TransitEstimator *estimator, long windowMs, long now);
+long updateTransitEstimator(TransitEstimator *estimator, long sentAtMs, long arrivalMs);
+long getTransitEstimatorBaseMs(const TransitEstimator *estimator);
+#endif
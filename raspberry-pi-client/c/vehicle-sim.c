@@ -0,0 +1,233 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "rc-car.h"
+#include "vehicle-sim.h"
+
+static double metersPerDegreeLatitude() {
+    return VEHICLE_SIM_EARTH_RADIUS * M_PI / 180.0;
+}
+
+static float gaussian(VehicleSim *sim, float sigma) {
+    if (sigma <= 0.0f) {
+        return 0.0f;
+    }
+
+    const double u1 = (rand_r(&sim->randomState) + 1.0) / (RAND_MAX + 2.0);
+    const double u2 = (rand_r(&sim->randomState) + 1.0) / (RAND_MAX + 2.0);
+    return (float)(sigma * sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2));
+}
+
+static void writeRegister(VehicleSim *sim, int reg, float value) {
+    const long raw = lroundf(value);
+    const short clamped = (short)(raw > 32767 ? 32767 : (raw < -32768 ? -32768 : raw));
+
+    sim->registers[reg] = (uint8_t)(((uint16_t)clamped >> 8) & 0xff);
+    sim->registers[reg + 1] = (uint8_t)((uint16_t)clamped & 0xff);
+}
+
+static const VehicleSimImuSample *findDelayedImuSample(const VehicleSim *sim) {
+    const long delayedUs = sim->timeUs - (long)(sim->config.imuLatencyMs * 1000.0f);
+    const VehicleSimImuSample *sample = NULL;
+
+    for (int i = 0; i < sim->historyCount; i++) {
+        const int index = (sim->historyHead - i + VEHICLE_SIM_HISTORY_SIZE) % VEHICLE_SIM_HISTORY_SIZE;
+        sample = &sim->history[index];
+
+        if (sample->timeUs <= delayedUs) {
+            break;
+        }
+    }
+
+    return sample;
+}
+
+static void updateRegisters(VehicleSim *sim) {
+    const VehicleSimImuSample *sample = findDelayedImuSample(sim);
+    const VehicleSimConfig *config = &sim->config;
+
+    if (sample == NULL) {
+        return;
+    }
+
+    writeRegister(sim, ACCEL_XOUT_H, (sample->forwardAcceleration / VEHICLE_SIM_GRAVITY + gaussian(sim, config->accelNoise)) * ACCEL_SENSITIVITY);
+    writeRegister(sim, ACCEL_YOUT_H, (sample->lateralAcceleration / VEHICLE_SIM_GRAVITY + gaussian(sim, config->accelNoise)) * ACCEL_SENSITIVITY);
+    writeRegister(sim, ACCEL_ZOUT_H, (1.0f + gaussian(sim, config->accelNoise)) * ACCEL_SENSITIVITY);
+    writeRegister(sim, TEMP_OUT_H, (VEHICLE_SIM_TEMPERATURE - 36.53f) * 340.0f);
+    writeRegister(sim, GYRO_XOUT_H, gaussian(sim, config->gyroNoise) * GYRO_SENSITIVITY);
+    writeRegister(sim, GYRO_YOUT_H, gaussian(sim, config->gyroNoise) * GYRO_SENSITIVITY);
+    writeRegister(sim, GYRO_ZOUT_H, (sample->yawRate + config->gyroBias + gaussian(sim, config->gyroNoise)) * GYRO_SENSITIVITY);
+}
+
+static void sampleGps(VehicleSim *sim) {
+    const VehicleSimConfig *config = &sim->config;
+
+    if (config->gpsRateHz <= 0.0f || sim->timeUs < sim->nextGpsAtUs) {
+        return;
+    }
+
+    sim->nextGpsAtUs += (long)(1000000.0f / config->gpsRateHz);
+
+    if (sim->gpsQueueCount == VEHICLE_SIM_GPS_QUEUE_SIZE) {
+        sim->gpsQueueHead = (sim->gpsQueueHead + 1) % VEHICLE_SIM_GPS_QUEUE_SIZE;
+        sim->gpsQueueCount--;
+    }
+
+    VehicleSimGpsFix *fix = &sim->gpsQueue[(sim->gpsQueueHead + sim->gpsQueueCount) % VEHICLE_SIM_GPS_QUEUE_SIZE];
+    const double metersPerDegreeLongitude = metersPerDegreeLatitude() * cos(config->originLatitude * M_PI / 180.0);
+    double track = sim->heading * 180.0 / M_PI + (sim->speed < 0.0f ? 180.0 : 0.0);
+
+    track = fmod(track, 360.0);
+    if (track < 0.0) {
+        track += 360.0;
+    }
+
+    fix->measuredAtUs = sim->timeUs;
+    fix->releasedAtUs = sim->timeUs + (long)(config->gpsLatencyMs * 1000.0f);
+    fix->latitude = config->originLatitude + (sim->y + gaussian(sim, config->gpsPositionNoise)) / metersPerDegreeLatitude();
+    fix->longitude = config->originLongitude + (sim->x + gaussian(sim, config->gpsPositionNoise)) / metersPerDegreeLongitude;
+    fix->speed = fabsf(fabsf(sim->speed) + gaussian(sim, config->gpsSpeedNoise));
+    fix->track = (float)track;
+    fix->mode = 3;
+    sim->gpsQueueCount++;
+}
+
+void initVehicleSimConfig(VehicleSimConfig *config) {
+    config->wheelbase = 0.26f;
+    config->maxSpeed = 8.0f;
+    config->maxReverseSpeed = 3.0f;
+    config->maxSteeringAngle = 30.0f;
+    config->throttleTimeConstant = 0.6f;
+    config->steeringTimeConstant = 0.08f;
+    config->escDeadband = 30.0f;
+    config->originLatitude = 50.4501;
+    config->originLongitude = 30.5234;
+    config->initialHeading = 0.0f;
+    config->gyroNoise = 0.05f;
+    config->gyroBias = 0.0f;
+    config->accelNoise = 0.002f;
+    config->gpsPositionNoise = 1.0f;
+    config->gpsSpeedNoise = 0.1f;
+    config->gpsRateHz = 10.0f;
+    config->imuLatencyMs = 0.0f;
+    config->gpsLatencyMs = 100.0f;
+    config->seed = 1;
+}
+
+void resetVehicleSim(VehicleSim *sim, const VehicleSimConfig *config) {
+    memset(sim, 0, sizeof(VehicleSim));
+    sim->config = *config;
+    sim->heading = config->initialHeading * M_PI / 180.0;
+    sim->steeringPulseWidth = CAR_TURNS_MIN_PWM + (CAR_TURNS_MAX_PWM - CAR_TURNS_MIN_PWM) / 2;
+    sim->escPulseWidth = CAR_ESC_NEUTRAL_PWM;
+    sim->randomState = config->seed;
+    sim->historyHead = -1;
+    updateRegisters(sim);
+}
+
+void setVehicleSimPulseWidth(VehicleSim *sim, int pin, int pulseWidth) {
+    if (pulseWidth <= 0) {
+        return;
+    }
+
+    switch (pin) {
+        case CAR_TURNS_SERVO_PIN:
+            sim->steeringPulseWidth = pulseWidth;
+            break;
+        case CAR_ESC_PIN:
+            sim->escPulseWidth = pulseWidth;
+            break;
+        default:
+            break;
+    }
+}
+
+void stepVehicleSim(VehicleSim *sim, float dt) {
+    const VehicleSimConfig *config = &sim->config;
+
+    if (dt <= 0.0f) {
+        return;
+    }
+
+    const float servoAngle = (float)(sim->steeringPulseWidth - CAR_TURNS_MIN_PWM) / (CAR_TURNS_MAX_PWM - CAR_TURNS_MIN_PWM) * 180.0f;
+    float targetSteeringAngle = servoAngle - (float)NEUTRAL_ANGLE;
+    float targetSpeed = 0.0f;
+
+    if (targetSteeringAngle > config->maxSteeringAngle) {
+        targetSteeringAngle = config->maxSteeringAngle;
+    }
+    if (targetSteeringAngle < -config->maxSteeringAngle) {
+        targetSteeringAngle = -config->maxSteeringAngle;
+    }
+
+    if (sim->escPulseWidth > CAR_ESC_NEUTRAL_PWM + config->escDeadband) {
+        targetSpeed = (float)(sim->escPulseWidth - CAR_ESC_NEUTRAL_PWM) / (CAR_ESC_MAX_PWM - CAR_ESC_NEUTRAL_PWM) * config->maxSpeed;
+    } else if (sim->escPulseWidth < CAR_ESC_NEUTRAL_PWM - config->escDeadband) {
+        targetSpeed = -(float)(CAR_ESC_NEUTRAL_PWM - sim->escPulseWidth) / (CAR_ESC_NEUTRAL_PWM - CAR_ESC_MIN_PWM) * config->maxReverseSpeed;
+    }
+
+    sim->steeringAngle += (targetSteeringAngle - sim->steeringAngle) * (1.0f - expf(-dt / config->steeringTimeConstant));
+
+    const float previousSpeed = sim->speed;
+    sim->speed += (targetSpeed - sim->speed) * (1.0f - expf(-dt / config->throttleTimeConstant));
+    sim->forwardAcceleration = (sim->speed - previousSpeed) / dt;
+
+    const float yawRate = sim->speed / config->wheelbase * tanf(sim->steeringAngle * (float)M_PI / 180.0f);
+    sim->yawRate = yawRate * 180.0f / (float)M_PI;
+    sim->heading -= yawRate * dt;
+    sim->x += sim->speed * sin(sim->heading) * dt;
+    sim->y += sim->speed * cos(sim->heading) * dt;
+    sim->timeUs += (long)(dt * 1e6f);
+
+    sim->historyHead = (sim->historyHead + 1) % VEHICLE_SIM_HISTORY_SIZE;
+    if (sim->historyCount < VEHICLE_SIM_HISTORY_SIZE) {
+        sim->historyCount++;
+    }
+    sim->history[sim->historyHead].timeUs = sim->timeUs;
+    sim->history[sim->historyHead].yawRate = sim->yawRate;
+    sim->history[sim->historyHead].forwardAcceleration = sim->forwardAcceleration;
+    sim->history[sim->historyHead].lateralAcceleration = sim->speed * yawRate;
+
+    updateRegisters(sim);
+    sampleGps(sim);
+}
+
+short readVehicleSimRegister(const VehicleSim *sim, int reg) {
+    return (short)((sim->registers[reg] << 8) | sim->registers[reg + 1]);
+}
+
+bool pollVehicleSimGpsFix(VehicleSim *sim, VehicleSimGpsFix *fix) {
+    if (sim->gpsQueueCount == 0 || sim->gpsQueue[sim->gpsQueueHead].releasedAtUs > sim->timeUs) {
+        return false;
+    }
+
+    *fix = sim->gpsQueue[sim->gpsQueueHead];
+    sim->gpsQueueHead = (sim->gpsQueueHead + 1) % VEHICLE_SIM_GPS_QUEUE_SIZE;
+    sim->gpsQueueCount--;
+
+    return true;
+}
+
+int formatVehicleSimGpsReport(const VehicleSimGpsFix *fix, char *buffer, int size) {
+    const time_t seconds = VEHICLE_SIM_EPOCH_SECONDS + fix->measuredAtUs / 1000000L;
+    struct tm utc;
+    char timestamp[32];
+
+    gmtime_r(&seconds, &utc);
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%S", &utc);
+
+    return snprintf(
+        buffer,
+        size,
+        "{\"class\":\"TPV\",\"device\":\"/dev/vehiclesim\",\"mode\":%d,\"time\":\"%s.%03ldZ\",\"lat\":%.9f,\"lon\":%.9f,\"alt\":0.0,\"track\":%.2f,\"speed\":%.3f}\r\n",
+        fix->mode,
+        timestamp,
+        (fix->measuredAtUs / 1000L) % 1000L,
+        fix->latitude,
+        fix->longitude,
+        fix->track,
+        fix->speed
+    );
+}
@@ -0,0 +1,84 @@
+#ifndef VEHICLE_SIM_H
+#define VEHICLE_SIM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "mpu6050.h"
+
+#define VEHICLE_SIM_HISTORY_SIZE 512
+#define VEHICLE_SIM_GPS_QUEUE_SIZE 32
+#define VEHICLE_SIM_EARTH_RADIUS 6371000.0
+#define VEHICLE_SIM_GRAVITY 9.81f
+#define VEHICLE_SIM_TEMPERATURE 25.0f
+#define VEHICLE_SIM_EPOCH_SECONDS 1767225600L
+
+typedef struct {
+    float wheelbase;
+    float maxSpeed;
+    float maxReverseSpeed;
+    float maxSteeringAngle;
+    float throttleTimeConstant;
+    float steeringTimeConstant;
+    float escDeadband;
+    double originLatitude;
+    double originLongitude;
+    float initialHeading;
+    float gyroNoise;
+    float gyroBias;
+    float accelNoise;
+    float gpsPositionNoise;
+    float gpsSpeedNoise;
+    float gpsRateHz;
+    float imuLatencyMs;
+    float gpsLatencyMs;
+    unsigned int seed;
+} VehicleSimConfig;
+
+typedef struct {
+    long timeUs;
+    float yawRate;
+    float forwardAcceleration;
+    float lateralAcceleration;
+} VehicleSimImuSample;
+
+typedef struct {
+    long measuredAtUs;
+    long releasedAtUs;
+    double latitude;
+    double longitude;
+    float speed;
+    float track;
+    int mode;
+} VehicleSimGpsFix;
+
+typedef struct {
+    VehicleSimConfig config;
+    long timeUs;
+    double x;
+    double y;
+    double heading;
+    float speed;
+    float steeringAngle;
+    float yawRate;
+    float forwardAcceleration;
+    int steeringPulseWidth;
+    int escPulseWidth;
+    unsigned int randomState;
+    long nextGpsAtUs;
+    VehicleSimImuSample history[VEHICLE_SIM_HISTORY_SIZE];
+    int historyHead;
+    int historyCount;
+    VehicleSimGpsFix gpsQueue[VEHICLE_SIM_GPS_QUEUE_SIZE];
+    int gpsQueueHead;
+    int gpsQueueCount;
+    uint8_t registers[MPU6050_REGISTER_COUNT];
+} VehicleSim;
+
+void initVehicleSimConfig(VehicleSimConfig *config);
+void resetVehicleSim(VehicleSim *sim, const VehicleSimConfig *config);
+void setVehicleSimPulseWidth(VehicleSim *sim, int pin, int pulseWidth);
+void stepVehicleSim(VehicleSim *sim, float dt);
+short readVehicleSimRegister(const VehicleSim *sim, int reg);
+bool pollVehicleSimGpsFix(VehicleSim *sim, VehicleSimGpsFix *fix);
+int formatVehicleSimGpsReport(const VehicleSimGpsFix *fix, char *buffer, int size);
+#endif
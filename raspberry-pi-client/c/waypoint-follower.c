@@ -0,0 +1,91 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "dead-reckoning.h"
+#include "reactor.h"
+#include "waypoint-follower.h"
+
+static PurePursuitConfig purePursuitConfig;
+static PurePursuitPath purePursuitPath;
+static WaypointFollowerDriveCallback driveCallback = NULL;
+static int followerTimerFd = -1;
+static int followerSpeed = 0;
+
+static float getWaypointFollowerSetting(const char *name, float fallback) {
+    const char *value = getenv(name);
+    return value != NULL && atof(value) > 0.0 ? (float)atof(value) : fallback;
+}
+
+static void onWaypointFollowerTick(int fd, uint32_t events, void *arg) {
+    PositionEstimate estimate;
+    float steeringAngle;
+
+    if (!getDeadReckoningEstimate(&estimate) || estimate.positionStdDev > WAYPOINT_FOLLOWER_MAX_POSITION_STD_DEV_M) {
+        stopWaypointFollower("position estimate lost");
+        return;
+    }
+
+    if (!computePurePursuitSteering(&purePursuitPath, &purePursuitConfig, &estimate, &steeringAngle)) {
+        stopWaypointFollower("route completed");
+        return;
+    }
+
+    driveCallback(steeringAngle, followerSpeed);
+}
+
+void setWaypointFollowerDriveCallback(WaypointFollowerDriveCallback callback) {
+    driveCallback = callback;
+}
+
+int startWaypointFollower(const Waypoint *waypoints, int count, int speed) {
+    PositionEstimate estimate;
+    Waypoint start;
+
+    if (driveCallback == NULL || count <= 0) {
+        return -1;
+    }
+
+    if (!getDeadReckoningEstimate(&estimate)) {
+        printf("[Waypoints] No position estimate, refusing to follow\n");
+        return -1;
+    }
+
+    initPurePursuitConfig(&purePursuitConfig);
+    purePursuitConfig.wheelbase = getWaypointFollowerSetting("WAYPOINT_WHEELBASE_M", purePursuitConfig.wheelbase);
+    purePursuitConfig.lookaheadGain = getWaypointFollowerSetting("WAYPOINT_LOOKAHEAD_GAIN_S", purePursuitConfig.lookaheadGain);
+    purePursuitConfig.minLookahead = getWaypointFollowerSetting("WAYPOINT_MIN_LOOKAHEAD_M", purePursuitConfig.minLookahead);
+    purePursuitConfig.acceptanceRadius = getWaypointFollowerSetting("WAYPOINT_ACCEPTANCE_RADIUS_M", purePursuitConfig.acceptanceRadius);
+    purePursuitConfig.maxSteeringAngle = getWaypointFollowerSetting("WAYPOINT_MAX_STEERING_DEGREES", purePursuitConfig.maxSteeringAngle);
+
+    start.latitude = estimate.latitude;
+    start.longitude = estimate.longitude;
+    resetPurePursuitPath(&purePursuitPath, &start, waypoints, count);
+    followerSpeed = speed;
+
+    if (followerTimerFd < 0) {
+        followerTimerFd = addReactorTimer(1000000L / WAYPOINT_FOLLOWER_RATE_HZ, onWaypointFollowerTick, NULL);
+        if (followerTimerFd < 0) {
+            printf("[Waypoints] Failed to schedule follower\n");
+            return -1;
+        }
+    }
+
+    printf("[Waypoints] Following %d waypoints at %d%% speed\n", purePursuitPath.count - 1, speed);
+
+    return 0;
+}
+
+void stopWaypointFollower(const char *reason) {
+    if (followerTimerFd < 0) {
+        return;
+    }
+
+    removeReactorTimer(followerTimerFd);
+    followerTimerFd = -1;
+    driveCallback(0.0f, 0);
+
+    printf("[Waypoints] Stopped: %s\n", reason);
+}
+
+bool isWaypointFollowerActive() {
+    return followerTimerFd >= 0;
+}
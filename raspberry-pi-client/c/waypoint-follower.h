@@ -0,0 +1,16 @@
+#ifndef WAYPOINT_FOLLOWER_H
+#define WAYPOINT_FOLLOWER_H
+
+#include <stdbool.h>
+#include "pure-pursuit.h"
+
+#define WAYPOINT_FOLLOWER_RATE_HZ 50
+#define WAYPOINT_FOLLOWER_MAX_POSITION_STD_DEV_M 5.0f
+
+typedef void (*WaypointFollowerDriveCallback)(float steeringAngle, int speed);
+
+void setWaypointFollowerDriveCallback(WaypointFollowerDriveCallback callback);
+int startWaypointFollower(const Waypoint *waypoints, int count, int speed);
+void stopWaypointFollower(const char *reason);
+bool isWaypointFollowerActive();
+#endif
@@ -3,10 +3,19 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <termios.h>
+#include "frame-assembler.h"
+#include "jitter-buffer.h"
+#include "reactor.h"
 #include "websocket.h"
+#ifdef EMBEDDED_RELAY
+#include "relay.h"
+#include "relay-peer.h"
+#endif
 
 #define MAX_PAYLOAD_SIZE 1024
 #define WEB_SOCKET_PORT 8585
+#define WEB_SOCKET_SOURCE "rc-car-server"
+#define WEB_SOCKET_RELAY_ID "car-relay"
 #define KGRN "\033[0;32;32m"
 #define KCYN "\033[0;36m"
 #define KRED "\033[0;32;31m"
@@ -20,6 +29,8 @@ struct lws *webSocketInstance = NULL;
 struct lws_context *lwsContext = NULL;
 
 static WebSocketEventCallback webSocketEventCallback = NULL;
+static WebSocketWritableCallback webSocketWritableCallback = NULL;
+static FrameAssembler webSocketAssembler = {NULL, 0, 0, false, false};
 
 static int callbackWebsocket(
     struct lws *wsi,
@@ -28,18 +39,42 @@ static int callbackWebsocket(
     void *in,
     size_t len
 ) {
+    if (handleReactorWebSocketPoll(reason, in)) {
+        return 0;
+    }
+
     switch (reason) {
         case LWS_CALLBACK_CLIENT_ESTABLISHED: {
             printf("WebSocket connection established.\n");
             webSocketInstance = wsi;
+            resetJitterBuffer();
         }
         break;
 
         case LWS_CALLBACK_CLIENT_RECEIVE: {
+            const int result = assembleWebSocketFrame(&webSocketAssembler, wsi, in, len);
+
+            if (result == FRAME_ASSEMBLER_OVERSIZED) {
+                printf(KRED"[WebSocket] Dropping message over %d bytes\n"RESET, FRAME_ASSEMBLER_MAX_MESSAGE);
+                break;
+            }
+
+            if (result != FRAME_ASSEMBLER_COMPLETE) {
+                break;
+            }
+
             if (webSocketEventCallback) {
-                webSocketEventCallback((const char *)in);
+                webSocketEventCallback(webSocketAssembler.buffer);
             } else {
-                printf("Received message (no callback set): %s\n", (char *)in);
+                printf("Received message (no callback set): %s\n", webSocketAssembler.buffer);
+            }
+            resetFrameAssembler(&webSocketAssembler);
+        }
+        break;
+
+        case LWS_CALLBACK_CLIENT_WRITEABLE: {
+            if (webSocketWritableCallback) {
+                webSocketWritableCallback(wsi);
             }
         }
         break;
@@ -47,6 +82,7 @@ static int callbackWebsocket(
         case LWS_CALLBACK_CLIENT_CLOSED: {
             printf("WebSocket connection closed.\n");
             webSocketInstance = NULL;
+            resetFrameAssembler(&webSocketAssembler);
         }
         break;
 
@@ -77,6 +113,100 @@ void setWebSocketEventCallback(WebSocketEventCallback callback) {
     webSocketEventCallback = callback;
 }
 
+void setWebSocketWritableCallback(WebSocketWritableCallback callback) {
+    webSocketWritableCallback = callback;
+}
+
+struct lws *getWebSocketInstanceFor(const char *destination) {
+#ifdef EMBEDDED_RELAY
+    return findRelayRoute(destination);
+#else
+    return webSocketInstance;
+#endif
+}
+
+#ifdef EMBEDDED_RELAY
+static void onRelayLocalWebSocketEvent(const char *message) {
+    if (webSocketEventCallback) {
+        webSocketEventCallback(message);
+    }
+}
+
+static void onRelayWritable(struct lws *wsi) {
+    if (webSocketWritableCallback) {
+        webSocketWritableCallback(wsi);
+    }
+}
+
+static int callbackEmbeddedRelay(
+    struct lws *wsi,
+    const enum lws_callback_reasons reason,
+    void *user,
+    void *in,
+    size_t len
+) {
+    if (handleReactorWebSocketPoll(reason, in)) {
+        return 0;
+    }
+
+    if (reason == LWS_CALLBACK_ESTABLISHED) {
+        resetJitterBuffer();
+    }
+
+    return callbackRelay(wsi, reason, user, in, len);
+}
+
+static int callbackEmbeddedRelayPeer(
+    struct lws *wsi,
+    const enum lws_callback_reasons reason,
+    void *user,
+    void *in,
+    size_t len
+) {
+    if (handleReactorWebSocketPoll(reason, in)) {
+        return 0;
+    }
+
+    return callbackRelayPeer(wsi, reason, user, in, len);
+}
+
+static void serviceEmbeddedRelayPeers(int fd, uint32_t events, void *arg) {
+    serviceRelayPeers();
+}
+
+WebSocketConnection connectToWebSocketServer(void) {
+    WebSocketConnection wsConnection = {NULL, NULL};
+    struct lws_context_creation_info contextCreationInfo;
+
+    memset(&contextCreationInfo, 0, sizeof(contextCreationInfo));
+    contextCreationInfo.port = WEB_SOCKET_PORT;
+    contextCreationInfo.protocols = (struct lws_protocols[]){
+        {"websocket", callbackEmbeddedRelay, RELAY_SESSION_SIZE, 0},
+        {RELAY_PEER_PROTOCOL, callbackEmbeddedRelayPeer, RELAY_PEER_SESSION_SIZE, 0},
+        {NULL, NULL, 0, 0}
+    };
+
+    lwsContext = lws_create_context(&contextCreationInfo);
+    if (!lwsContext) {
+        fprintf(stderr, "Failed to create WebSocket context.\n");
+        return wsConnection;
+    }
+    attachReactorWebSocketContext(lwsContext);
+
+    loadRelayRateLimits();
+    registerRelayLocalDestination(WEB_SOCKET_SOURCE, onRelayLocalWebSocketEvent);
+    setRelayWritableCallback(onRelayWritable);
+    if (startRelayPeers(lwsContext, WEB_SOCKET_RELAY_ID) > 0) {
+        addReactorTimer(RELAY_PEER_RETRY_S * 1000000L, serviceEmbeddedRelayPeers, NULL);
+    }
+    printf("Embedded relay started on port %d\n", WEB_SOCKET_PORT);
+
+    wsConnection.context = lwsContext;
+
+    return wsConnection;
+}
+#else
+
 WebSocketConnection connectToWebSocketServer(void) {
     WebSocketConnection wsConnection = {NULL, NULL};
     struct lws_context_creation_info contextCreationInfo;
@@ -91,12 +221,13 @@ WebSocketConnection connectToWebSocketServer(void) {
         fprintf(stderr, "Failed to create WebSocket context.\n");
         return wsConnection;
     }
+    attachReactorWebSocketContext(lwsContext);
 
     memset(&connectionInfo, 0, sizeof(connectionInfo));
     connectionInfo.context = lwsContext;
     connectionInfo.address = getenv("RASPBERRY_PI_IP");
     connectionInfo.port = WEB_SOCKET_PORT;
-    connectionInfo.path = "/?source=rc-car-server";
+    connectionInfo.path = "/?source=" WEB_SOCKET_SOURCE;
 
     struct lws *wsi = lws_client_connect_via_info(&connectionInfo);
 
@@ -111,6 +242,7 @@ WebSocketConnection connectToWebSocketServer(void) {
 
     return wsConnection;
 }
+#endif
 
 void closeWebSocketServer() {
     lws_context_destroy(lwsContext);
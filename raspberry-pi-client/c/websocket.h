@@ -9,10 +9,13 @@ typedef struct {
 } WebSocketConnection;
 
 typedef void (*WebSocketEventCallback)(const char *message);
+typedef void (*WebSocketWritableCallback)(struct lws *webSocketInstance);
 
 WebSocketConnection connectToWebSocketServer();
 void closeWebSocketServer();
 void setWebSocketEventCallback(WebSocketEventCallback callback);
+void setWebSocketWritableCallback(WebSocketWritableCallback callback);
+struct lws *getWebSocketInstanceFor(const char *destination);
 void sendWebSocketEvent(const char *message, struct lws *webSocketInstance);
 
 #endif
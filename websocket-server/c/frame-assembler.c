@@ -0,0 +1,144 @@
+#include <stdlib.h>
+#include <string.h>
+#include "frame-assembler.h"
+
+static const size_t framePoolClasses[FRAME_POOL_CLASS_COUNT] = {512, 2048, 8192, LWS_PRE + FRAME_ASSEMBLER_MAX_MESSAGE + 1};
+static char *framePool[FRAME_POOL_CLASS_COUNT][FRAME_POOL_BUFFERS_PER_CLASS];
+static int framePoolCounts[FRAME_POOL_CLASS_COUNT];
+static FramePoolStats framePoolStats = {0, 0, 0};
+
+static int getFramePoolClass(size_t size) {
+    for (int i = 0; i < FRAME_POOL_CLASS_COUNT; i++) {
+        if (size <= framePoolClasses[i]) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+char *acquireFrameBuffer(size_t size, size_t *capacity) {
+    const int poolClass = getFramePoolClass(size);
+
+    if (poolClass < 0) {
+        return NULL;
+    }
+
+    framePoolStats.acquisitions++;
+    *capacity = framePoolClasses[poolClass];
+
+    if (framePoolCounts[poolClass] > 0) {
+        framePoolStats.poolHits++;
+        return framePool[poolClass][--framePoolCounts[poolClass]];
+    }
+
+    return malloc(*capacity);
+}
+
+void releaseFrameBuffer(char *buffer, size_t capacity) {
+    const int poolClass = getFramePoolClass(capacity);
+
+    if (buffer == NULL) {
+        return;
+    }
+
+    if (poolClass >= 0 && framePoolClasses[poolClass] == capacity && framePoolCounts[poolClass] < FRAME_POOL_BUFFERS_PER_CLASS) {
+        framePool[poolClass][framePoolCounts[poolClass]++] = buffer;
+        return;
+    }
+
+    free(buffer);
+}
+
+static bool reserveFrameAssembler(FrameAssembler *assembler, size_t size) {
+    size_t capacity;
+
+    if (size <= assembler->capacity) {
+        return true;
+    }
+
+    char *buffer = acquireFrameBuffer(size, &capacity);
+    if (buffer == NULL) {
+        return false;
+    }
+
+    if (assembler->length > 0) {
+        memcpy(buffer, assembler->buffer, assembler->length);
+    }
+    releaseFrameBuffer(assembler->buffer, assembler->capacity);
+    assembler->buffer = buffer;
+    assembler->capacity = capacity;
+
+    return true;
+}
+
+int appendFrameFragment(
+    FrameAssembler *assembler,
+    const void *data,
+    size_t length,
+    bool isFirst,
+    bool isFinal,
+    size_t remaining
+) {
+    if (isFirst && !assembler->isFrameOpen) {
+        assembler->length = 0;
+        assembler->isDiscarding = false;
+    }
+    assembler->isFrameOpen = remaining > 0;
+
+    const bool isComplete = isFinal && remaining == 0;
+
+    if (assembler->isDiscarding) {
+        if (isComplete) {
+            assembler->isDiscarding = false;
+        }
+        return FRAME_ASSEMBLER_INCOMPLETE;
+    }
+
+    const size_t needed = assembler->length + length + remaining + 1;
+
+    if (needed > FRAME_ASSEMBLER_MAX_MESSAGE + 1 || !reserveFrameAssembler(assembler, needed)) {
+        framePoolStats.oversizedMessages++;
+        releaseFrameBuffer(assembler->buffer, assembler->capacity);
+        assembler->buffer = NULL;
+        assembler->capacity = 0;
+        assembler->length = 0;
+        assembler->isDiscarding = !isComplete;
+        return FRAME_ASSEMBLER_OVERSIZED;
+    }
+
+    memcpy(assembler->buffer + assembler->length, data, length);
+    assembler->length += length;
+
+    if (!isComplete) {
+        return FRAME_ASSEMBLER_INCOMPLETE;
+    }
+
+    assembler->buffer[assembler->length] = '\0';
+
+    return FRAME_ASSEMBLER_COMPLETE;
+}
+
+int assembleWebSocketFrame(FrameAssembler *assembler, struct lws *wsi, const void *in, size_t len) {
+    return appendFrameFragment(
+        assembler,
+        in,
+        len,
+        lws_is_first_fragment(wsi) != 0,
+        lws_is_final_fragment(wsi) != 0,
+        lws_remaining_packet_payload(wsi)
+    );
+}
+
+void resetFrameAssembler(FrameAssembler *assembler) {
+    releaseFrameBuffer(assembler->buffer, assembler->capacity);
+    assembler->buffer = NULL;
+    assembler->length = 0;
+    assembler->capacity = 0;
+    assembler->isDiscarding = false;
+    assembler->isFrameOpen = false;
+}
+
+void getFramePoolStats(FramePoolStats *stats) {
+    *stats = framePoolStats;
+}
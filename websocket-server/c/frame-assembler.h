@@ -0,0 +1,42 @@
+#ifndef FRAME_ASSEMBLER_H
+#define FRAME_ASSEMBLER_H
+
+#include <libwebsockets.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define FRAME_ASSEMBLER_MAX_MESSAGE (64 * 1024)
+#define FRAME_POOL_CLASS_COUNT 4
+#define FRAME_POOL_BUFFERS_PER_CLASS 4
+#define FRAME_ASSEMBLER_INCOMPLETE 0
+#define FRAME_ASSEMBLER_COMPLETE 1
+#define FRAME_ASSEMBLER_OVERSIZED -1
+
+typedef struct {
+    char *buffer;
+    size_t length;
+    size_t capacity;
+    bool isDiscarding;
+    bool isFrameOpen;
+} FrameAssembler;
+
+typedef struct {
+    long acquisitions;
+    long poolHits;
+    long oversizedMessages;
+} FramePoolStats;
+
+char *acquireFrameBuffer(size_t size, size_t *capacity);
+void releaseFrameBuffer(char *buffer, size_t capacity);
+int appendFrameFragment(
+    FrameAssembler *assembler,
+    const void *data,
+    size_t length,
+    bool isFirst,
+    bool isFinal,
+    size_t remaining
+);
+int assembleWebSocketFrame(FrameAssembler *assembler, struct lws *wsi, const void *in, size_t len);
+void resetFrameAssembler(FrameAssembler *assembler);
+void getFramePoolStats(FramePoolStats *stats);
+#endif
@@ -0,0 +1,126 @@
+#include <cjson/cJSON.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "json-arena.h"
+
+typedef struct {
+    unsigned char *buffer;
+    size_t offset;
+    size_t peak;
+    int depth;
+} JsonArena;
+
+static _Thread_local JsonArena threadArena = {NULL, 0, 0, 0};
+static size_t arenaCapacity = 0;
+static atomic_long scopeCount = 0;
+static atomic_long arenaAllocationCount = 0;
+static atomic_long heapFallbackCount = 0;
+static atomic_size_t peakBytes = 0;
+
+static bool isInThreadArena(const void *pointer) {
+    const uintptr_t address = (uintptr_t)pointer;
+    const uintptr_t start = (uintptr_t)threadArena.buffer;
+
+    return threadArena.buffer != NULL && address >= start && address < start + arenaCapacity;
+}
+
+static void recordArenaPeak(size_t used) {
+    size_t peak = atomic_load_explicit(&peakBytes, memory_order_relaxed);
+
+    threadArena.peak = used;
+    while (used > peak && !atomic_compare_exchange_weak_explicit(&peakBytes, &peak, used, memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+static void *allocateJson(size_t size) {
+    const size_t alignedSize = (size + JSON_ARENA_ALIGNMENT - 1) & ~(size_t)(JSON_ARENA_ALIGNMENT - 1);
+
+    if (threadArena.depth > 0 && threadArena.buffer != NULL && alignedSize <= arenaCapacity - threadArena.offset) {
+        void *pointer = threadArena.buffer + threadArena.offset;
+        threadArena.offset += alignedSize;
+
+        if (threadArena.offset > threadArena.peak) {
+            recordArenaPeak(threadArena.offset);
+        }
+        atomic_fetch_add_explicit(&arenaAllocationCount, 1, memory_order_relaxed);
+
+        return pointer;
+    }
+
+    if (threadArena.depth > 0) {
+        atomic_fetch_add_explicit(&heapFallbackCount, 1, memory_order_relaxed);
+    }
+
+    return malloc(size);
+}
+
+static void freeJson(void *pointer) {
+    if (!isInThreadArena(pointer)) {
+        free(pointer);
+    }
+}
+
+void installJsonArena(size_t capacity) {
+    cJSON_Hooks hooks = {allocateJson, freeJson};
+
+    arenaCapacity = capacity > 0 ? capacity : JSON_ARENA_DEFAULT_SIZE;
+    cJSON_InitHooks(&hooks);
+}
+
+void uninstallJsonArena() {
+    cJSON_InitHooks(NULL);
+    free(threadArena.buffer);
+    threadArena.buffer = NULL;
+    threadArena.offset = 0;
+    threadArena.depth = 0;
+}
+
+size_t beginJsonArenaScope() {
+    if (threadArena.buffer == NULL && arenaCapacity > 0) {
+        threadArena.buffer = malloc(arenaCapacity);
+    }
+
+    threadArena.depth++;
+    atomic_fetch_add_explicit(&scopeCount, 1, memory_order_relaxed);
+
+    return threadArena.offset;
+}
+
+void endJsonArenaScope(size_t mark) {
+    if (threadArena.depth == 0) {
+        return;
+    }
+
+    threadArena.depth--;
+    threadArena.offset = threadArena.depth > 0 ? mark : 0;
+}
+
+void getJsonArenaStats(JsonArenaStats *stats) {
+    stats->scopes = atomic_load(&scopeCount);
+    stats->arenaAllocations = atomic_load(&arenaAllocationCount);
+    stats->heapFallbacks = atomic_load(&heapFallbackCount);
+    stats->peakBytes = atomic_load(&peakBytes);
+    stats->capacity = arenaCapacity;
+}
+
+void reportJsonArenaStats(const char *tag) {
+    JsonArenaStats stats;
+
+    if (arenaCapacity == 0) {
+        return;
+    }
+
+    getJsonArenaStats(&stats);
+    printf(
+        "[%s] JSON arena: %ld scopes, %ld arena allocations, %ld heap fallbacks, peak %zu of %zu bytes\n",
+        tag,
+        stats.scopes,
+        stats.arenaAllocations,
+        stats.heapFallbacks,
+        stats.peakBytes,
+        stats.capacity
+    );
+}
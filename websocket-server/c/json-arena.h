@@ -0,0 +1,23 @@
+#ifndef JSON_ARENA_H
+#define JSON_ARENA_H
+
+#include <stddef.h>
+
+#define JSON_ARENA_DEFAULT_SIZE (64 * 1024)
+#define JSON_ARENA_ALIGNMENT 16
+
+typedef struct {
+    long scopes;
+    long arenaAllocations;
+    long heapFallbacks;
+    size_t peakBytes;
+    size_t capacity;
+} JsonArenaStats;
+
+void installJsonArena(size_t capacity);
+void uninstallJsonArena();
+size_t beginJsonArenaScope();
+void endJsonArenaScope(size_t mark);
+void getJsonArenaStats(JsonArenaStats *stats);
+void reportJsonArenaStats(const char *tag);
+#endif
@@ -4,8 +4,14 @@
 #include <signal.h>;
 #include <cjson/cJSON.h>;
 #include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+#include "json-arena.h"
+#include "relay.h"
+#include "relay-handoff.h"
+#include "relay-peer.h"
+#include "session-recorder.h"
 
-#define MAX_CLIENTS 2
 #define MAX_PAYLOAD_SIZE 1024
 #define KGRN "\033[0;32;32m"
 #define KCYN "\033[0;36m"
@@ -15,17 +21,27 @@
 #define KCYN_L "\033[1;36m"
 #define KBRN "\033[0;33m"
 #define RESET "\033[0m"
+#define RELAY_DEFAULT_PORT 8585
 
 int isRunning = 1;
 struct lws_context *lwsContext = NULL;
 
-typedef struct {
-    struct lws *wsi;
-    char source[128];
-} Clients;
+static void reportRelayFramePool() {
+    FramePoolStats stats;
 
-static Clients clients[MAX_CLIENTS];
-static int clientCount = 0;
+    getFramePoolStats(&stats);
+    printf("[Relay] Frame pool: %ld buffers handed out, %ld reused, %ld oversized messages dropped\n", stats.acquisitions, stats.poolHits, stats.oversizedMessages);
+}
+
+static void onRelayHandedOff(int routeCount) {
+    closeSessionRecorder();
+    reportJsonArenaStats("Relay");
+    reportRelayFramePool();
+    reportRelaySourceStats(false);
+    printf("[Relay] Handed off %d connections, exiting\n", routeCount);
+    fflush(stdout);
+    _exit(0);
+}
 
 void handleSignal(const int signal) {
     switch (signal) {
@@ -34,135 +50,75 @@ void handleSignal(const int signal) {
         case SIGTSTP:
             isRunning = 0;
             lws_context_destroy(lwsContext);
+            closeSessionRecorder();
+            reportJsonArenaStats("Relay");
+            reportRelayFramePool();
+            reportRelaySourceStats(false);
             exit(0);
         default:
             break;
     }
 }
 
-int extractQueryValue(const char *queryString, const char *key, char *output, size_t outputSize) {
-    if (!queryString || !key || !output || outputSize == 0) {
-        return 0;
-    }
-
-    const char *keyStart = strstr(queryString, key);
-    if (!keyStart) {
-        return 0;
-    }
-
-    keyStart += strlen(key);
-    if (*keyStart != '=') {
-        return 0;
-    }
-
-    keyStart++;
-    const char *valueEnd = strchr(keyStart, '&');
-    size_t valueLength = valueEnd ? (size_t) (valueEnd - keyStart) : strlen(keyStart);
-
-    if (valueLength >= outputSize) {
-        return 0;
-    }
-
-    strncpy(output, keyStart, valueLength);
-    output[valueLength] = '\0';
-    return 1;
-}
-
-static int callbackWebsocket(
-    struct lws *wsi,
-    enum lws_callback_reasons reason,
-    void *user,
-    void *in,
-    size_t len
-) {
-    char query[256] = {0};
-    char source[128] = {0};
-
-    switch (reason) {
-        case LWS_CALLBACK_ESTABLISHED: {
-            if (lws_hdr_copy_fragment(wsi, query, sizeof(query), WSI_TOKEN_HTTP_URI_ARGS, 0) > 0) {
-                extractQueryValue(query, "source", source, sizeof(source));
-
-                if (clientCount < MAX_CLIENTS) {
-                    clients[clientCount].wsi = wsi;
-                    snprintf(clients[clientCount].source, sizeof(clients[clientCount].source), "%s", source);
-                    clientCount++;
-                } else {
-                    lws_close_reason(wsi, LWS_CLOSE_STATUS_GOINGAWAY, NULL, 0);
-                }
-            }
-            break;
-        }
-
-        case LWS_CALLBACK_RECEIVE: {
-            cJSON *message = cJSON_Parse(in);
-            if (message) {
-                const cJSON *to = cJSON_GetObjectItemCaseSensitive(message, "to");
-                if (cJSON_IsString(to) && to->valuestring) {
-                    for (int i = 0; i < clientCount; i++) {
-                        if (strcmp(clients[i].source, to->valuestring) == 0) {
-                            char *newMessageJSON = cJSON_Print(message);
-                            if (newMessageJSON) {
-                                const size_t newMessageLen = strlen(newMessageJSON);
-                                char *out = NULL;
-
-                                out = (char *) malloc(
-                                    sizeof(char) * (
-                                        LWS_SEND_BUFFER_PRE_PADDING + newMessageLen + LWS_SEND_BUFFER_POST_PADDING));
-                                memcpy(out + LWS_SEND_BUFFER_PRE_PADDING, newMessageJSON, newMessageLen);
-
-                                lws_write(clients[i].wsi, out + LWS_SEND_BUFFER_PRE_PADDING, len, LWS_WRITE_TEXT);
-
-                                printf(KBLU"[websocket_write to %s] %s\n"RESET, to->valuestring, newMessageJSON);
-                                free(out);
-                            }
-                        }
-                    }
-                }
-                cJSON_Delete(message);
-            }
-            break;
-        }
-
-        case LWS_CALLBACK_CLOSED: {
-            for (int i = 0; i < clientCount; i++) {
-                if (clients[i].wsi == wsi) {
-                    for (int j = i; j < clientCount - 1; j++) {
-                        clients[j] = clients[j + 1];
-                    }
-                    clientCount--;
-                    memset(&clients[clientCount], 0, sizeof(Clients));
-                    break;
-                }
-            }
-            break;
-        }
-
-        default:
-            break;
-    }
-
-    return 0;
-}
-
-int main() {
+int main(int argc, char **argv) {
+    struct sigaction sa;
     struct lws_context_creation_info contextCreationInfo;
+    const bool isTakingOver = argc > 1 && strcmp(argv[1], "--takeover") == 0;
+    const char *configuredPort = getenv("RELAY_PORT");
+    const int port = configuredPort != NULL && atoi(configuredPort) > 0 ? atoi(configuredPort) : RELAY_DEFAULT_PORT;
+    char relayId[32];
     memset(&contextCreationInfo, 0, sizeof(contextCreationInfo));
-    contextCreationInfo.port = 8585;
+    contextCreationInfo.port = CONTEXT_PORT_NO_LISTEN_SERVER;
     contextCreationInfo.protocols = (struct lws_protocols[]){
-        {"websocket", callbackWebsocket, 0, 0}, {NULL, NULL, 0, 0}
+        {"websocket", callbackRelay, RELAY_SESSION_SIZE, 0},
+        {RELAY_HANDOFF_PROTOCOL, callbackRelayHandoff, RELAY_HANDOFF_SESSION_SIZE, 0},
+        {RELAY_LISTENER_PROTOCOL, callbackRelayListener, 0, 0},
+        {RELAY_PEER_PROTOCOL, callbackRelayPeer, RELAY_PEER_SESSION_SIZE, 0},
+        {NULL, NULL, 0, 0}
     };
 
+    installJsonArena(JSON_ARENA_DEFAULT_SIZE);
+    loadRelayRateLimits();
+
     lwsContext = lws_create_context(&contextCreationInfo);
     if (!lwsContext) {
         printf("Failed to create WebSocket context\n");
         return -1;
     }
 
-    printf("WebSocket server started on port %d\n", contextCreationInfo.port);
+    if (startRelayListener(lwsContext, port, isTakingOver) != 0) {
+        printf("Failed to listen on port %d\n", port);
+        lws_context_destroy(lwsContext);
+        return -1;
+    }
+    setRelayHandoffCallback(onRelayHandedOff);
+
+    printf("WebSocket server started on port %d\n", port);
+    snprintf(relayId, sizeof(relayId), "relay-%d", port);
+    startRelayPeers(lwsContext, relayId);
+    if (openSessionRecorder() == 0) {
+        setRelayFrameObserver(recordSessionFrame);
+    }
+
+    sa.sa_handler = handleSignal;
+    sa.sa_flags = 0;
+    sigemptyset(&sa.sa_mask);
+
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    sigaction(SIGTSTP, &sa, NULL);
+
+    time_t statsReportedAt = time(NULL);
 
     while (isRunning) {
         lws_service(lwsContext, 1000);
+        flushSessionRecorder();
+        serviceRelayPeers();
+
+        if (time(NULL) - statsReportedAt >= RELAY_STATS_INTERVAL_S) {
+            reportRelaySourceStats(true);
+            statsReportedAt = time(NULL);
+        }
 
         if (!isRunning) {
             break;
@@ -0,0 +1,389 @@
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "relay-handoff.h"
+
+typedef struct {
+    int listenFd;
+    int routeCount;
+    RelayHandoffRoute routes[RELAY_MAX_CLIENTS];
+    int fds[RELAY_MAX_CLIENTS];
+} RelayHandoff;
+
+static struct lws_vhost *relayVhost = NULL;
+static int relayListenFd = -1;
+static int handoffListenFd = -1;
+static RelayHandoffCallback relayHandoffCallback = NULL;
+static char relayHandoffPath[108];
+
+static const char *getRelayHandoffPath() {
+    return relayHandoffPath;
+}
+
+static int openRelayTcpListener(int port) {
+    struct sockaddr_in address;
+    const int enabled = 1;
+    const int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+
+    if (fd < 0) {
+        perror("[Relay] socket");
+        return -1;
+    }
+
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons((uint16_t)port);
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enabled, sizeof(enabled));
+
+    if (bind(fd, (struct sockaddr *)&address, sizeof(address)) != 0 || listen(fd, RELAY_LISTEN_BACKLOG) != 0) {
+        perror("[Relay] listen");
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+static int openRelayHandoffListener() {
+    struct sockaddr_un address;
+    const char *path = getRelayHandoffPath();
+    const int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+
+    if (fd < 0) {
+        return -1;
+    }
+
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    snprintf(address.sun_path, sizeof(address.sun_path), "%s", path);
+    unlink(path);
+
+    if (bind(fd, (struct sockaddr *)&address, sizeof(address)) != 0 || listen(fd, 1) != 0) {
+        perror("[Relay] handoff socket");
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+static int receiveRelayHandoff(RelayHandoff *handoff) {
+    struct sockaddr_un address;
+    struct timeval timeout = {RELAY_HANDOFF_TIMEOUT_S, 0};
+    RelayHandoffHeader header;
+    char control[CMSG_SPACE(sizeof(int) * (RELAY_MAX_CLIENTS + 1))];
+    struct iovec iov[2] = {
+        {&header, sizeof(header)},
+        {handoff->routes, sizeof(handoff->routes)}
+    };
+    struct msghdr message;
+    const int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+
+    if (fd < 0) {
+        return -1;
+    }
+
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    snprintf(address.sun_path, sizeof(address.sun_path), "%s", getRelayHandoffPath());
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    if (connect(fd, (struct sockaddr *)&address, sizeof(address)) != 0) {
+        perror("[Relay] Connecting to running relay");
+        close(fd);
+        return -1;
+    }
+
+    memset(&message, 0, sizeof(message));
+    message.msg_iov = iov;
+    message.msg_iovlen = 2;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+
+    const ssize_t received = recvmsg(fd, &message, MSG_CMSG_CLOEXEC);
+    close(fd);
+
+    struct cmsghdr *header_ = CMSG_FIRSTHDR(&message);
+    if (received < (ssize_t)sizeof(header) || header_ == NULL || header_->cmsg_type != SCM_RIGHTS) {
+        printf("[Relay] Running relay did not hand off its sockets\n");
+        return -1;
+    }
+
+    const int fdCount = (int)((header_->cmsg_len - CMSG_LEN(0)) / sizeof(int));
+    int *fds = (int *)CMSG_DATA(header_);
+
+    if (header.magic != RELAY_HANDOFF_MAGIC || header.routeCount > RELAY_MAX_CLIENTS || fdCount != (int)header.routeCount + 1
+        || (message.msg_flags & (MSG_TRUNC | MSG_CTRUNC)) != 0) {
+        printf("[Relay] Malformed handoff from running relay\n");
+        for (int i = 0; i < fdCount; i++) {
+            close(fds[i]);
+        }
+        return -1;
+    }
+
+    handoff->listenFd = fds[0];
+    handoff->routeCount = (int)header.routeCount;
+    for (int i = 0; i < handoff->routeCount; i++) {
+        handoff->fds[i] = fds[i + 1];
+        handoff->routes[i].source[RELAY_SOURCE_SIZE - 1] = '\0';
+    }
+
+    return 0;
+}
+
+static int sendRelayHandoff(int fd) {
+    RelayHandoffHeader header = {RELAY_HANDOFF_MAGIC, 0};
+    RelayHandoffRoute routes[RELAY_MAX_CLIENTS];
+    int fds[RELAY_MAX_CLIENTS + 1];
+    char control[CMSG_SPACE(sizeof(fds))];
+    struct msghdr message;
+    int clientCount;
+    int routeCount = 0;
+    int peerCount = 0;
+    const Clients *clients = getRelayClients(&clientCount);
+
+    fds[0] = relayListenFd;
+    for (int i = 0; i < clientCount; i++) {
+        if (clients[i].isPeer) {
+            shutdown(lws_get_socket_fd(clients[i].wsi), SHUT_RDWR);
+            peerCount++;
+            continue;
+        }
+
+        memset(&routes[routeCount], 0, sizeof(RelayHandoffRoute));
+        snprintf(routes[routeCount].source, sizeof(routes[routeCount].source), "%s", clients[i].source);
+        routes[routeCount].isRawWebSocket = 1;
+        fds[++routeCount] = lws_get_socket_fd(clients[i].wsi);
+    }
+    header.routeCount = (uint32_t)routeCount;
+
+    if (peerCount > 0) {
+        printf("[Relay] Closed %d peer links, peers reconnect to the new relay\n", peerCount);
+    }
+
+    struct iovec iov[2] = {
+        {&header, sizeof(header)},
+        {routes, sizeof(RelayHandoffRoute) * (size_t)routeCount}
+    };
+
+    memset(&message, 0, sizeof(message));
+    memset(control, 0, sizeof(control));
+    message.msg_iov = iov;
+    message.msg_iovlen = routeCount > 0 ? 2 : 1;
+    message.msg_control = control;
+    message.msg_controllen = CMSG_SPACE(sizeof(int) * (size_t)(routeCount + 1));
+
+    struct cmsghdr *controlHeader = CMSG_FIRSTHDR(&message);
+    controlHeader->cmsg_level = SOL_SOCKET;
+    controlHeader->cmsg_type = SCM_RIGHTS;
+    controlHeader->cmsg_len = CMSG_LEN(sizeof(int) * (size_t)(routeCount + 1));
+    memcpy(CMSG_DATA(controlHeader), fds, sizeof(int) * (size_t)(routeCount + 1));
+
+    if (sendmsg(fd, &message, MSG_NOSIGNAL) < 0) {
+        perror("[Relay] Handing off sockets");
+        return -1;
+    }
+
+    return routeCount;
+}
+
+static void adoptRelayHandoff(const RelayHandoff *handoff) {
+    for (int i = 0; i < handoff->routeCount; i++) {
+        union lws_sock_file_fd descriptor;
+        descriptor.sockfd = handoff->fds[i];
+
+        struct lws *wsi = lws_adopt_descriptor_vhost(relayVhost, LWS_ADOPT_SOCKET, descriptor, RELAY_HANDOFF_PROTOCOL, NULL);
+        if (wsi == NULL || !addRelayClient(wsi, handoff->routes[i].source, true)) {
+            printf("[Relay] Failed to adopt connection of %s\n", handoff->routes[i].source);
+            continue;
+        }
+
+        printf("[Relay] Took over connection of %s\n", handoff->routes[i].source);
+    }
+}
+
+static bool adoptRelayListenerFd(int fd) {
+    union lws_sock_file_fd descriptor;
+    descriptor.filefd = fd;
+
+    return lws_adopt_descriptor_vhost(relayVhost, LWS_ADOPT_RAW_FILE_DESC, descriptor, RELAY_LISTENER_PROTOCOL, NULL) != NULL;
+}
+
+int startRelayListener(struct lws_context *context, int port, bool isTakingOver) {
+    RelayHandoff handoff;
+
+    const char *path = getenv("RELAY_HANDOFF_SOCKET");
+
+    if (path != NULL && path[0] != '\0') {
+        snprintf(relayHandoffPath, sizeof(relayHandoffPath), "%s", path);
+    } else {
+        snprintf(relayHandoffPath, sizeof(relayHandoffPath), RELAY_HANDOFF_DEFAULT_SOCKET, port);
+    }
+
+    relayVhost = lws_get_vhost_by_name(context, "default");
+    if (relayVhost == NULL) {
+        return -1;
+    }
+
+    if (isTakingOver && receiveRelayHandoff(&handoff) == 0) {
+        relayListenFd = handoff.listenFd;
+        fcntl(relayListenFd, F_SETFL, fcntl(relayListenFd, F_GETFL) | O_NONBLOCK);
+        adoptRelayHandoff(&handoff);
+    } else {
+        relayListenFd = openRelayTcpListener(port);
+    }
+
+    if (relayListenFd < 0 || !adoptRelayListenerFd(relayListenFd)) {
+        return -1;
+    }
+
+    handoffListenFd = openRelayHandoffListener();
+    if (handoffListenFd < 0 || !adoptRelayListenerFd(handoffListenFd)) {
+        printf("[Relay] Hot restart is not available\n");
+    }
+
+    return 0;
+}
+
+void setRelayHandoffCallback(RelayHandoffCallback callback) {
+    relayHandoffCallback = callback;
+}
+
+static void acceptRelayConnections() {
+    int fd;
+
+    while ((fd = accept4(relayListenFd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+        if (lws_adopt_socket_vhost(relayVhost, fd) == NULL) {
+            close(fd);
+        }
+    }
+}
+
+static void acceptRelayHandoff() {
+    const int fd = accept4(handoffListenFd, NULL, NULL, SOCK_CLOEXEC);
+
+    if (fd < 0) {
+        return;
+    }
+
+    const int routeCount = sendRelayHandoff(fd);
+    close(fd);
+
+    if (routeCount >= 0 && relayHandoffCallback) {
+        relayHandoffCallback(routeCount);
+    }
+}
+
+int callbackRelayListener(struct lws *wsi, enum lws_callback_reasons reason, void *user, void *in, size_t len) {
+    if (reason != LWS_CALLBACK_RAW_RX_FILE) {
+        return 0;
+    }
+
+    const int fd = lws_get_socket_fd(wsi);
+
+    if (fd == relayListenFd) {
+        acceptRelayConnections();
+    } else if (fd == handoffListenFd) {
+        acceptRelayHandoff();
+    }
+
+    return 0;
+}
+
+static int onHandoffFrame(
+    void *context,
+    int opcode,
+    const unsigned char *payload,
+    size_t length,
+    bool isFirst,
+    bool isFinal,
+    size_t remaining
+) {
+    struct lws *wsi = context;
+    RelayHandoffSession *session = (RelayHandoffSession *)lws_wsi_user(wsi);
+
+    switch (opcode) {
+        case WEBSOCKET_OPCODE_CLOSE:
+            return -1;
+        case WEBSOCKET_OPCODE_PING:
+            if (isFirst) {
+                session->pingLength = 0;
+            }
+            memcpy(session->pingPayload + session->pingLength, payload, length);
+            session->pingLength += length;
+
+            if (remaining == 0) {
+                memcpy(session->pongPayload, session->pingPayload, session->pingLength);
+                session->pongLength = session->pingLength;
+                session->hasPendingPong = true;
+                lws_callback_on_writable(wsi);
+            }
+            return 0;
+        case WEBSOCKET_OPCODE_PONG:
+            return 0;
+        default:
+            break;
+    }
+
+    const int result = appendFrameFragment(
+        &session->assembler,
+        payload,
+        length,
+        isFirst && opcode != WEBSOCKET_OPCODE_CONTINUATION,
+        isFinal,
+        remaining
+    );
+
+    if (result == FRAME_ASSEMBLER_COMPLETE) {
+        routeRelayMessage(wsi, session->assembler.buffer, session->assembler.length);
+        resetFrameAssembler(&session->assembler);
+    } else if (result == FRAME_ASSEMBLER_OVERSIZED) {
+        printf("[Relay] Dropping message from %s over %d bytes\n", findRelayClientSource(wsi), FRAME_ASSEMBLER_MAX_MESSAGE);
+    }
+
+    return 0;
+}
+
+int callbackRelayHandoff(struct lws *wsi, enum lws_callback_reasons reason, void *user, void *in, size_t len) {
+    RelayHandoffSession *session = (RelayHandoffSession *)user;
+
+    switch (reason) {
+        case LWS_CALLBACK_RAW_RX:
+            if (decodeWebSocketFrames(&session->decoder, in, len, onHandoffFrame, wsi) < 0) {
+                return -1;
+            }
+            break;
+
+        case LWS_CALLBACK_RAW_WRITEABLE:
+            if (session->hasPendingPong) {
+                unsigned char frame[LWS_PRE + WEBSOCKET_FRAME_SERVER_HEADER + WEBSOCKET_CONTROL_MAX_PAYLOAD];
+                session->hasPendingPong = false;
+                const size_t headerLength = encodeWebSocketFrameHeader(frame + LWS_PRE, WEBSOCKET_OPCODE_PONG, session->pongLength);
+                memcpy(frame + LWS_PRE + headerLength, session->pongPayload, session->pongLength);
+                lws_write(wsi, frame + LWS_PRE, headerLength + session->pongLength, LWS_WRITE_RAW);
+                lws_callback_on_writable(wsi);
+                break;
+            }
+            handleRelayWritable(wsi);
+            break;
+
+        case LWS_CALLBACK_RAW_CLOSE:
+            resetFrameAssembler(&session->assembler);
+            removeRelayClient(wsi);
+            break;
+
+        default:
+            break;
+    }
+
+    return 0;
+}
@@ -0,0 +1,45 @@
+#ifndef RELAY_HANDOFF_H
+#define RELAY_HANDOFF_H
+
+#include <libwebsockets.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "frame-assembler.h"
+#include "relay.h"
+#include "websocket-frame.h"
+
+#define RELAY_HANDOFF_DEFAULT_SOCKET "/tmp/rc-car-relay-%d.sock"
+#define RELAY_HANDOFF_MAGIC 0x52484f31u
+#define RELAY_HANDOFF_PROTOCOL "relay-handoff"
+#define RELAY_LISTENER_PROTOCOL "relay-listener"
+#define RELAY_LISTEN_BACKLOG 16
+#define RELAY_HANDOFF_TIMEOUT_S 2
+#define RELAY_HANDOFF_SESSION_SIZE sizeof(RelayHandoffSession)
+
+typedef struct {
+    uint32_t magic;
+    uint32_t routeCount;
+} RelayHandoffHeader;
+
+typedef struct {
+    char source[RELAY_SOURCE_SIZE];
+    uint8_t isRawWebSocket;
+} RelayHandoffRoute;
+
+typedef struct {
+    FrameAssembler assembler;
+    WebSocketFrameDecoder decoder;
+    bool hasPendingPong;
+    unsigned char pingPayload[WEBSOCKET_CONTROL_MAX_PAYLOAD];
+    size_t pingLength;
+    unsigned char pongPayload[WEBSOCKET_CONTROL_MAX_PAYLOAD];
+    size_t pongLength;
+} RelayHandoffSession;
+
+typedef void (*RelayHandoffCallback)(int routeCount);
+
+int startRelayListener(struct lws_context *context, int port, bool isTakingOver);
+void setRelayHandoffCallback(RelayHandoffCallback callback);
+int callbackRelayHandoff(struct lws *wsi, enum lws_callback_reasons reason, void *user, void *in, size_t len);
+int callbackRelayListener(struct lws *wsi, enum lws_callback_reasons reason, void *user, void *in, size_t len);
+#endif
@@ -0,0 +1,382 @@
+#include <arpa/inet.h>
+#include <cjson/cJSON.h>
+#include <netdb.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "json-arena.h"
+#include "relay-peer.h"
+
+typedef struct {
+    char address[RELAY_SOURCE_SIZE];
+    int port;
+    char resolvedAddress[INET6_ADDRSTRLEN];
+    char relayId[RELAY_SOURCE_SIZE];
+    struct lws *wsi;
+    time_t retryAt;
+} RelayPeerLink;
+
+static struct lws_context *peerContext = NULL;
+static RelayPeerLink peerLinks[RELAY_MAX_PEERS];
+static int peerLinkCount = 0;
+static char relayId[RELAY_SOURCE_SIZE];
+static char peerSecret[RELAY_PEER_SECRET_SIZE];
+
+static RelayPeerLink *findRelayPeerLink(const struct lws *wsi) {
+    for (int i = 0; i < peerLinkCount; i++) {
+        if (peerLinks[i].wsi == wsi) {
+            return &peerLinks[i];
+        }
+    }
+
+    return NULL;
+}
+
+static void sendRelayRoutes(struct lws *wsi) {
+    char sources[RELAY_MAX_PEER_ROUTES][RELAY_SOURCE_SIZE];
+    const int count = getRelayLocalSources(sources, RELAY_MAX_PEER_ROUTES);
+    const size_t arenaMark = beginJsonArenaScope();
+    cJSON *json = cJSON_CreateObject();
+    cJSON *routes = cJSON_CreateArray();
+
+    cJSON_AddStringToObject(json, "type", RELAY_PEER_ROUTES_TYPE);
+    cJSON_AddStringToObject(json, "relay", relayId);
+    for (int i = 0; i < count; i++) {
+        cJSON_AddItemToArray(routes, cJSON_CreateString(sources[i]));
+    }
+    cJSON_AddItemToObject(json, "sources", routes);
+
+    char *message = cJSON_PrintUnformatted(json);
+    if (message != NULL) {
+        sendRelayMessage(wsi, message, strlen(message));
+        cJSON_free(message);
+    }
+
+    cJSON_Delete(json);
+    endJsonArenaScope(arenaMark);
+}
+
+static void onRelayRoutesChanged() {
+    int count;
+    const Clients *clients = getRelayClients(&count);
+
+    for (int i = 0; i < count; i++) {
+        if (clients[i].isPeer) {
+            sendRelayRoutes(clients[i].wsi);
+        }
+    }
+}
+
+static bool isPreferredRelayPeerLink(const struct lws *wsi, const char *remoteId) {
+    return (findRelayPeerLink(wsi) != NULL) == (strcmp(relayId, remoteId) < 0);
+}
+
+static int handleRelayRoutes(struct lws *wsi, const char *message) {
+    char name[RELAY_SOURCE_SIZE];
+    RelayPeerLink *link = findRelayPeerLink(wsi);
+    const size_t arenaMark = beginJsonArenaScope();
+    cJSON *json = cJSON_Parse(message);
+    const cJSON *remoteId = cJSON_GetObjectItemCaseSensitive(json, "relay");
+    const cJSON *sources = cJSON_GetObjectItemCaseSensitive(json, "sources");
+    int result = 0;
+
+    if (!cJSON_IsString(remoteId) || remoteId->valuestring == NULL || !cJSON_IsArray(sources)) {
+        cJSON_Delete(json);
+        endJsonArenaScope(arenaMark);
+        return 0;
+    }
+
+    snprintf(name, sizeof(name), "peer:%s", remoteId->valuestring);
+    if (link != NULL) {
+        snprintf(link->relayId, sizeof(link->relayId), "%s", remoteId->valuestring);
+    }
+
+    Clients *existing = findRelayPeerByName(name);
+
+    if (strcmp(remoteId->valuestring, relayId) == 0) {
+        printf("[Relay] Dropping peer link to itself\n");
+        result = -1;
+    } else if (existing != NULL && existing->wsi != wsi && !isPreferredRelayPeerLink(wsi, remoteId->valuestring)) {
+        printf("[Relay] Dropping duplicate link to %s\n", name);
+        result = -1;
+    } else {
+        if (existing != NULL && existing->wsi != wsi) {
+            struct lws *duplicate = existing->wsi;
+
+            removeRelayClient(duplicate);
+            lws_set_timeout(duplicate, PENDING_TIMEOUT_USER_OK, LWS_TO_KILL_ASYNC);
+        }
+
+        Clients *peer = findRelayPeer(wsi);
+        const cJSON *source = NULL;
+
+        if (peer != NULL) {
+            if (peer->source[0] == '\0') {
+                printf("[Relay] Peered with %s\n", remoteId->valuestring);
+            }
+            setRelayPeerName(peer, name);
+            peer->peerRouteCount = 0;
+
+            cJSON_ArrayForEach(source, sources) {
+                if (cJSON_IsString(source) && source->valuestring != NULL && peer->peerRouteCount < RELAY_MAX_PEER_ROUTES) {
+                    snprintf(peer->peerRoutes[peer->peerRouteCount++], RELAY_SOURCE_SIZE, "%s", source->valuestring);
+                }
+            }
+        }
+    }
+
+    cJSON_Delete(json);
+    endJsonArenaScope(arenaMark);
+
+    return result;
+}
+
+static bool isMatchingRelayPeerSecret(const char *secret) {
+    const size_t length = strlen(peerSecret);
+    unsigned char difference = strlen(secret) != length;
+
+    for (size_t i = 0; i < length; i++) {
+        difference |= (unsigned char)(peerSecret[i] ^ secret[i]);
+        if (secret[i] == '\0') {
+            break;
+        }
+    }
+
+    return difference == 0;
+}
+
+static bool isAuthorizedRelayPeer(struct lws *wsi) {
+    char query[RELAY_PEER_SECRET_SIZE + 16];
+    char secret[RELAY_PEER_SECRET_SIZE];
+    char address[INET6_ADDRSTRLEN];
+
+    if (peerSecret[0] != '\0') {
+        for (int i = 0; lws_hdr_copy_fragment(wsi, query, sizeof(query), WSI_TOKEN_HTTP_URI_ARGS, i) > 0; i++) {
+            if (extractQueryValue(query, "secret", secret, sizeof(secret)) && isMatchingRelayPeerSecret(secret)) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    if (lws_get_peer_simple(wsi, address, sizeof(address)) == NULL) {
+        return false;
+    }
+
+    const char *remoteAddress = strncmp(address, "::ffff:", 7) == 0 ? address + 7 : address;
+
+    for (int i = 0; i < peerLinkCount; i++) {
+        if (strcmp(peerLinks[i].resolvedAddress, remoteAddress) == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void resolveRelayPeerLink(RelayPeerLink *link) {
+    struct addrinfo hints;
+    struct addrinfo *result = NULL;
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    if (getaddrinfo(link->address, NULL, &hints, &result) != 0 || result == NULL) {
+        printf("[Relay] Could not resolve peer %s, inbound links from it need RELAY_PEER_SECRET\n", link->address);
+        return;
+    }
+
+    if (result->ai_family == AF_INET) {
+        inet_ntop(AF_INET, &((struct sockaddr_in *)result->ai_addr)->sin_addr, link->resolvedAddress, sizeof(link->resolvedAddress));
+    } else if (result->ai_family == AF_INET6) {
+        inet_ntop(AF_INET6, &((struct sockaddr_in6 *)result->ai_addr)->sin6_addr, link->resolvedAddress, sizeof(link->resolvedAddress));
+    }
+
+    freeaddrinfo(result);
+}
+
+static void connectRelayPeer(RelayPeerLink *link) {
+    struct lws_client_connect_info connectionInfo;
+    char path[RELAY_SOURCE_SIZE + RELAY_PEER_SECRET_SIZE + 16];
+
+    if (peerSecret[0] != '\0') {
+        snprintf(path, sizeof(path), "/?peer=%s&secret=%s", relayId, peerSecret);
+    } else {
+        snprintf(path, sizeof(path), "/?peer=%s", relayId);
+    }
+    memset(&connectionInfo, 0, sizeof(connectionInfo));
+    connectionInfo.context = peerContext;
+    connectionInfo.address = link->address;
+    connectionInfo.port = link->port;
+    connectionInfo.path = path;
+    connectionInfo.host = link->address;
+    connectionInfo.origin = link->address;
+    connectionInfo.protocol = RELAY_PEER_PROTOCOL;
+
+    link->retryAt = time(NULL) + RELAY_PEER_RETRY_S;
+    link->wsi = lws_client_connect_via_info(&connectionInfo);
+}
+
+void serviceRelayPeers() {
+    const time_t now = time(NULL);
+
+    for (int i = 0; i < peerLinkCount; i++) {
+        RelayPeerLink *link = &peerLinks[i];
+        char name[RELAY_SOURCE_SIZE];
+
+        snprintf(name, sizeof(name), "peer:%s", link->relayId);
+        if (link->wsi != NULL || now < link->retryAt || strcmp(link->relayId, relayId) == 0
+            || (link->relayId[0] != '\0' && findRelayPeerByName(name) != NULL)) {
+            continue;
+        }
+
+        connectRelayPeer(link);
+    }
+}
+
+int startRelayPeers(struct lws_context *context, const char *defaultRelayId) {
+    const char *configuredId = getenv("RELAY_ID");
+    const char *peers = getenv("RELAY_PEERS");
+    const char *secret = getenv("RELAY_PEER_SECRET");
+    char addresses[512];
+    char *savePointer = NULL;
+
+    peerContext = context;
+    snprintf(relayId, sizeof(relayId), "%s", configuredId != NULL && configuredId[0] != '\0' ? configuredId : defaultRelayId);
+    snprintf(peerSecret, sizeof(peerSecret), "%s", secret != NULL ? secret : "");
+    setRelayRoutesChangedCallback(onRelayRoutesChanged);
+
+    if (peers == NULL || peers[0] == '\0') {
+        return 0;
+    }
+
+    snprintf(addresses, sizeof(addresses), "%s", peers);
+
+    for (char *item = strtok_r(addresses, ",", &savePointer); item != NULL && peerLinkCount < RELAY_MAX_PEERS; item = strtok_r(NULL, ",", &savePointer)) {
+        char *separator = strrchr(item, ':');
+        RelayPeerLink *link = &peerLinks[peerLinkCount];
+
+        if (separator == NULL || atoi(separator + 1) <= 0) {
+            printf("[Relay] Ignoring peer %s, expected host:port\n", item);
+            continue;
+        }
+        *separator = '\0';
+
+        memset(link, 0, sizeof(RelayPeerLink));
+        snprintf(link->address, sizeof(link->address), "%s", item);
+        link->port = atoi(separator + 1);
+        resolveRelayPeerLink(link);
+        peerLinkCount++;
+    }
+
+    printf("[Relay] Federating as %s with %d peers\n", relayId, peerLinkCount);
+    serviceRelayPeers();
+
+    return peerLinkCount;
+}
+
+static void closeRelayPeerLink(struct lws *wsi, void *user) {
+    RelayPeerLink *link = findRelayPeerLink(wsi);
+    Clients *peer = findRelayPeer(wsi);
+
+    if (peer != NULL && peer->source[0] != '\0') {
+        printf("[Relay] Lost %s\n", peer->source);
+    }
+
+    if (user != NULL) {
+        resetFrameAssembler((FrameAssembler *)user);
+    }
+    removeRelayClient(wsi);
+
+    if (link != NULL) {
+        link->wsi = NULL;
+    }
+}
+
+int callbackRelayPeer(
+    struct lws *wsi,
+    enum lws_callback_reasons reason,
+    void *user,
+    void *in,
+    size_t len
+) {
+    switch (reason) {
+        case LWS_CALLBACK_FILTER_PROTOCOL_CONNECTION: {
+            if (!isAuthorizedRelayPeer(wsi)) {
+                printf("[Relay] Rejecting unauthorized peer link\n");
+                return -1;
+            }
+            break;
+        }
+
+        case LWS_CALLBACK_ESTABLISHED:
+        case LWS_CALLBACK_CLIENT_ESTABLISHED: {
+            if (!addRelayPeer(wsi)) {
+                return -1;
+            }
+            sendRelayRoutes(wsi);
+            break;
+        }
+
+        case LWS_CALLBACK_RECEIVE:
+        case LWS_CALLBACK_CLIENT_RECEIVE: {
+            FrameAssembler *assembler = (FrameAssembler *)user;
+            const int result = assembleWebSocketFrame(assembler, wsi, in, len);
+
+            if (result == FRAME_ASSEMBLER_OVERSIZED) {
+                printf("[Relay] Dropping message from %s over %d bytes\n", findRelayClientSource(wsi), FRAME_ASSEMBLER_MAX_MESSAGE);
+            }
+            if (result != FRAME_ASSEMBLER_COMPLETE) {
+                break;
+            }
+
+            if (strncmp(assembler->buffer, RELAY_PEER_ROUTES_PREFIX, strlen(RELAY_PEER_ROUTES_PREFIX)) == 0) {
+                const int routesResult = handleRelayRoutes(wsi, assembler->buffer);
+
+                resetFrameAssembler(assembler);
+                if (routesResult < 0) {
+                    return -1;
+                }
+            } else {
+                const Clients *peer = findRelayPeer(wsi);
+
+                if (peer != NULL && peer->source[0] != '\0') {
+                    routeRelayMessage(wsi, assembler->buffer, assembler->length);
+                }
+                resetFrameAssembler(assembler);
+            }
+            break;
+        }
+
+        case LWS_CALLBACK_SERVER_WRITEABLE:
+        case LWS_CALLBACK_CLIENT_WRITEABLE: {
+            handleRelayWritable(wsi);
+            break;
+        }
+
+        case LWS_CALLBACK_CLIENT_CONNECTION_ERROR: {
+            RelayPeerLink *link = findRelayPeerLink(wsi);
+
+            if (link != NULL) {
+                printf("[Relay] Peer %s:%d unreachable, retrying in %d s\n", link->address, link->port, RELAY_PEER_RETRY_S);
+            }
+            closeRelayPeerLink(wsi, user);
+            break;
+        }
+
+        case LWS_CALLBACK_CLOSED:
+        case LWS_CALLBACK_CLIENT_CLOSED: {
+            closeRelayPeerLink(wsi, user);
+            break;
+        }
+
+        default:
+            break;
+    }
+
+    return 0;
+}
@@ -0,0 +1,18 @@
+#ifndef RELAY_PEER_H
+#define RELAY_PEER_H
+
+#include <libwebsockets.h>
+#include "relay.h"
+
+#define RELAY_PEER_PROTOCOL "relay-peer"
+#define RELAY_PEER_SESSION_SIZE sizeof(FrameAssembler)
+#define RELAY_MAX_PEERS 4
+#define RELAY_PEER_RETRY_S 2
+#define RELAY_PEER_SECRET_SIZE 128
+#define RELAY_PEER_ROUTES_TYPE "relay-routes"
+#define RELAY_PEER_ROUTES_PREFIX "{\"type\":\"" RELAY_PEER_ROUTES_TYPE "\""
+
+int startRelayPeers(struct lws_context *context, const char *defaultRelayId);
+void serviceRelayPeers();
+int callbackRelayPeer(struct lws *wsi, enum lws_callback_reasons reason, void *user, void *in, size_t len);
+#endif
@@ -0,0 +1,744 @@
+#include <cjson/cJSON.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "json-arena.h"
+#include "relay.h"
+#include "websocket-frame.h"
+
+#define KRED "\033[0;32;31m"
+#define KBLU "\033[0;32;34m"
+#define RESET "\033[0m"
+
+typedef struct {
+    char destination[RELAY_SOURCE_SIZE];
+    RelayLocalDestinationCallback callback;
+} RelayLocalDestination;
+
+static Clients clients[RELAY_MAX_CLIENTS];
+static int clientCount = 0;
+static RelayLocalDestination localDestinations[RELAY_MAX_LOCAL_DESTINATIONS];
+static int localDestinationCount = 0;
+static RelayFrameObserver relayFrameObserver = NULL;
+static RelayWritableCallback relayWritableCallback = NULL;
+static RelayRoutesChangedCallback relayRoutesChangedCallback = NULL;
+static RelaySource sources[RELAY_MAX_SOURCES];
+static int sourceCount = 0;
+static RelaySource sharedSource = {"*"};
+static double defaultRate = 0.0;
+static double defaultBurst = 0.0;
+static const char *safetyActions[] = {"set-esc-to-neutral-position", "stop-waypoints"};
+
+int extractQueryValue(const char *queryString, const char *key, char *output, size_t outputSize) {
+    if (!queryString || !key || !output || outputSize == 0) {
+        return 0;
+    }
+
+    const char *keyStart = strstr(queryString, key);
+    if (!keyStart) {
+        return 0;
+    }
+
+    keyStart += strlen(key);
+    if (*keyStart != '=') {
+        return 0;
+    }
+
+    keyStart++;
+    const char *valueEnd = strchr(keyStart, '&');
+    size_t valueLength = valueEnd ? (size_t) (valueEnd - keyStart) : strlen(keyStart);
+
+    if (valueLength >= outputSize) {
+        return 0;
+    }
+
+    strncpy(output, keyStart, valueLength);
+    output[valueLength] = '\0';
+    return 1;
+}
+
+int registerRelayLocalDestination(const char *destination, RelayLocalDestinationCallback callback) {
+    if (localDestinationCount == RELAY_MAX_LOCAL_DESTINATIONS) {
+        return -1;
+    }
+
+    snprintf(localDestinations[localDestinationCount].destination, RELAY_SOURCE_SIZE, "%s", destination);
+    localDestinations[localDestinationCount].callback = callback;
+    localDestinationCount++;
+
+    return 0;
+}
+
+void setRelayFrameObserver(RelayFrameObserver observer) {
+    relayFrameObserver = observer;
+}
+
+void setRelayWritableCallback(RelayWritableCallback callback) {
+    relayWritableCallback = callback;
+}
+
+void setRelayRoutesChangedCallback(RelayRoutesChangedCallback callback) {
+    relayRoutesChangedCallback = callback;
+}
+
+struct lws *findRelayClient(const char *source) {
+    for (int i = 0; i < clientCount; i++) {
+        if (!clients[i].isPeer && strcmp(clients[i].source, source) == 0) {
+            return clients[i].wsi;
+        }
+    }
+
+    return NULL;
+}
+
+const char *findRelayClientSource(const struct lws *wsi) {
+    for (int i = 0; i < clientCount; i++) {
+        if (clients[i].wsi == wsi) {
+            return clients[i].source;
+        }
+    }
+
+    return "";
+}
+
+static long nowNs() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000000L + now.tv_nsec;
+}
+
+static bool parseRelayRateLimit(const char *value, double *rate, double *burst) {
+    if (value == NULL || sscanf(value, "%lf:%lf", rate, burst) != 2 || *rate < 0.0 || *burst < 1.0) {
+        return false;
+    }
+
+    return true;
+}
+
+static void resetRelaySourceBucket(RelaySource *entry, double rate, double burst) {
+    entry->rate = rate;
+    entry->burst = burst;
+    entry->tokens = burst;
+    entry->refilledAtNs = nowNs();
+}
+
+static RelaySource *findRelaySource(const char *source, bool isCreating) {
+    RelaySource *entry = NULL;
+
+    for (int i = 0; i < sourceCount; i++) {
+        if (sources[i].source[0] != '\0' && strcmp(sources[i].source, source) == 0) {
+            return &sources[i];
+        }
+    }
+
+    if (!isCreating) {
+        return NULL;
+    }
+
+    for (int i = 0; i < sourceCount && entry == NULL; i++) {
+        if (sources[i].source[0] == '\0') {
+            entry = &sources[i];
+        }
+    }
+
+    if (entry == NULL && sourceCount < RELAY_MAX_SOURCES) {
+        entry = &sources[sourceCount++];
+    }
+
+    if (entry == NULL) {
+        return NULL;
+    }
+
+    memset(entry, 0, sizeof(RelaySource));
+    snprintf(entry->source, sizeof(entry->source), "%s", source);
+    resetRelaySourceBucket(entry, defaultRate, defaultBurst);
+
+    return entry;
+}
+
+static RelaySource *acquireRelaySource(const char *source) {
+    RelaySource *entry = findRelaySource(source, true);
+
+    if (entry == NULL) {
+        printf("[Relay] Source table full, %s shares the default rate limit\n", source);
+        entry = &sharedSource;
+    }
+
+    entry->clientCount++;
+
+    return entry;
+}
+
+static void reportRelaySource(RelaySource *entry, bool isChangedOnly) {
+    if (isChangedOnly && entry->throttled == entry->reportedThrottled && entry->bulkDropped == entry->reportedBulkDropped) {
+        return;
+    }
+
+    printf(
+        "[Relay] %s: %ld forwarded, %ld throttled, %ld bulk messages dropped\n",
+        entry->source,
+        entry->forwarded,
+        entry->throttled,
+        entry->bulkDropped
+    );
+    entry->reportedThrottled = entry->throttled;
+    entry->reportedBulkDropped = entry->bulkDropped;
+}
+
+static void releaseRelaySource(RelaySource *entry) {
+    if (entry == NULL || --entry->clientCount > 0 || entry == &sharedSource || entry->isConfigured) {
+        return;
+    }
+
+    reportRelaySource(entry, true);
+    memset(entry, 0, sizeof(RelaySource));
+}
+
+void loadRelayRateLimits() {
+    const char *sourceLimits = getenv("RELAY_SOURCE_RATE_LIMITS");
+    char limits[512];
+    char *savePointer = NULL;
+
+    if (!parseRelayRateLimit(getenv("RELAY_RATE_LIMIT"), &defaultRate, &defaultBurst)) {
+        defaultRate = 0.0;
+        defaultBurst = 0.0;
+    }
+    resetRelaySourceBucket(&sharedSource, defaultRate, defaultBurst);
+
+    if (sourceLimits == NULL) {
+        return;
+    }
+
+    snprintf(limits, sizeof(limits), "%s", sourceLimits);
+
+    for (char *item = strtok_r(limits, ",", &savePointer); item != NULL; item = strtok_r(NULL, ",", &savePointer)) {
+        char *separator = strchr(item, '=');
+        double rate;
+        double burst;
+
+        if (separator == NULL) {
+            continue;
+        }
+        *separator = '\0';
+
+        RelaySource *entry = findRelaySource(item, true);
+        if (entry != NULL && parseRelayRateLimit(separator + 1, &rate, &burst)) {
+            resetRelaySourceBucket(entry, rate, burst);
+            entry->isConfigured = true;
+            printf("[Relay] Limiting %s to %.1f messages/s, burst %.0f\n", entry->source, rate, burst);
+        }
+    }
+
+    if (defaultRate > 0.0) {
+        printf("[Relay] Limiting other sources to %.1f messages/s, burst %.0f\n", defaultRate, defaultBurst);
+    }
+}
+
+static RelaySource *getRelayBucket(RelaySource *entry) {
+    return entry != NULL ? entry : &sharedSource;
+}
+
+static bool takeRelayToken(RelaySource *entry) {
+    entry = getRelayBucket(entry);
+
+    if (entry->rate <= 0.0) {
+        return true;
+    }
+
+    const long now = nowNs();
+    entry->tokens += (double)(now - entry->refilledAtNs) / 1e9 * entry->rate;
+    entry->refilledAtNs = now;
+    if (entry->tokens > entry->burst) {
+        entry->tokens = entry->burst;
+    }
+
+    if (entry->tokens < 1.0) {
+        return false;
+    }
+
+    entry->tokens -= 1.0;
+
+    return true;
+}
+
+static bool isSafetyAction(const cJSON *json) {
+    const cJSON *data = cJSON_GetObjectItemCaseSensitive(json, "data");
+    const cJSON *action = cJSON_GetObjectItemCaseSensitive(data, "action");
+
+    if (!cJSON_IsString(action) || action->valuestring == NULL) {
+        return false;
+    }
+
+    for (size_t i = 0; i < sizeof(safetyActions) / sizeof(safetyActions[0]); i++) {
+        if (strcmp(action->valuestring, safetyActions[i]) == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static RelayLane getRelayLane(const cJSON *json) {
+    const cJSON *type = cJSON_GetObjectItemCaseSensitive(json, "type");
+
+    return cJSON_IsString(type) && type->valuestring && strcmp(type->valuestring, "telemetry") == 0 ? RELAY_LANE_BULK : RELAY_LANE_CONTROL;
+}
+
+static void initRelayQueues(Clients *client) {
+    for (int lane = 0; lane < RELAY_LANE_COUNT; lane++) {
+        memset(&client->queues[lane], 0, sizeof(RelayQueue));
+    }
+    client->queues[RELAY_LANE_CONTROL].size = RELAY_CONTROL_QUEUE_SIZE;
+    client->queues[RELAY_LANE_BULK].size = RELAY_BULK_QUEUE_SIZE;
+}
+
+static void popRelayQueue(RelayQueue *queue) {
+    RelayQueuedMessage *queued = &queue->messages[queue->head];
+
+    releaseFrameBuffer(queued->buffer, queued->capacity);
+    memset(queued, 0, sizeof(RelayQueuedMessage));
+    queue->head = (queue->head + 1) % queue->size;
+    queue->count--;
+}
+
+static void evictRelayQueueMessage(RelayQueue *queue) {
+    int evicted = 0;
+
+    while (evicted < queue->count && queue->messages[(queue->head + evicted) % queue->size].isSafety) {
+        evicted++;
+    }
+
+    if (evicted == queue->count) {
+        evicted = 0;
+    }
+
+    RelayQueuedMessage *queued = &queue->messages[(queue->head + evicted) % queue->size];
+    releaseFrameBuffer(queued->buffer, queued->capacity);
+
+    for (int i = evicted; i < queue->count - 1; i++) {
+        queue->messages[(queue->head + i) % queue->size] = queue->messages[(queue->head + i + 1) % queue->size];
+    }
+
+    memset(&queue->messages[(queue->head + queue->count - 1) % queue->size], 0, sizeof(RelayQueuedMessage));
+    queue->count--;
+}
+
+static void clearRelayQueues(Clients *client) {
+    for (int lane = 0; lane < RELAY_LANE_COUNT; lane++) {
+        while (client->queues[lane].count > 0) {
+            popRelayQueue(&client->queues[lane]);
+        }
+    }
+}
+
+static bool enqueueRelayMessage(Clients *client, RelayLane lane, const char *message, size_t length, bool isSafety) {
+    RelayQueue *queue = &client->queues[lane];
+    size_t capacity;
+
+    if (queue->count == queue->size) {
+        if (lane == RELAY_LANE_BULK) {
+            popRelayQueue(queue);
+            if (client->sourceEntry != NULL) {
+                client->sourceEntry->bulkDropped++;
+            }
+        } else if (isSafety) {
+            evictRelayQueueMessage(queue);
+            printf("[Relay] Control lane for %s full, evicted a queued message for a safety action\n", client->source);
+        } else {
+            return false;
+        }
+    }
+
+    char *buffer = acquireFrameBuffer(LWS_PRE + length, &capacity);
+    if (buffer == NULL) {
+        return false;
+    }
+
+    RelayQueuedMessage *queued = &queue->messages[(queue->head + queue->count) % queue->size];
+    memcpy(buffer + LWS_PRE, message, length);
+    queued->buffer = buffer;
+    queued->capacity = capacity;
+    queued->length = length;
+    queued->isSafety = isSafety;
+    queue->count++;
+
+    lws_callback_on_writable(client->wsi);
+
+    return true;
+}
+
+static Clients *findRelayClientByWsi(const struct lws *wsi) {
+    for (int i = 0; i < clientCount; i++) {
+        if (clients[i].wsi == wsi) {
+            return &clients[i];
+        }
+    }
+
+    return NULL;
+}
+
+static bool writeQueuedRelayMessage(Clients *client) {
+    for (int lane = 0; lane < RELAY_LANE_COUNT; lane++) {
+        RelayQueue *queue = &client->queues[lane];
+
+        if (queue->count == 0) {
+            continue;
+        }
+
+        const RelayQueuedMessage *queued = &queue->messages[queue->head];
+        unsigned char *payload = (unsigned char *)queued->buffer + LWS_PRE;
+
+        if (client->isRawWebSocket) {
+            unsigned char header[WEBSOCKET_FRAME_SERVER_HEADER];
+            const size_t headerLength = encodeWebSocketFrameHeader(header, WEBSOCKET_OPCODE_TEXT, queued->length);
+
+            memcpy(payload - headerLength, header, headerLength);
+            lws_write(client->wsi, payload - headerLength, headerLength + queued->length, LWS_WRITE_RAW);
+        } else {
+            lws_write(client->wsi, payload, queued->length, LWS_WRITE_TEXT);
+        }
+        printf(KBLU"[websocket_write to %s] %.*s\n"RESET, client->source, (int)queued->length, queued->buffer + LWS_PRE);
+        popRelayQueue(queue);
+
+        return true;
+    }
+
+    return false;
+}
+
+static bool hasQueuedRelayMessages(const Clients *client) {
+    return client->queues[RELAY_LANE_CONTROL].count > 0 || client->queues[RELAY_LANE_BULK].count > 0;
+}
+
+static Clients *insertRelayClient(struct lws *wsi, const char *source) {
+    if (clientCount == RELAY_MAX_CLIENTS) {
+        return NULL;
+    }
+
+    Clients *client = &clients[clientCount++];
+    memset(client, 0, sizeof(Clients));
+    client->wsi = wsi;
+    snprintf(client->source, sizeof(client->source), "%s", source);
+    initRelayQueues(client);
+
+    return client;
+}
+
+bool addRelayClient(struct lws *wsi, const char *source, bool isRawWebSocket) {
+    Clients *client = insertRelayClient(wsi, source);
+
+    if (client == NULL) {
+        return false;
+    }
+
+    client->sourceEntry = acquireRelaySource(source);
+    client->isRawWebSocket = isRawWebSocket;
+
+    if (relayRoutesChangedCallback) {
+        relayRoutesChangedCallback();
+    }
+
+    return true;
+}
+
+bool addRelayPeer(struct lws *wsi) {
+    Clients *client = insertRelayClient(wsi, "");
+
+    if (client == NULL) {
+        return false;
+    }
+
+    client->isPeer = true;
+
+    return true;
+}
+
+Clients *findRelayPeer(const struct lws *wsi) {
+    Clients *client = findRelayClientByWsi(wsi);
+
+    return client != NULL && client->isPeer ? client : NULL;
+}
+
+Clients *findRelayPeerByName(const char *name) {
+    for (int i = 0; i < clientCount; i++) {
+        if (clients[i].isPeer && strcmp(clients[i].source, name) == 0) {
+            return &clients[i];
+        }
+    }
+
+    return NULL;
+}
+
+void setRelayPeerName(Clients *peer, const char *name) {
+    RelaySource *entry = findRelaySource(name, false);
+
+    snprintf(peer->source, sizeof(peer->source), "%s", name);
+    if (peer->sourceEntry != NULL && peer->sourceEntry == entry) {
+        return;
+    }
+
+    releaseRelaySource(peer->sourceEntry);
+    peer->sourceEntry = NULL;
+
+    if (entry != NULL && entry->isConfigured) {
+        entry->clientCount++;
+        peer->sourceEntry = entry;
+    }
+}
+
+static bool hasRelaySourceName(char sources[][RELAY_SOURCE_SIZE], int count, const char *source) {
+    for (int i = 0; i < count; i++) {
+        if (strcmp(sources[i], source) == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+int getRelayLocalSources(char sources[][RELAY_SOURCE_SIZE], int maxCount) {
+    int count = 0;
+
+    for (int i = 0; i < localDestinationCount && count < maxCount; i++) {
+        if (!hasRelaySourceName(sources, count, localDestinations[i].destination)) {
+            snprintf(sources[count++], RELAY_SOURCE_SIZE, "%s", localDestinations[i].destination);
+        }
+    }
+
+    for (int i = 0; i < clientCount && count < maxCount; i++) {
+        if (!clients[i].isPeer && clients[i].source[0] != '\0' && !hasRelaySourceName(sources, count, clients[i].source)) {
+            snprintf(sources[count++], RELAY_SOURCE_SIZE, "%s", clients[i].source);
+        }
+    }
+
+    return count;
+}
+
+bool sendRelayMessage(struct lws *wsi, const char *message, size_t length) {
+    Clients *client = findRelayClientByWsi(wsi);
+
+    return client != NULL && enqueueRelayMessage(client, RELAY_LANE_CONTROL, message, length, false);
+}
+
+static bool hasRelayPeerRoute(const Clients *peer, const char *destination) {
+    for (int i = 0; i < peer->peerRouteCount; i++) {
+        if (strcmp(peer->peerRoutes[i], destination) == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+struct lws *findRelayRoute(const char *destination) {
+    struct lws *wsi = findRelayClient(destination);
+
+    for (int i = 0; i < clientCount && wsi == NULL; i++) {
+        if (clients[i].isPeer && hasRelayPeerRoute(&clients[i], destination)) {
+            wsi = clients[i].wsi;
+        }
+    }
+
+    return wsi;
+}
+
+void removeRelayClient(struct lws *wsi) {
+    for (int i = 0; i < clientCount; i++) {
+        if (clients[i].wsi == wsi) {
+            const bool isPeer = clients[i].isPeer;
+
+            releaseRelaySource(clients[i].sourceEntry);
+            clearRelayQueues(&clients[i]);
+            for (int j = i; j < clientCount - 1; j++) {
+                clients[j] = clients[j + 1];
+            }
+            clientCount--;
+            memset(&clients[clientCount], 0, sizeof(Clients));
+
+            if (!isPeer && relayRoutesChangedCallback) {
+                relayRoutesChangedCallback();
+            }
+            return;
+        }
+    }
+}
+
+const Clients *getRelayClients(int *count) {
+    *count = clientCount;
+    return clients;
+}
+
+void handleRelayWritable(struct lws *wsi) {
+    Clients *client = findRelayClientByWsi(wsi);
+
+    if (client != NULL && hasQueuedRelayMessages(client)) {
+        if (!lws_send_pipe_choked(wsi)) {
+            writeQueuedRelayMessage(client);
+        }
+        lws_callback_on_writable(wsi);
+        return;
+    }
+
+    if (relayWritableCallback) {
+        relayWritableCallback(wsi);
+    }
+}
+
+int getRelaySources(RelaySource *entries, int maxCount) {
+    int count = 0;
+
+    for (int i = 0; i < sourceCount && count < maxCount; i++) {
+        if (sources[i].source[0] != '\0') {
+            entries[count++] = sources[i];
+        }
+    }
+
+    return count;
+}
+
+void reportRelaySourceStats(bool isChangedOnly) {
+    for (int i = 0; i < sourceCount; i++) {
+        if (sources[i].source[0] != '\0') {
+            reportRelaySource(&sources[i], isChangedOnly);
+        }
+    }
+    reportRelaySource(&sharedSource, true);
+
+    for (int i = 0; i < clientCount; i++) {
+        Clients *peer = &clients[i];
+
+        if (!peer->isPeer || (isChangedOnly && peer->peerForwarded == peer->reportedPeerForwarded && peer->peerReceived == peer->reportedPeerReceived)) {
+            continue;
+        }
+
+        printf(
+            "[Relay] %s: %d routes, %ld forwarded, %ld received\n",
+            peer->source,
+            peer->peerRouteCount,
+            peer->peerForwarded,
+            peer->peerReceived
+        );
+        peer->reportedPeerForwarded = peer->peerForwarded;
+        peer->reportedPeerReceived = peer->peerReceived;
+    }
+}
+
+int routeRelayMessage(struct lws *from, const char *message, size_t length) {
+    int delivered = 0;
+    const size_t arenaMark = beginJsonArenaScope();
+    cJSON *json = cJSON_Parse(message);
+
+    if (!json) {
+        endJsonArenaScope(arenaMark);
+        return 0;
+    }
+
+    const cJSON *to = cJSON_GetObjectItemCaseSensitive(json, "to");
+    Clients *sender = findRelayClientByWsi(from);
+    RelaySource *sourceEntry = sender != NULL ? sender->sourceEntry : NULL;
+    const bool isFromPeer = sender != NULL && sender->isPeer;
+    const bool isSafety = isSafetyAction(json);
+    const bool isRateLimited = !isSafety && !(isFromPeer && sourceEntry == NULL);
+
+    if (isRateLimited && !takeRelayToken(sourceEntry)) {
+        getRelayBucket(sourceEntry)->throttled++;
+        if (relayFrameObserver) {
+            relayFrameObserver(findRelayClientSource(from), cJSON_IsString(to) && to->valuestring ? to->valuestring : "", message, length, true);
+        }
+        cJSON_Delete(json);
+        endJsonArenaScope(arenaMark);
+        return 0;
+    }
+
+    if (sourceEntry != NULL) {
+        sourceEntry->forwarded++;
+    }
+    if (isFromPeer) {
+        sender->peerReceived++;
+    }
+
+    if (cJSON_IsString(to) && to->valuestring) {
+        const RelayLane lane = getRelayLane(json);
+
+        if (relayFrameObserver) {
+            relayFrameObserver(findRelayClientSource(from), to->valuestring, message, length, false);
+        }
+
+        for (int i = 0; i < localDestinationCount; i++) {
+            if (strcmp(localDestinations[i].destination, to->valuestring) == 0) {
+                localDestinations[i].callback(message);
+                delivered++;
+            }
+        }
+
+        for (int i = 0; i < clientCount; i++) {
+            if (clients[i].isPeer) {
+                if (!isFromPeer && hasRelayPeerRoute(&clients[i], to->valuestring) && enqueueRelayMessage(&clients[i], lane, message, length, isSafety)) {
+                    clients[i].peerForwarded++;
+                    delivered++;
+                }
+            } else if (strcmp(clients[i].source, to->valuestring) == 0 && enqueueRelayMessage(&clients[i], lane, message, length, isSafety)) {
+                delivered++;
+            }
+        }
+    }
+
+    cJSON_Delete(json);
+    endJsonArenaScope(arenaMark);
+
+    return delivered;
+}
+
+int callbackRelay(
+    struct lws *wsi,
+    enum lws_callback_reasons reason,
+    void *user,
+    void *in,
+    size_t len
+) {
+    char query[256] = {0};
+    char source[RELAY_SOURCE_SIZE] = {0};
+
+    switch (reason) {
+        case LWS_CALLBACK_ESTABLISHED: {
+            if (lws_hdr_copy_fragment(wsi, query, sizeof(query), WSI_TOKEN_HTTP_URI_ARGS, 0) > 0) {
+                extractQueryValue(query, "source", source, sizeof(source));
+
+                if (!addRelayClient(wsi, source, false)) {
+                    lws_close_reason(wsi, LWS_CLOSE_STATUS_GOINGAWAY, NULL, 0);
+                }
+            }
+            break;
+        }
+
+        case LWS_CALLBACK_RECEIVE: {
+            FrameAssembler *assembler = (FrameAssembler *)user;
+            const int result = assembleWebSocketFrame(assembler, wsi, in, len);
+
+            if (result == FRAME_ASSEMBLER_COMPLETE) {
+                routeRelayMessage(wsi, assembler->buffer, assembler->length);
+                resetFrameAssembler(assembler);
+            } else if (result == FRAME_ASSEMBLER_OVERSIZED) {
+                printf(KRED"[Relay] Dropping message from %s over %d bytes\n"RESET, findRelayClientSource(wsi), FRAME_ASSEMBLER_MAX_MESSAGE);
+            }
+            break;
+        }
+
+        case LWS_CALLBACK_SERVER_WRITEABLE: {
+            handleRelayWritable(wsi);
+            break;
+        }
+
+        case LWS_CALLBACK_CLOSED: {
+            resetFrameAssembler((FrameAssembler *)user);
+            removeRelayClient(wsi);
+            break;
+        }
+
+        default:
+            break;
+    }
+
+    return 0;
+}
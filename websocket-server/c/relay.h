@@ -0,0 +1,96 @@
+#ifndef RELAY_H
+#define RELAY_H
+
+#include <libwebsockets.h>
+#include <stdbool.h>
+#include "frame-assembler.h"
+
+#define RELAY_MAX_CLIENTS 8
+#define RELAY_MAX_LOCAL_DESTINATIONS 4
+#define RELAY_SOURCE_SIZE 128
+#define RELAY_SESSION_SIZE sizeof(FrameAssembler)
+#define RELAY_MAX_SOURCES 16
+#define RELAY_CONTROL_QUEUE_SIZE 32
+#define RELAY_BULK_QUEUE_SIZE 8
+#define RELAY_STATS_INTERVAL_S 10
+#define RELAY_MAX_PEER_ROUTES 16
+
+typedef enum {
+    RELAY_LANE_CONTROL,
+    RELAY_LANE_BULK,
+    RELAY_LANE_COUNT
+} RelayLane;
+
+typedef struct {
+    char *buffer;
+    size_t capacity;
+    size_t length;
+    bool isSafety;
+} RelayQueuedMessage;
+
+typedef struct {
+    RelayQueuedMessage messages[RELAY_CONTROL_QUEUE_SIZE];
+    int head;
+    int count;
+    int size;
+} RelayQueue;
+
+typedef struct {
+    char source[RELAY_SOURCE_SIZE];
+    double rate;
+    double burst;
+    double tokens;
+    long refilledAtNs;
+    long forwarded;
+    long throttled;
+    long bulkDropped;
+    long reportedThrottled;
+    long reportedBulkDropped;
+    int clientCount;
+    bool isConfigured;
+} RelaySource;
+
+typedef struct {
+    struct lws *wsi;
+    char source[RELAY_SOURCE_SIZE];
+    RelaySource *sourceEntry;
+    bool isRawWebSocket;
+    RelayQueue queues[RELAY_LANE_COUNT];
+    bool isPeer;
+    char peerRoutes[RELAY_MAX_PEER_ROUTES][RELAY_SOURCE_SIZE];
+    int peerRouteCount;
+    long peerForwarded;
+    long peerReceived;
+    long reportedPeerForwarded;
+    long reportedPeerReceived;
+} Clients;
+
+typedef void (*RelayLocalDestinationCallback)(const char *message);
+typedef void (*RelayFrameObserver)(const char *source, const char *destination, const void *payload, size_t length, bool isDropped);
+typedef void (*RelayWritableCallback)(struct lws *wsi);
+typedef void (*RelayRoutesChangedCallback)();
+
+int callbackRelay(struct lws *wsi, enum lws_callback_reasons reason, void *user, void *in, size_t len);
+int extractQueryValue(const char *queryString, const char *key, char *output, size_t outputSize);
+int registerRelayLocalDestination(const char *destination, RelayLocalDestinationCallback callback);
+void setRelayFrameObserver(RelayFrameObserver observer);
+void setRelayWritableCallback(RelayWritableCallback callback);
+void setRelayRoutesChangedCallback(RelayRoutesChangedCallback callback);
+struct lws *findRelayClient(const char *source);
+const char *findRelayClientSource(const struct lws *wsi);
+int routeRelayMessage(struct lws *from, const char *message, size_t length);
+bool addRelayClient(struct lws *wsi, const char *source, bool isRawWebSocket);
+void removeRelayClient(struct lws *wsi);
+bool addRelayPeer(struct lws *wsi);
+Clients *findRelayPeer(const struct lws *wsi);
+Clients *findRelayPeerByName(const char *name);
+void setRelayPeerName(Clients *peer, const char *name);
+struct lws *findRelayRoute(const char *destination);
+int getRelayLocalSources(char sources[][RELAY_SOURCE_SIZE], int maxCount);
+bool sendRelayMessage(struct lws *wsi, const char *message, size_t length);
+const Clients *getRelayClients(int *count);
+void handleRelayWritable(struct lws *wsi);
+void loadRelayRateLimits();
+int getRelaySources(RelaySource *sources, int maxCount);
+void reportRelaySourceStats(bool isChangedOnly);
+#endif
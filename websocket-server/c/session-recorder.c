@@ -0,0 +1,166 @@
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include "session-recorder.h"
+
+static char sessionDirectory[512];
+static FILE *segmentFile = NULL;
+static FILE *indexFile = NULL;
+static uint32_t segmentNumber = 0;
+static uint64_t segmentOffset = 0;
+static uint64_t segmentBytesLimit = SESSION_RECORDER_DEFAULT_SEGMENT_BYTES;
+static uint64_t lastFlushAtNs = 0;
+static unsigned long recordedFrames = 0;
+
+static uint64_t getClockNs(clockid_t clock) {
+    struct timespec now;
+    clock_gettime(clock, &now);
+    return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+}
+
+static uint64_t nowNs() {
+    return getClockNs(CLOCK_MONOTONIC);
+}
+
+static int openSessionSegment() {
+    char path[600];
+
+    if (segmentFile != NULL) {
+        fclose(segmentFile);
+    }
+
+    segmentNumber++;
+    segmentOffset = 0;
+    snprintf(path, sizeof(path), SESSION_RECORDER_SEGMENT_FORMAT, sessionDirectory, segmentNumber);
+
+    segmentFile = fopen(path, "wbx");
+    if (segmentFile == NULL) {
+        perror("[SessionRecorder] Failed to open segment");
+        return -1;
+    }
+
+    printf("[SessionRecorder] Writing %s\n", path);
+
+    return 0;
+}
+
+int openSessionRecorder() {
+    const char *directory = getenv("RELAY_RECORD_DIR");
+    const char *segmentBytes = getenv("RELAY_RECORD_SEGMENT_BYTES");
+    const time_t startedAt = time(NULL);
+    char startedAtText[32];
+    char path[600];
+
+    if (directory == NULL || directory[0] == '\0') {
+        return -1;
+    }
+
+    if (mkdir(directory, 0755) != 0 && errno != EEXIST) {
+        perror("[SessionRecorder] Failed to create directory");
+        return -1;
+    }
+
+    if (segmentBytes != NULL && atoll(segmentBytes) > 0) {
+        segmentBytesLimit = (uint64_t)atoll(segmentBytes);
+    }
+
+    strftime(startedAtText, sizeof(startedAtText), "%Y%m%d-%H%M%S", localtime(&startedAt));
+    snprintf(sessionDirectory, sizeof(sessionDirectory), SESSION_RECORDER_SESSION_FORMAT, directory, startedAtText, (int)getpid());
+
+    if (mkdir(sessionDirectory, 0755) != 0) {
+        perror("[SessionRecorder] Failed to create session directory");
+        return -1;
+    }
+
+    snprintf(path, sizeof(path), "%s/" SESSION_RECORDER_INDEX_FILE, sessionDirectory);
+
+    indexFile = fopen(path, "wbx");
+    if (indexFile == NULL) {
+        perror("[SessionRecorder] Failed to open index");
+        return -1;
+    }
+
+    SessionIndexHeader indexHeader = {0};
+    indexHeader.magic = SESSION_RECORDER_INDEX_MAGIC;
+    indexHeader.version = SESSION_RECORDER_VERSION;
+    indexHeader.monotonicBaseNs = nowNs();
+    indexHeader.realtimeBaseNs = getClockNs(CLOCK_REALTIME);
+    fwrite(&indexHeader, sizeof(indexHeader), 1, indexFile);
+
+    if (openSessionSegment() != 0) {
+        fclose(indexFile);
+        indexFile = NULL;
+        return -1;
+    }
+
+    lastFlushAtNs = nowNs();
+
+    return 0;
+}
+
+void recordSessionFrame(const char *source, const char *destination, const void *payload, size_t length, bool isDropped) {
+    if (segmentFile == NULL) {
+        return;
+    }
+
+    SessionFrameHeader header = {0};
+    header.magic = SESSION_RECORDER_MAGIC;
+    header.length = (uint32_t)length;
+    header.receivedAtNs = nowNs();
+    header.sourceLength = (uint16_t)strlen(source);
+    header.destinationLength = (uint16_t)strlen(destination);
+    header.flags = isDropped ? SESSION_FRAME_DROPPED : 0;
+
+    const uint64_t frameSize = sizeof(header) + header.sourceLength + header.destinationLength + length;
+
+    if (segmentOffset > 0 && segmentOffset + frameSize > segmentBytesLimit && openSessionSegment() != 0) {
+        return;
+    }
+
+    SessionIndexEntry entry = {0};
+    entry.segment = segmentNumber;
+    entry.offset = segmentOffset;
+    entry.receivedAtNs = header.receivedAtNs;
+
+    fwrite(&header, sizeof(header), 1, segmentFile);
+    fwrite(source, 1, header.sourceLength, segmentFile);
+    fwrite(destination, 1, header.destinationLength, segmentFile);
+    fwrite(payload, 1, length, segmentFile);
+    fwrite(&entry, sizeof(entry), 1, indexFile);
+
+    segmentOffset += frameSize;
+    recordedFrames++;
+}
+
+void flushSessionRecorder() {
+    if (segmentFile == NULL) {
+        return;
+    }
+
+    const uint64_t now = nowNs();
+
+    if (now - lastFlushAtNs < SESSION_RECORDER_FLUSH_INTERVAL_NS) {
+        return;
+    }
+
+    fflush(segmentFile);
+    fflush(indexFile);
+    lastFlushAtNs = now;
+}
+
+void closeSessionRecorder() {
+    if (segmentFile == NULL) {
+        return;
+    }
+
+    fclose(segmentFile);
+    fclose(indexFile);
+    segmentFile = NULL;
+    indexFile = NULL;
+
+    printf("[SessionRecorder] Recorded %lu frames in %u segments\n", recordedFrames, segmentNumber);
+}
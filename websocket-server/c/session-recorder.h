@@ -0,0 +1,45 @@
+#ifndef SESSION_RECORDER_H
+#define SESSION_RECORDER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define SESSION_RECORDER_MAGIC 0x52435352u
+#define SESSION_RECORDER_INDEX_MAGIC 0x52435349u
+#define SESSION_RECORDER_VERSION 2
+#define SESSION_RECORDER_DEFAULT_SEGMENT_BYTES (64 * 1024 * 1024)
+#define SESSION_RECORDER_FLUSH_INTERVAL_NS 1000000000ull
+#define SESSION_RECORDER_INDEX_FILE "session.idx"
+#define SESSION_RECORDER_SEGMENT_FORMAT "%s/session-%06u.log"
+#define SESSION_RECORDER_SESSION_FORMAT "%s/%s-%d"
+#define SESSION_FRAME_DROPPED 0x1u
+
+typedef struct {
+    uint32_t magic;
+    uint32_t length;
+    uint64_t receivedAtNs;
+    uint16_t sourceLength;
+    uint16_t destinationLength;
+    uint32_t flags;
+} SessionFrameHeader;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t monotonicBaseNs;
+    uint64_t realtimeBaseNs;
+} SessionIndexHeader;
+
+typedef struct {
+    uint32_t segment;
+    uint32_t reserved;
+    uint64_t offset;
+    uint64_t receivedAtNs;
+} SessionIndexEntry;
+
+int openSessionRecorder();
+void closeSessionRecorder();
+void recordSessionFrame(const char *source, const char *destination, const void *payload, size_t length, bool isDropped);
+void flushSessionRecorder();
+#endif
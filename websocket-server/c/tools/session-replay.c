@@ -0,0 +1,350 @@
+#include <libwebsockets.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "../session-recorder.h"
+
+#define MAX_REPLAY_CONNECTIONS 16
+#define MAX_REPLAY_FILTERS 16
+#define REPLAY_CONNECT_TIMEOUT_NS 5000000000ull
+#define REPLAY_MAX_FRAME_SIZE (1024 * 1024)
+
+typedef struct {
+    char source[128];
+    char path[160];
+    struct lws *wsi;
+    bool isEstablished;
+} ReplayConnection;
+
+static ReplayConnection connections[MAX_REPLAY_CONNECTIONS];
+static int connectionCount = 0;
+static const char *sourceFilters[MAX_REPLAY_FILTERS];
+static int sourceFilterCount = 0;
+
+static uint64_t nowNs() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+}
+
+static int callbackReplay(
+    struct lws *wsi,
+    enum lws_callback_reasons reason,
+    void *user,
+    void *in,
+    size_t len
+) {
+    for (int i = 0; i < connectionCount; i++) {
+        if (connections[i].wsi != wsi) {
+            continue;
+        }
+
+        if (reason == LWS_CALLBACK_CLIENT_ESTABLISHED) {
+            connections[i].isEstablished = true;
+        } else if (reason == LWS_CALLBACK_CLIENT_CLOSED || reason == LWS_CALLBACK_CLIENT_CONNECTION_ERROR) {
+            fprintf(stderr, "[Replay] Connection for %s closed\n", connections[i].source);
+            connections[i].isEstablished = false;
+            connections[i].wsi = NULL;
+        }
+    }
+
+    return 0;
+}
+
+static bool isSourceSelected(const char *source) {
+    if (sourceFilterCount == 0) {
+        return true;
+    }
+
+    for (int i = 0; i < sourceFilterCount; i++) {
+        if (strcmp(sourceFilters[i], source) == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static ReplayConnection *findReplayConnection(const char *source) {
+    for (int i = 0; i < connectionCount; i++) {
+        if (strcmp(connections[i].source, source) == 0) {
+            return &connections[i];
+        }
+    }
+
+    return NULL;
+}
+
+static FILE *openSessionIndex(const char *directory) {
+    char indexPath[600];
+    SessionIndexHeader indexHeader;
+
+    snprintf(indexPath, sizeof(indexPath), "%s/" SESSION_RECORDER_INDEX_FILE, directory);
+    FILE *indexFile = fopen(indexPath, "rb");
+
+    if (indexFile == NULL) {
+        perror(indexPath);
+        return NULL;
+    }
+
+    if (
+        fread(&indexHeader, sizeof(indexHeader), 1, indexFile) != 1
+        || indexHeader.magic != SESSION_RECORDER_INDEX_MAGIC
+        || indexHeader.version != SESSION_RECORDER_VERSION
+    ) {
+        fprintf(stderr, "[Replay] %s is not a version %d session index\n", indexPath, SESSION_RECORDER_VERSION);
+        fclose(indexFile);
+        return NULL;
+    }
+
+    return indexFile;
+}
+
+static bool readSessionFrame(
+    const char *directory,
+    const SessionIndexEntry *entry,
+    FILE **segmentFile,
+    uint32_t *openSegment,
+    SessionFrameHeader *header,
+    char *source,
+    char *destination,
+    unsigned char *payload
+) {
+    if (*segmentFile == NULL || *openSegment != entry->segment) {
+        char path[600];
+
+        if (*segmentFile != NULL) {
+            fclose(*segmentFile);
+        }
+
+        snprintf(path, sizeof(path), SESSION_RECORDER_SEGMENT_FORMAT, directory, entry->segment);
+        *segmentFile = fopen(path, "rb");
+        *openSegment = entry->segment;
+
+        if (*segmentFile == NULL) {
+            perror(path);
+            return false;
+        }
+    }
+
+    if (
+        fseek(*segmentFile, (long)entry->offset, SEEK_SET) != 0
+        || fread(header, sizeof(SessionFrameHeader), 1, *segmentFile) != 1
+        || header->magic != SESSION_RECORDER_MAGIC
+        || header->sourceLength >= 128
+        || header->destinationLength >= 128
+        || header->length > REPLAY_MAX_FRAME_SIZE
+        || fread(source, 1, header->sourceLength, *segmentFile) != header->sourceLength
+        || fread(destination, 1, header->destinationLength, *segmentFile) != header->destinationLength
+        || fread(payload, 1, header->length, *segmentFile) != header->length
+    ) {
+        return false;
+    }
+
+    source[header->sourceLength] = '\0';
+    destination[header->destinationLength] = '\0';
+
+    return true;
+}
+
+static void connectReplaySources(struct lws_context *context, const char *host, int port, const char *directory) {
+    FILE *segmentFile = NULL;
+    uint32_t openSegment = 0;
+    SessionIndexEntry entry;
+    SessionFrameHeader header;
+    char source[128];
+    char destination[128];
+    unsigned char *payload = malloc(REPLAY_MAX_FRAME_SIZE);
+    FILE *indexFile = openSessionIndex(directory);
+
+    while (indexFile != NULL && fread(&entry, sizeof(entry), 1, indexFile) == 1) {
+        if (
+            !readSessionFrame(directory, &entry, &segmentFile, &openSegment, &header, source, destination, payload)
+            || !isSourceSelected(source)
+            || findReplayConnection(source) != NULL
+            || connectionCount == MAX_REPLAY_CONNECTIONS
+        ) {
+            continue;
+        }
+
+        ReplayConnection *connection = &connections[connectionCount++];
+        struct lws_client_connect_info connectionInfo;
+
+        snprintf(connection->source, sizeof(connection->source), "%s", source);
+        snprintf(connection->path, sizeof(connection->path), "/?source=%s", source);
+
+        memset(&connectionInfo, 0, sizeof(connectionInfo));
+        connectionInfo.context = context;
+        connectionInfo.address = host;
+        connectionInfo.host = host;
+        connectionInfo.origin = host;
+        connectionInfo.port = port;
+        connectionInfo.path = connection->path;
+        connectionInfo.pwsi = &connection->wsi;
+
+        lws_client_connect_via_info(&connectionInfo);
+        printf("[Replay] Connecting as %s\n", source);
+    }
+
+    if (indexFile != NULL) {
+        fclose(indexFile);
+    }
+    if (segmentFile != NULL) {
+        fclose(segmentFile);
+    }
+    free(payload);
+}
+
+static bool waitForReplaySources(struct lws_context *context) {
+    const uint64_t deadline = nowNs() + REPLAY_CONNECT_TIMEOUT_NS;
+
+    while (nowNs() < deadline) {
+        bool isReady = true;
+
+        for (int i = 0; i < connectionCount; i++) {
+            isReady = isReady && connections[i].isEstablished;
+        }
+
+        if (isReady) {
+            return true;
+        }
+
+        lws_service(context, 10);
+    }
+
+    return false;
+}
+
+int main(int argc, char **argv) {
+    const char *directory = NULL;
+    const char *host = "127.0.0.1";
+    int port = 8585;
+    double speed = 1.0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc) {
+            i++;
+            speed = strcmp(argv[i], "max") == 0 ? 0.0 : atof(argv[i]);
+        } else if (strcmp(argv[i], "--host") == 0 && i + 1 < argc) {
+            host = argv[++i];
+        } else if (strcmp(argv[i], "--port") == 0 && i + 1 < argc) {
+            port = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--source") == 0 && i + 1 < argc && sourceFilterCount < MAX_REPLAY_FILTERS) {
+            sourceFilters[sourceFilterCount++] = argv[++i];
+        } else {
+            directory = argv[i];
+        }
+    }
+
+    if (directory == NULL) {
+        fprintf(stderr, "Usage: %s <session dir> [--speed 1|N|max] [--host ip] [--port 8585] [--source name]...\n", argv[0]);
+        return 1;
+    }
+
+    struct lws_context_creation_info contextCreationInfo;
+    memset(&contextCreationInfo, 0, sizeof(contextCreationInfo));
+    contextCreationInfo.port = CONTEXT_PORT_NO_LISTEN;
+    contextCreationInfo.protocols = (struct lws_protocols[]){{"websocket", callbackReplay, 0, 0}, {NULL, NULL, 0, 0}};
+
+    struct lws_context *context = lws_create_context(&contextCreationInfo);
+    if (!context) {
+        fprintf(stderr, "Failed to create WebSocket context\n");
+        return 1;
+    }
+
+    connectReplaySources(context, host, port, directory);
+
+    if (connectionCount == 0 || !waitForReplaySources(context)) {
+        fprintf(stderr, "[Replay] Failed to connect replay sources\n");
+        lws_context_destroy(context);
+        return 1;
+    }
+
+    FILE *indexFile = openSessionIndex(directory);
+    FILE *segmentFile = NULL;
+    uint32_t openSegment = 0;
+    SessionIndexEntry entry;
+    SessionFrameHeader header;
+    char source[128];
+    char destination[128];
+    unsigned char *frame = malloc(LWS_PRE + REPLAY_MAX_FRAME_SIZE);
+    uint64_t firstRecordedAtNs = 0;
+    uint64_t maxLatenessNs = 0;
+    unsigned long sentFrames = 0;
+    unsigned long sentBytes = 0;
+    unsigned long droppedFrames = 0;
+    const uint64_t startedAtNs = nowNs();
+
+    while (indexFile != NULL && fread(&entry, sizeof(entry), 1, indexFile) == 1) {
+        if (!readSessionFrame(directory, &entry, &segmentFile, &openSegment, &header, source, destination, frame + LWS_PRE)) {
+            continue;
+        }
+
+        ReplayConnection *connection = findReplayConnection(source);
+        if (connection == NULL || !connection->isEstablished) {
+            continue;
+        }
+
+        if (firstRecordedAtNs == 0) {
+            firstRecordedAtNs = header.receivedAtNs;
+        }
+
+        if (speed > 0.0) {
+            const uint64_t dueAtNs = startedAtNs + (uint64_t)((double)(header.receivedAtNs - firstRecordedAtNs) / speed);
+            uint64_t now;
+
+            while ((now = nowNs()) < dueAtNs) {
+                lws_service(context, 0);
+                if (dueAtNs - now > 200000) {
+                    usleep(100);
+                }
+            }
+
+            if (now - dueAtNs > maxLatenessNs) {
+                maxLatenessNs = now - dueAtNs;
+            }
+        }
+
+        while (connection->wsi != NULL && lws_send_pipe_choked(connection->wsi)) {
+            lws_service(context, 1);
+        }
+
+        if (connection->wsi == NULL) {
+            continue;
+        }
+
+        lws_write(connection->wsi, frame + LWS_PRE, header.length, LWS_WRITE_TEXT);
+        lws_service(context, 0);
+        sentFrames++;
+        sentBytes += header.length;
+        if (header.flags & SESSION_FRAME_DROPPED) {
+            droppedFrames++;
+        }
+    }
+
+    const double elapsedSeconds = (double)(nowNs() - startedAtNs) / 1e9;
+
+    printf(
+        "{\"frames\":%lu,\"bytes\":%lu,\"recordedDrops\":%lu,\"elapsedSeconds\":%.3f,\"framesPerSecond\":%.1f,\"maxLatenessUs\":%.1f}\n",
+        sentFrames,
+        sentBytes,
+        droppedFrames,
+        elapsedSeconds,
+        elapsedSeconds > 0 ? sentFrames / elapsedSeconds : 0.0,
+        maxLatenessNs / 1000.0
+    );
+
+    if (indexFile != NULL) {
+        fclose(indexFile);
+    }
+    if (segmentFile != NULL) {
+        fclose(segmentFile);
+    }
+    free(frame);
+    lws_context_destroy(context);
+
+    return 0;
+}
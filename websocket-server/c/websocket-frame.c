@@ -0,0 +1,136 @@
+#include <string.h>
+#include "websocket-frame.h"
+
+static size_t getHeaderLength(const unsigned char *header) {
+    const unsigned char lengthCode = header[1] & 0x7f;
+    const size_t maskLength = (header[1] & 0x80) ? 4 : 0;
+
+    if (lengthCode == 126) {
+        return 4 + maskLength;
+    }
+    if (lengthCode == 127) {
+        return 10 + maskLength;
+    }
+
+    return 2 + maskLength;
+}
+
+static void parseFrameHeader(WebSocketFrameDecoder *decoder) {
+    const unsigned char *header = decoder->header;
+    const unsigned char lengthCode = header[1] & 0x7f;
+    size_t maskOffset = 2;
+
+    decoder->isFinal = (header[0] & 0x80) != 0;
+    decoder->opcode = header[0] & 0x0f;
+    decoder->isMasked = (header[1] & 0x80) != 0;
+    decoder->payloadLength = lengthCode;
+    decoder->payloadOffset = 0;
+
+    if (lengthCode == 126) {
+        decoder->payloadLength = ((uint64_t)header[2] << 8) | header[3];
+        maskOffset = 4;
+    } else if (lengthCode == 127) {
+        decoder->payloadLength = 0;
+        for (int i = 0; i < 8; i++) {
+            decoder->payloadLength = (decoder->payloadLength << 8) | header[2 + i];
+        }
+        maskOffset = 10;
+    }
+
+    if (decoder->isMasked) {
+        memcpy(decoder->mask, header + maskOffset, 4);
+    }
+}
+
+void resetWebSocketFrameDecoder(WebSocketFrameDecoder *decoder) {
+    memset(decoder, 0, sizeof(WebSocketFrameDecoder));
+}
+
+int decodeWebSocketFrames(
+    WebSocketFrameDecoder *decoder,
+    const unsigned char *data,
+    size_t length,
+    WebSocketFrameHandler handler,
+    void *context
+) {
+    unsigned char chunk[WEBSOCKET_FRAME_CHUNK_SIZE];
+    size_t offset = 0;
+
+    while (offset < length) {
+        if (decoder->headerLength < 2 || decoder->headerLength < getHeaderLength(decoder->header)) {
+            decoder->header[decoder->headerLength++] = data[offset++];
+
+            if (decoder->headerLength >= 2 && decoder->headerLength == getHeaderLength(decoder->header)) {
+                parseFrameHeader(decoder);
+
+                if (!decoder->isMasked || (decoder->header[0] & 0x70) != 0) {
+                    return -1;
+                }
+
+                if ((decoder->opcode & 0x8) && (!decoder->isFinal || decoder->payloadLength > WEBSOCKET_CONTROL_MAX_PAYLOAD)) {
+                    return -1;
+                }
+
+                if (decoder->payloadLength == 0) {
+                    if (handler(context, decoder->opcode, chunk, 0, true, decoder->isFinal, 0) < 0) {
+                        return -1;
+                    }
+                    decoder->headerLength = 0;
+                }
+            }
+            continue;
+        }
+
+        const uint64_t remainingInFrame = decoder->payloadLength - decoder->payloadOffset;
+        size_t count = length - offset;
+
+        if (count > remainingInFrame) {
+            count = (size_t)remainingInFrame;
+        }
+        if (count > sizeof(chunk)) {
+            count = sizeof(chunk);
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            chunk[i] = data[offset + i] ^ decoder->mask[(decoder->payloadOffset + i) % 4];
+        }
+
+        const bool isFirst = decoder->payloadOffset == 0;
+        decoder->payloadOffset += count;
+        offset += count;
+
+        const size_t remaining = (size_t)(decoder->payloadLength - decoder->payloadOffset);
+        if (handler(context, decoder->opcode, chunk, count, isFirst, decoder->isFinal, remaining) < 0) {
+            return -1;
+        }
+
+        if (remaining == 0) {
+            decoder->headerLength = 0;
+        }
+    }
+
+    return 0;
+}
+
+size_t encodeWebSocketFrameHeader(unsigned char *header, int opcode, size_t length) {
+    header[0] = (unsigned char)(0x80 | (opcode & 0x0f));
+
+    if (length < 126) {
+        header[1] = (unsigned char)length;
+        return 2;
+    }
+
+    if (length <= 0xffff) {
+        header[1] = 126;
+        header[2] = (unsigned char)(length >> 8);
+        header[3] = (unsigned char)length;
+        return 4;
+    }
+
+    header[1] = 127;
+    for (int i = 0; i < 8; i++) {
+        header[2 + i] = (unsigned char)((uint64_t)length >> (56 - 8 * i));
+    }
+
+    return 10;
+}
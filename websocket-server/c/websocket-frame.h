@@ -0,0 +1,49 @@
+#ifndef WEBSOCKET_FRAME_H
+#define WEBSOCKET_FRAME_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define WEBSOCKET_FRAME_MAX_HEADER 14
+#define WEBSOCKET_FRAME_SERVER_HEADER 10
+#define WEBSOCKET_FRAME_CHUNK_SIZE 4096
+#define WEBSOCKET_CONTROL_MAX_PAYLOAD 125
+#define WEBSOCKET_OPCODE_CONTINUATION 0x0
+#define WEBSOCKET_OPCODE_TEXT 0x1
+#define WEBSOCKET_OPCODE_BINARY 0x2
+#define WEBSOCKET_OPCODE_CLOSE 0x8
+#define WEBSOCKET_OPCODE_PING 0x9
+#define WEBSOCKET_OPCODE_PONG 0xa
+
+typedef struct {
+    unsigned char header[WEBSOCKET_FRAME_MAX_HEADER];
+    size_t headerLength;
+    int opcode;
+    bool isFinal;
+    bool isMasked;
+    unsigned char mask[4];
+    uint64_t payloadLength;
+    uint64_t payloadOffset;
+} WebSocketFrameDecoder;
+
+typedef int (*WebSocketFrameHandler)(
+    void *context,
+    int opcode,
+    const unsigned char *payload,
+    size_t length,
+    bool isFirst,
+    bool isFinal,
+    size_t remaining
+);
+
+void resetWebSocketFrameDecoder(WebSocketFrameDecoder *decoder);
+int decodeWebSocketFrames(
+    WebSocketFrameDecoder *decoder,
+    const unsigned char *data,
+    size_t length,
+    WebSocketFrameHandler handler,
+    void *context
+);
+size_t encodeWebSocketFrameHeader(unsigned char *header, int opcode, size_t length);
+#endif